@@ -8,32 +8,10 @@
 #include "stock_tracker.h"
 #include <math.h>
 
-
 // Analyze individual stock performance and set status
 void analyze_stock_performance(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        strcpy(stock->status, "❌ INVALID");
-        return;
-    }
-    
-    double change = stock->change_percent;
-    
-    // Categorize based on performance thresholds
-    if (change >= STRONG_BUY_THRESHOLD) {
-        strcpy(stock->status, "🚀 STRONG BUY");
-    } else if (change >= BUY_THRESHOLD) {
-        strcpy(stock->status, "📈 BULLISH");
-    } else if (change > 0) {
-        strcpy(stock->status, "🟢 POSITIVE");
-    } else if (change == 0) {
-        strcpy(stock->status, "⚪ NEUTRAL");
-    } else if (change > SELL_THRESHOLD) {
-        strcpy(stock->status, "🟡 WATCH");
-    } else if (change > STRONG_SELL_THRESHOLD) {
-        strcpy(stock->status, "📉 BEARISH");
-    } else {
-        strcpy(stock->status, "🔴 AVOID");
-    }
+    if (!stock) return;
+    stock->status = (unsigned char)classify_stock_status(stock->current_price, stock->change_percent);
 }
 
 // Find the best performing stock
@@ -110,54 +88,22 @@ double calculate_total_value(Stock stocks[], int count) {
     return total;
 }
 
-// Sort stocks by performance (bubble sort for simplicity)
+// Sort stocks by performance: rank an index array, then move each row once
 void sort_stocks_by_performance(Stock stocks[], int count) {
     if (!stocks || count <= 1) {
         return;
     }
     
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            if (stocks[j].change_percent < stocks[j + 1].change_percent) {
-                // Swap stocks
-                Stock temp = stocks[j];
-                stocks[j] = stocks[j + 1];
-                stocks[j + 1] = temp;
-            }
+    int* order = malloc(count * sizeof(int));
+    Stock* sorted = malloc(count * sizeof(Stock));
+    if (order && sorted && rank_order(stocks, count, RANK_BY_CHANGE, order) == count) {
+        for (int i = 0; i < count; i++) {
+            sorted[i] = stocks[order[i]];
         }
+        memcpy(stocks, sorted, count * sizeof(Stock));
     }
-}
-
-// Generate detailed recommendation
-const char* generate_recommendation(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        return "INVALID DATA";
-    }
-    
-    double change = stock->change_percent;
-    // double price = stock->current_price;
-    double volume = stock->volume;
-    
-    // Multi-factor analysis
-    static char recommendation[200];
-    
-    if (change >= 3.0 && volume > 1000000) {
-        strcpy(recommendation, "STRONG BUY - High momentum with strong volume");
-    } else if (change >= 1.0 && volume > 500000) {
-        strcpy(recommendation, "BUY - Positive trend with good volume");
-    } else if (change >= 0.5) {
-        strcpy(recommendation, "HOLD - Slight upward movement");
-    } else if (change >= -0.5) {
-        strcpy(recommendation, "HOLD - Minimal movement, watch closely");
-    } else if (change >= -2.0) {
-        strcpy(recommendation, "WATCH - Declining, consider exit strategy");
-    } else if (change >= -5.0) {
-        strcpy(recommendation, "SELL - Significant decline, limit losses");
-    } else {
-        strcpy(recommendation, "STRONG SELL - Major decline, exit immediately");
-    }
-    
-    return recommendation;
+    free(order);
+    free(sorted);
 }
 
 // Calculate moving average (simplified)
@@ -174,11 +120,17 @@ double calculate_simple_moving_average(double prices[], int count, int period) {
     return sum / period;
 }
 
-// Calculate relative strength index (RSI) - simplified version
+// Relative strength index: Wilder RSI from the indicator engine once it has
+// enough ticks, otherwise a rough estimate from today's change
 double calculate_rsi(Stock* stock) {
     if (!stock || stock->current_price <= 0) {
         return 50.0;  // Neutral RSI
     }
+
+    const IndicatorValues* values = indicators_lookup(stock->symbol);
+    if (values && !isnan(values->rsi)) {
+        return values->rsi;
+    }
     
     // Simplified RSI calculation based on current change
     double change = stock->change_percent;
@@ -190,31 +142,6 @@ double calculate_rsi(Stock* stock) {
     }
 }
 
-// Detect price patterns (simplified)
-const char* detect_price_pattern(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        return "UNKNOWN";
-    }
-    
-    double current = stock->current_price;
-    double high = stock->day_high;
-    double low = stock->day_low;
-    double change = stock->change_percent;
-    
-    // Simple pattern detection
-    if (change > 2.0 && current > (high + low) / 2) {
-        return "BULLISH BREAKOUT";
-    } else if (change < -2.0 && current < (high + low) / 2) {
-        return "BEARISH BREAKDOWN";
-    } else if (fabs(change) < 0.5) {
-        return "SIDEWAYS TREND";
-    } else if (change > 0) {
-        return "UPWARD TREND";
-    } else {
-        return "DOWNWARD TREND";
-    }
-}
-
 // Calculate support and resistance levels
 void calculate_support_resistance(Stock* stock, double* support, double* resistance) {
     if (!stock || !support || !resistance) {
@@ -236,9 +163,9 @@ const char* analyze_market_sentiment(Stock stocks[], int count) {
     
     for (int i = 0; i < count; i++) {
         if (stocks[i].current_price > 0) {
-            if (stocks[i].change_percent > 1.0) {
+            if (stocks[i].change_percent > SENTIMENT_THRESHOLD) {
                 bullish++;
-            } else if (stocks[i].change_percent < -1.0) {
+            } else if (stocks[i].change_percent < -SENTIMENT_THRESHOLD) {
                 bearish++;
             } else {
                 neutral++;
@@ -255,23 +182,6 @@ const char* analyze_market_sentiment(Stock stocks[], int count) {
     }
 }
 
-// Risk assessment
-const char* assess_risk_level(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        return "UNKNOWN";
-    }
-    
-    double abs_change = fabs(stock->change_percent);
-    
-    if (abs_change >= 5.0) {
-        return "🔴 HIGH RISK";
-    } else if (abs_change >= 2.0) {
-        return "🟡 MEDIUM RISK";
-    } else {
-        return "🟢 LOW RISK";
-    }
-}
-
 // Portfolio diversification analysis
 double calculate_portfolio_diversity(Stock stocks[], int count) {
     if (!stocks || count <= 0) {
@@ -339,17 +249,16 @@ double calculate_average_change(Stock stocks[], int count) {
     return (valid_stocks > 0) ? total_change / valid_stocks : 0.0;
 }
 
-// Generate market summary
+// Generate market summary (one pass, see summary.c)
 void generate_market_summary(Stock stocks[], int count, char* summary, size_t size) {
     if (!stocks || !summary || count <= 0) {
         return;
     }
     
-    int bullish_count = count_bullish_stocks(stocks, count);
-    double avg_change = calculate_average_change(stocks, count);
-    Stock* best_stock = find_best_performing_stock(stocks, count);
-    Stock* most_volatile = find_most_volatile_stock(stocks, count);
-    const char* sentiment = analyze_market_sentiment(stocks, count);
+    MarketSummary market;
+    market_summary_compute(stocks, count, &market);
+    Stock* best_stock = market.best >= 0 ? &stocks[market.best] : NULL;
+    Stock* most_volatile = market.most_volatile >= 0 ? &stocks[market.most_volatile] : NULL;
     
     snprintf(summary, size,
         "📊 MARKET SUMMARY\n"
@@ -359,12 +268,12 @@ void generate_market_summary(Stock stocks[], int count, char* summary, size_t si
         "• Market Sentiment: %s\n"
         "• Best Performer: %s (%.2f%%)\n"
         "• Most Volatile: %s (%.2f%%)\n",
-        bullish_count, count, (bullish_count * 100.0) / count,
-        avg_change,
-        sentiment,
+        market.positive, count, (market.positive * 100.0) / count,
+        market.average_change,
+        market.sentiment,
         best_stock ? best_stock->symbol : "N/A",
         best_stock ? best_stock->change_percent : 0.0,
         most_volatile ? most_volatile->symbol : "N/A",
         most_volatile ? most_volatile->change_percent : 0.0
     );
-}
\ No newline at end of file
+}
@@ -0,0 +1,21 @@
+/*
+ * Smart Stock Tracker - Benchmark Fixtures
+ * Helpers shared by the programs in bench/.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "../stock_tracker.h"
+
+/**
+ * Synthetic symbol for row i: "S" and seven digits, distinct for the first
+ * ten million rows and always a valid registry key
+ * @param i: Row number
+ * @param buf: Destination of at least SYMBOL_KEY_LENGTH + 1 bytes, e.g. Stock.symbol
+ */
+static inline void bench_symbol(int i, char buf[SYMBOL_KEY_LENGTH + 1]) {
+    snprintf(buf, SYMBOL_KEY_LENGTH + 1, "S%07u", (unsigned int)i % 10000000u);
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Smart Stock Tracker - Batch Fetch Test
+ * Runs fetch_stocks_selected() against a stub quote server on localhost
+ * and checks every entry's HTTP code and quote, including 429/5xx answers
+ * and dropped connections, and that the handle pool is reusable after a
+ * batch with failures.
+ *
+ * The fetcher is built with BASE_URL pointing at the stub (see the
+ * fetch-test make target). Symbols pick the stub's answer:
+ *   R... -> 429, S... -> 503, X... -> connection closed, anything else -> quote
+ *
+ * Usage: fetch_test [symbols] [concurrency]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../stock_tracker.h"
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef FETCH_TEST_PORT
+#define FETCH_TEST_PORT 8091
+#endif
+
+// ============================================================================
+// Stub quote server
+// ============================================================================
+static int listen_fd = -1;
+
+// Price the stub quotes for a symbol: 100 plus its digits
+static double stub_price(const char *symbol) {
+    return 100.0 + atoi(symbol + 1);
+}
+
+static int send_all(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, 0);
+        if (n <= 0) return 0;
+        data += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+// Answer one request; returns 0 when the connection should close
+static int answer(int fd, const char *request) {
+    char symbol[16] = "";
+    const char *param = strstr(request, "symbol=");
+    if (param) sscanf(param + 7, "%15[A-Za-z0-9.]", symbol);
+
+    char body[256], response[512];
+    int status = 200;
+    if (symbol[0] == 'X') return 0;
+    if (symbol[0] == 'R') status = 429;
+    if (symbol[0] == 'S') status = 503;
+
+    if (status == 200) {
+        double price = stub_price(symbol);
+        snprintf(body, sizeof(body),
+                 "{\"c\":%.2f,\"d\":1.00,\"dp\":1.0000,\"h\":%.2f,\"l\":%.2f,"
+                 "\"o\":%.2f,\"pc\":%.2f,\"t\":1727200800}",
+                 price, price + 1, price - 1, price, price - 1);
+    } else {
+        snprintf(body, sizeof(body), "{\"error\":\"stub %d\"}", status);
+    }
+    int size = snprintf(response, sizeof(response),
+                        "HTTP/1.1 %d Stub\r\nContent-Type: application/json\r\n"
+                        "Content-Length: %zu\r\n\r\n%s",
+                        status, strlen(body), body);
+    return size > 0 && (size_t)size < sizeof(response) && send_all(fd, response, (size_t)size);
+}
+
+// Keep-alive: serve requests until the client hangs up
+static void *serve_connection(void *arg) {
+    int fd = (int)(intptr_t)arg;
+    char buffer[4096];
+    size_t used = 0;
+
+    for (;;) {
+        ssize_t n = recv(fd, buffer + used, sizeof(buffer) - 1 - used, 0);
+        if (n <= 0) break;
+        used += (size_t)n;
+        buffer[used] = '\0';
+
+        char *end;
+        int open = 1;
+        while (open && (end = strstr(buffer, "\r\n\r\n"))) {
+            *end = '\0';
+            open = answer(fd, buffer);
+            size_t consumed = (size_t)(end + 4 - buffer);
+            memmove(buffer, end + 4, used - consumed + 1);
+            used -= consumed;
+        }
+        if (!open || used == sizeof(buffer) - 1) break;
+    }
+    close(fd);
+    return NULL;
+}
+
+static void *accept_loop(void *arg) {
+    (void)arg;
+    for (;;) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) break;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, serve_connection, (void *)(intptr_t)fd) != 0) {
+            close(fd);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+static int start_stub(void) {
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) return 0;
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(FETCH_TEST_PORT);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listen_fd, 64) != 0) {
+        perror("stub server");
+        return 0;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, accept_loop, NULL) != 0) return 0;
+    pthread_detach(thread);
+    return 1;
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+static long expected_code(const char *symbol) {
+    switch (symbol[0]) {
+    case 'R': return 429;
+    case 'S': return 503;
+    case 'X': return 0;
+    default:  return 200;
+    }
+}
+
+// Fetch indices[] (NULL = all) and check every entry; returns 1 if all match
+static int run_batch(const char *label, const char *symbols[], int count, const int indices[], int n) {
+    Stock *stocks = calloc(count, sizeof(Stock));
+    long *codes = malloc(n * sizeof(long));
+    if (!stocks || !codes) return 0;
+    for (int j = 0; j < n; j++) codes[j] = -1;
+
+    int fetched = fetch_stocks_selected(symbols, stocks, indices, n, codes);
+
+    int expected = 0, ok = 1;
+    for (int j = 0; j < n; j++) {
+        int i = indices ? indices[j] : j;
+        long want = expected_code(symbols[i]);
+        if (want == 200) expected++;
+        if (codes[j] != want) {
+            fprintf(stderr, "%s: %s got HTTP %ld, want %ld\n", label, symbols[i], codes[j], want);
+            ok = 0;
+        }
+        if (want == 200 && (strcmp(stocks[i].symbol, symbols[i]) != 0 ||
+                            stocks[i].current_price != stub_price(symbols[i]))) {
+            fprintf(stderr, "%s: %s parsed as %s %.2f\n", label, symbols[i],
+                    stocks[i].symbol, stocks[i].current_price);
+            ok = 0;
+        }
+    }
+    if (fetched != expected) {
+        fprintf(stderr, "%s: fetched %d, want %d\n", label, fetched, expected);
+        ok = 0;
+    }
+    printf("%-28s %4d requests  %4d quotes  %s\n", label, n, fetched, ok ? "ok" : "FAILED");
+
+    free(codes);
+    free(stocks);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 64;
+    int concurrency = argc > 2 ? atoi(argv[2]) : 8;
+    if (count < 8) count = 8;
+
+    if (!start_stub()) return 1;
+    if (!initialize_curl()) {
+        fprintf(stderr, "curl initialization failed\n");
+        return 1;
+    }
+    set_fetch_concurrency(concurrency);
+
+    // Quotes for every symbol, then a mix of failures every few symbols
+    char (*names)[16] = malloc(count * sizeof(*names));
+    const char **quotes = malloc(count * sizeof(char *));
+    const char **mixed = malloc(count * sizeof(char *));
+    int *indices = malloc(count * sizeof(int));
+    if (!names || !quotes || !mixed || !indices) return 1;
+
+    static const char failures[] = "RSX";
+    for (int i = 0; i < count; i++) {
+        snprintf(names[i], sizeof(names[i]), "Q%04d", i % 10000);
+        quotes[i] = names[i];
+    }
+    char (*failing)[16] = malloc(count * sizeof(*failing));
+    if (!failing) return 1;
+    for (int i = 0; i < count; i++) {
+        memcpy(failing[i], names[i], sizeof(failing[i]));
+        if (i % 5 == 4) failing[i][0] = failures[(i / 5) % 3];
+        mixed[i] = failing[i];
+    }
+
+    // Every other symbol, in reverse, so positions and indices differ
+    int n = 0;
+    for (int i = count - 1; i >= 0; i -= 2) indices[n++] = i;
+
+    int ok = run_batch("all quotes", quotes, count, NULL, count);
+    ok = run_batch("429/503/dropped mix", mixed, count, NULL, count) && ok;
+    ok = run_batch("mix, selected indices", mixed, count, indices, n) && ok;
+    ok = run_batch("all quotes after failures", quotes, count, NULL, count) && ok;
+
+    cleanup_curl();
+    close(listen_fd);
+    free(failing);
+    free(indices);
+    free(mixed);
+    free(quotes);
+    free(names);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+/*
+ * Smart Stock Tracker - Indicator Engine Benchmark
+ * Feeds one new tick per symbol per round through indicators_update_all()
+ * and reports the cost of a full refresh.
+ *
+ * Usage: indicator_bench [symbols] [rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 200;
+    if (count < 1) count = 1;
+    if (rounds < 1) rounds = 1;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    IndicatorConfig config;
+    indicators_config_defaults(&config);
+    if (!stocks || !indicators_init(&config, count)) return 1;
+
+    srand(11);
+    for (int i = 0; i < count; i++) {
+        bench_symbol(i, stocks[i].symbol);
+        stocks[i].current_price = 100.0 + rand() % 100;
+        stocks[i].previous_close = stocks[i].current_price;
+    }
+
+    double elapsed = 0;
+    for (int r = 0; r < rounds; r++) {
+        // New quotes (not timed): small random walk, cumulative volume
+        for (int i = 0; i < count; i++) {
+            Stock *s = &stocks[i];
+            s->current_price *= 1.0 + ((rand() % 201) - 100) / 100000.0;
+            s->day_high = s->current_price > s->day_high ? s->current_price : s->day_high;
+            s->day_low = (s->day_low == 0 || s->current_price < s->day_low) ? s->current_price : s->day_low;
+            s->volume += rand() % 1000;
+            s->last_update = 1700000000 + r * 5;
+        }
+
+        double start = now_seconds();
+        indicators_update_all(stocks, count);
+        elapsed += now_seconds() - start;
+    }
+
+    printf("%d symbols  %8.1f us/refresh  %6.1f ns/update\n",
+           count, elapsed / rounds * 1e6, elapsed / rounds / count * 1e9);
+
+    indicators_free();
+    free(stocks);
+    return 0;
+}
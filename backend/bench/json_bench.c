@@ -0,0 +1,67 @@
+/*
+ * Smart Stock Tracker - JSON Serializer Benchmark
+ * Serializes synthetic Stock arrays with the streaming writer; reports
+ * documents/second and MB/s for the pretty /stocks document and the
+ * compact /stream payload.
+ *
+ * Usage: json_bench [seconds-per-case]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_stocks(Stock *stocks, int count) {
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        memset(&stocks[i], 0, sizeof(Stock));
+        bench_symbol(i, stocks[i].symbol);
+        stocks[i].current_price = (rand() % 500000 + 100) / 100.0;           // cents, like quotes
+        stocks[i].change_percent = (rand() % 200001 - 100000) / 10000.0;
+    }
+}
+
+static void run_case(const char *name, Stock *stocks, int count, double seconds, int compact) {
+    long docs = 0;
+    size_t bytes = 0;
+    double start = now_seconds(), elapsed;
+
+    do {
+        char *text = compact ? build_stream_json(stocks, count, NULL, NULL)
+                             : build_all_stocks_json(stocks, count, NULL);
+        if (!text) {
+            fprintf(stderr, "serialization failed\n");
+            exit(1);
+        }
+        bytes += strlen(text);
+        free(text);
+        docs++;
+        elapsed = now_seconds() - start;
+    } while (elapsed < seconds);
+
+    printf("%-8s %7d stocks %12.0f docs/s %10.1f MB/s\n",
+           name, count, docs / elapsed, bytes / elapsed / 1e6);
+}
+
+int main(int argc, char *argv[]) {
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    static const int sizes[] = { 10, 1000, 100000 };
+
+    Stock *stocks = malloc(sizeof(Stock) * sizes[2]);
+    if (!stocks) return 1;
+    fill_stocks(stocks, sizes[2]);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        run_case("pretty", stocks, sizes[i], seconds, 0);
+        run_case("compact", stocks, sizes[i], seconds, 1);
+    }
+
+    free(stocks);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Smart Stock Tracker - Analytics Kernel Benchmark
+ * Times the analyzer.c Stock[] functions against the MarketState column
+ * scans with every kernel set the CPU supports, and checks they agree.
+ *
+ * Usage: kernel_bench [symbols...]   (default: 1000 100000 1000000)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <math.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    int bullish;
+    double average;
+    int volatile_, volume;
+    const char *sentiment;
+    double diversity;
+} Stats;
+
+// The functions named in analyzer.c, one loop each
+static Stats scan_rows(Stock *stocks, int count) {
+    Stats s;
+    s.bullish = count_bullish_stocks(stocks, count);
+    s.average = calculate_average_change(stocks, count);
+    Stock *vol = find_most_volatile_stock(stocks, count);
+    Stock *unusual = find_unusual_volume_stock(stocks, count);
+    s.volatile_ = vol ? (int)(vol - stocks) : -1;
+    s.volume = unusual ? (int)(unusual - stocks) : -1;
+    s.sentiment = analyze_market_sentiment(stocks, count);
+    s.diversity = calculate_portfolio_diversity(stocks, count);
+    return s;
+}
+
+static Stats scan_columns(const MarketState *state) {
+    Stats s;
+    s.bullish = market_count_bullish(state);
+    s.average = market_average_change(state);
+    s.volatile_ = market_find_most_volatile(state);
+    s.volume = market_find_highest_volume(state);
+    s.sentiment = market_sentiment(state);
+    s.diversity = market_portfolio_diversity(state);
+    return s;
+}
+
+static int same_stats(const Stats *a, const Stats *b) {
+    // Lane-wise sums reassociate the additions; allow rounding differences
+    return a->bullish == b->bullish && a->volatile_ == b->volatile_ && a->volume == b->volume &&
+           fabs(a->average - b->average) <= 1e-9 * (1.0 + fabs(a->average)) &&
+           strcmp(a->sentiment, b->sentiment) == 0 && a->diversity == b->diversity;
+}
+
+static void run(int count) {
+    Stock *stocks = calloc(count, sizeof(Stock));
+    MarketState state;
+    if (!stocks || !market_state_init(&state, count)) {
+        free(stocks);
+        return;
+    }
+
+    srand(17);
+    for (int i = 0; i < count; i++) {
+        Stock *s = &stocks[i];
+        bench_symbol(i, s->symbol);
+        s->current_price = (i % 97 == 0) ? 0.0 : 10.0 + rand() % 500;
+        s->change_percent = ((rand() % 2001) - 1000) / 100.0;
+        s->volume = rand() % 10000000;
+    }
+    market_state_from_stocks(&state, stocks, count);
+
+    // Roughly the same number of rows scanned at every size
+    int rounds = 20000000 / count;
+    if (rounds < 5) rounds = 5;
+
+    Stats reference = scan_rows(stocks, count);
+    double start = now_seconds();
+    for (int r = 0; r < rounds; r++) reference = scan_rows(stocks, count);
+    double row_time = (now_seconds() - start) / rounds;
+    printf("%8d symbols  Stock[]      %9.1f us/pass\n", count, row_time * 1e6);
+
+    static const char *sets[] = { "scalar", "sse2", "avx2" };
+    for (size_t k = 0; k < sizeof(sets) / sizeof(sets[0]); k++) {
+        if (!market_kernels_select(sets[k])) continue;
+
+        Stats got = scan_columns(&state);
+        start = now_seconds();
+        for (int r = 0; r < rounds; r++) got = scan_columns(&state);
+        double column_time = (now_seconds() - start) / rounds;
+
+        printf("%8d symbols  %-12s %9.1f us/pass  %5.1fx  %s\n", count, sets[k],
+               column_time * 1e6, row_time / column_time,
+               same_stats(&reference, &got) ? "match" : "MISMATCH");
+    }
+    market_kernels_select(NULL);
+
+    market_state_free(&state);
+    free(stocks);
+}
+
+int main(int argc, char *argv[]) {
+    printf("Kernel set chosen at runtime: %s\n", market_kernels_name());
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) run(atoi(argv[i]) > 0 ? atoi(argv[i]) : 1);
+    } else {
+        run(1000);
+        run(100000);
+        run(1000000);
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Smart Stock Tracker - Live Leaderboard Benchmark
+ * Streams random ticks into the skip-list leaderboard and times each
+ * update, a top-K read and a rank-of-symbol lookup against recomputing
+ * the top K from scratch with rank_top_k; checks both agree.
+ *
+ * Usage: leaderboard_bench [symbols] [ticks] [k]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void random_tick(Stock *s) {
+    s->current_price = (rand() % 50 == 0) ? 0.0 : 10.0 + rand() % 500;
+    s->change_percent = ((rand() % 2001) - 1000) / 100.0;
+    s->volume = rand() % 10000000;
+    s->last_update++;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 200000;
+    int k = argc > 3 ? atoi(argv[3]) : 20;
+    if (count < 1) count = 1;
+    if (ticks < 1) ticks = 1;
+    if (k < 1) k = 1;
+    if (k > LEADERBOARD_MAX_K) k = LEADERBOARD_MAX_K;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    int *rows = malloc(k * sizeof(int));
+    LeaderboardView *view = malloc(sizeof(LeaderboardView));
+    if (!stocks || !rows || !view || !leaderboard_init(count)) return 1;
+
+    srand(20);
+    double start = now_seconds();
+    for (int i = 0; i < count; i++) {
+        bench_symbol(i, stocks[i].symbol);
+        random_tick(&stocks[i]);
+        leaderboard_update(i, &stocks[i], NULL);
+    }
+    double load_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (int t = 0; t < ticks; t++) {
+        int i = rand() % count;
+        random_tick(&stocks[i]);
+        leaderboard_update(i, &stocks[i], NULL);
+    }
+    double update_time = (now_seconds() - start) / ticks;
+
+    int rounds = 1000;
+    start = now_seconds();
+    for (int r = 0; r < rounds; r++) leaderboard_top_k(k, view);
+    double top_time = (now_seconds() - start) / rounds;
+
+    start = now_seconds();
+    int rank_total = 0;
+    for (int r = 0; r < rounds; r++)
+        rank_total += leaderboard_rank(stocks[(r * 7919) % count].symbol) > 0;
+    double rank_time = (now_seconds() - start) / rounds;
+
+    int scan_rounds = 20, n = 0;
+    start = now_seconds();
+    for (int r = 0; r < scan_rounds; r++) n = rank_top_k(stocks, count, RANK_BY_CHANGE, k, rows);
+    double scan_time = (now_seconds() - start) / scan_rounds;
+
+    // Same rows in the same order, and ranks agree with positions
+    int match = n == view->count;
+    for (int i = 0; i < n && match; i++) {
+        match = strcmp(stocks[rows[i]].symbol, view->stocks[i].symbol) == 0 &&
+                leaderboard_rank(view->stocks[i].symbol) == i + 1;
+    }
+    leaderboard_bottom_k(1, view);
+    int valid = 0;
+    for (int i = 0; i < count; i++) valid += stocks[i].current_price > 0;
+    match = match && leaderboard_count() == valid &&
+            (valid == 0 || leaderboard_rank(view->stocks[0].symbol) == valid);
+
+    printf("%d symbols  load %.1f ms  update %.3f us/tick  top-%d %.3f us  "
+           "rank %.3f us (%d ranked)  rescan top-%d %.3f ms  %s\n",
+           count, load_time * 1e3, update_time * 1e6, k, top_time * 1e6,
+           rank_time * 1e6, rank_total, k, scan_time * 1e3, match ? "match" : "MISMATCH");
+
+    leaderboard_free();
+    free(stocks);
+    free(rows);
+    free(view);
+    return match ? 0 : 1;
+}
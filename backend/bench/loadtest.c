@@ -0,0 +1,192 @@
+/*
+ * Smart Stock Tracker - HTTP Load Test
+ * Keep-alive GET load against one endpoint; reports requests/second and
+ * latency percentiles.
+ *
+ * Usage: loadtest <host> <port> <path> [connections] [seconds] [header]
+ * Example: ./bench/loadtest 127.0.0.1 8080 /stocks 64 10 "Accept-Encoding: gzip"
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    pthread_t thread;
+    double *latencies;       // milliseconds
+    size_t count;
+    size_t capacity;
+    unsigned long errors;
+} Worker;
+
+static const char *host, *port, *path, *extra_header;
+static double deadline;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int open_connection(void) {
+    struct addrinfo hints = {0}, *res;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, port, &hints, &res) != 0) return -1;
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+// Send one request and read the full response; returns 0 on success
+static int round_trip(int fd, const char *request, size_t request_len) {
+    static __thread char buf[1 << 16];
+
+    if (write(fd, request, request_len) != (ssize_t)request_len) return -1;
+
+    size_t have = 0;
+    char *body = NULL;
+    while (!body) {
+        ssize_t n = read(fd, buf + have, sizeof(buf) - 1 - have);
+        if (n <= 0) return -1;
+        have += n;
+        buf[have] = '\0';
+        body = strstr(buf, "\r\n\r\n");
+        if (!body && have >= sizeof(buf) - 1) return -1;
+    }
+    body += 4;
+
+    // Count 2xx and 304 as successes
+    if (strncmp(buf, "HTTP/1.", 7) != 0 || (buf[9] != '2' && strncmp(buf + 9, "304", 3) != 0))
+        return -1;
+
+    long length = 0;
+    for (char *line = strstr(buf, "\r\n"); line && line < body; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) {
+            length = strtol(line + 17, NULL, 10);
+            break;
+        }
+    }
+
+    long remaining = length - (long)(have - (body - buf));
+    while (remaining > 0) {
+        ssize_t n = read(fd, buf, remaining < (long)sizeof(buf) ? (size_t)remaining : sizeof(buf));
+        if (n <= 0) return -1;
+        remaining -= n;
+    }
+    return 0;
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    char request[1024];
+    int len = snprintf(request, sizeof(request),
+                       "GET %s HTTP/1.1\r\nHost: %s\r\n%s%s\r\n",
+                       path, host, extra_header, *extra_header ? "\r\n" : "");
+
+    int fd = open_connection();
+    while (now_seconds() < deadline) {
+        if (fd < 0) {
+            w->errors++;
+            fd = open_connection();
+            if (fd < 0) nanosleep(&(struct timespec){ 0, 1000000 }, NULL);
+            continue;
+        }
+
+        double start = now_seconds();
+        if (round_trip(fd, request, (size_t)len) != 0) {
+            w->errors++;
+            close(fd);
+            fd = open_connection();
+            continue;
+        }
+
+        if (w->count == w->capacity) {
+            w->capacity = w->capacity ? w->capacity * 2 : 4096;
+            w->latencies = realloc(w->latencies, w->capacity * sizeof(double));
+        }
+        w->latencies[w->count++] = (now_seconds() - start) * 1000.0;
+    }
+    if (fd >= 0) close(fd);
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t n, double p) {
+    if (n == 0) return 0.0;
+    size_t idx = (size_t)(p / 100.0 * (n - 1) + 0.5);
+    return sorted[idx];
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <host> <port> <path> [connections] [seconds] [header]\n", argv[0]);
+        return 1;
+    }
+    host = argv[1];
+    port = argv[2];
+    path = argv[3];
+    int connections = argc > 4 ? atoi(argv[4]) : 32;
+    double seconds = argc > 5 ? atof(argv[5]) : 10.0;
+    extra_header = argc > 6 ? argv[6] : "";
+    if (connections < 1) connections = 1;
+
+    Worker *workers = calloc(connections, sizeof(Worker));
+    double start = now_seconds();
+    deadline = start + seconds;
+
+    for (int i = 0; i < connections; i++)
+        pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+
+    size_t total = 0;
+    unsigned long errors = 0;
+    for (int i = 0; i < connections; i++) {
+        pthread_join(workers[i].thread, NULL);
+        total += workers[i].count;
+        errors += workers[i].errors;
+    }
+    double elapsed = now_seconds() - start;
+
+    double *all = malloc((total ? total : 1) * sizeof(double));
+    size_t k = 0;
+    for (int i = 0; i < connections; i++) {
+        memcpy(all + k, workers[i].latencies, workers[i].count * sizeof(double));
+        k += workers[i].count;
+        free(workers[i].latencies);
+    }
+    qsort(all, total, sizeof(double), compare_double);
+
+    printf("%-10s %8d conns %10.0f req/s  p50 %7.3f ms  p90 %7.3f ms  p99 %7.3f ms  "
+           "p99.9 %7.3f ms  max %7.3f ms  errors %lu\n",
+           path, connections, total / elapsed,
+           percentile(all, total, 50), percentile(all, total, 90), percentile(all, total, 99),
+           percentile(all, total, 99.9), total ? all[total - 1] : 0.0, errors);
+
+    free(all);
+    free(workers);
+    return 0;
+}
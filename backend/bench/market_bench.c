@@ -0,0 +1,106 @@
+/*
+ * Smart Stock Tracker - Market Scan Benchmark
+ * Runs the same analytics pass (bullish count, average change, best, most
+ * volatile, highest volume, sentiment) over a Stock[] array and over the
+ * columnar MarketState, and checks both agree.
+ *
+ * Usage: market_bench [symbols] [rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <math.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    int bullish;
+    double average;
+    int best, volatile_, volume;
+    const char *sentiment;
+} ScanResult;
+
+static ScanResult scan_rows(Stock *stocks, int count) {
+    ScanResult r;
+    r.bullish = count_bullish_stocks(stocks, count);
+    r.average = calculate_average_change(stocks, count);
+    Stock *best = find_best_performing_stock(stocks, count);
+    Stock *vol = find_most_volatile_stock(stocks, count);
+    Stock *unusual = find_unusual_volume_stock(stocks, count);
+    r.best = best ? (int)(best - stocks) : -1;
+    r.volatile_ = vol ? (int)(vol - stocks) : -1;
+    r.volume = unusual ? (int)(unusual - stocks) : -1;
+    r.sentiment = analyze_market_sentiment(stocks, count);
+    return r;
+}
+
+static ScanResult scan_columns(const MarketState *state) {
+    ScanResult r;
+    r.bullish = market_count_bullish(state);
+    r.average = market_average_change(state);
+    r.best = market_find_best(state);
+    r.volatile_ = market_find_most_volatile(state);
+    r.volume = market_find_highest_volume(state);
+    r.sentiment = market_sentiment(state);
+    return r;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    if (count < 1) count = 1;
+    if (rounds < 1) rounds = 1;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    MarketState state;
+    if (!stocks || !market_state_init(&state, count)) return 1;
+
+    srand(5);
+    for (int i = 0; i < count; i++) {
+        Stock *s = &stocks[i];
+        bench_symbol(i, s->symbol);
+        snprintf(s->name, sizeof(s->name), "Company %d", i % 5000);
+        s->current_price = (i % 97 == 0) ? 0.0 : 10.0 + rand() % 500;
+        s->change_percent = ((rand() % 2001) - 1000) / 100.0;
+        s->volume = rand() % 10000000;
+        s->previous_close = s->current_price / (1.0 + s->change_percent / 100.0);
+        analyze_stock_performance(s);
+    }
+
+    double start = now_seconds();
+    if (!market_state_from_stocks(&state, stocks, count)) return 1;
+    double convert = now_seconds() - start;
+
+    ScanResult rows = scan_rows(stocks, count), columns = scan_columns(&state);
+    double row_time = 0, column_time = 0;
+    for (int r = 0; r < rounds; r++) {
+        start = now_seconds();
+        rows = scan_rows(stocks, count);
+        row_time += now_seconds() - start;
+
+        start = now_seconds();
+        columns = scan_columns(&state);
+        column_time += now_seconds() - start;
+    }
+
+    // The SIMD kernels add lane by lane, so the mean may differ in the last bits
+    int agree = rows.bullish == columns.bullish &&
+                fabs(rows.average - columns.average) <= 1e-9 * (1.0 + fabs(rows.average)) &&
+                rows.best == columns.best && rows.volatile_ == columns.volatile_ &&
+                rows.volume == columns.volume && strcmp(rows.sentiment, columns.sentiment) == 0;
+
+    printf("%d symbols  Stock[] %8.2f ms/scan  MarketState %8.2f ms/scan  "
+           "(%zu vs %zu hot bytes/row)  convert %.1f ms  %s\n",
+           count, row_time / rounds * 1e3, column_time / rounds * 1e3,
+           sizeof(Stock), 3 * sizeof(double), convert * 1e3,
+           agree ? "results match" : "RESULTS DIFFER");
+
+    market_state_free(&state);
+    free(stocks);
+    return agree ? 0 : 1;
+}
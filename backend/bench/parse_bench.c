@@ -0,0 +1,70 @@
+/*
+ * Smart Stock Tracker - Quote Parser Benchmark
+ * Parses a captured Finnhub quote with the single-pass parser and with the
+ * cJSON tree parser; reports ns/parse and heap allocations per parse.
+ *
+ * Usage: parse_bench [iterations]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../stock_tracker.h"
+#include <cjson/cJSON.h>
+
+static const char *QUOTE =
+    "{\"c\":261.74,\"d\":0.42,\"dp\":0.1607,\"h\":263.31,\"l\":260.68,"
+    "\"o\":261.07,\"pc\":261.32,\"t\":1727200800}";
+
+static unsigned long allocations = 0;
+
+static void *counting_malloc(size_t size) {
+    allocations++;
+    return malloc(size);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double elapsed, unsigned long allocs, long iterations) {
+    printf("%-14s %8.1f ns/parse  %6.2f allocs/parse\n",
+           name, elapsed * 1e9 / iterations, (double)allocs / iterations);
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    if (iterations < 1) iterations = 1;
+
+    cJSON_Hooks hooks = { counting_malloc, free };
+    cJSON_InitHooks(&hooks);
+
+    size_t len = strlen(QUOTE);
+    Stock stock = {0};
+    strcpy(stock.symbol, "AAPL");
+
+    // Both parsers must agree before their timings mean anything
+    Stock fast = stock, tree = stock;
+    if (!parse_quote_fast(QUOTE, len, &fast) || !parse_stock_json_tree(QUOTE, &tree) ||
+        fast.current_price != tree.current_price || fast.change_percent != tree.change_percent ||
+        fast.day_high != tree.day_high || fast.day_low != tree.day_low ||
+        fast.previous_close != tree.previous_close) {
+        fprintf(stderr, "parsers disagree on the sample quote\n");
+        return 1;
+    }
+
+    allocations = 0;
+    double start = now_seconds();
+    for (long i = 0; i < iterations; i++)
+        parse_quote_fast(QUOTE, len, &stock);
+    report("single-pass", now_seconds() - start, allocations, iterations);
+
+    allocations = 0;
+    start = now_seconds();
+    for (long i = 0; i < iterations; i++)
+        parse_stock_json_tree(QUOTE, &stock);
+    report("cJSON tree", now_seconds() - start, allocations, iterations);
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Smart Stock Tracker - Analysis Pipeline Benchmark
+ * Times the post-fetch analysis (indicators, status, market summary) of a
+ * large universe serially and through pipeline_analyze() on 1, 2, 4, ...
+ * workers, and checks every run produced the same summary and indicator
+ * values as the deterministic (in-order) run, and the same counts and rows
+ * as market_summary_compute.
+ *
+ * Usage: pipeline_bench [symbols] [rounds] [max threads]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <math.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Same quotes for every run: a pure function of (row, round)
+static void make_quotes(Stock stocks[], int count, int round) {
+    for (int i = 0; i < count; i++) {
+        Stock *s = &stocks[i];
+        unsigned int h = (unsigned int)i * 2654435761u ^ (unsigned int)round * 40503u;
+        h ^= h >> 15;
+        h *= 2246822519u;
+        h ^= h >> 13;
+        s->previous_close = 50.0 + i % 400;
+        s->change_percent = ((int)(h % 2001) - 1000) / 100.0;
+        s->current_price = s->previous_close * (1.0 + s->change_percent / 100.0);
+        s->day_high = s->current_price * 1.01;
+        s->day_low = s->current_price * 0.99;
+        s->volume = 1000000.0 + (h >> 8) % 5000000 + round * 1000.0;
+        s->last_update = 1700000000 + round * 5;
+    }
+}
+
+static void reset_universe(Stock stocks[], int count, const IndicatorConfig *config) {
+    memset(stocks, 0, count * sizeof(Stock));
+    for (int i = 0; i < count; i++)
+        bench_symbol(i, stocks[i].symbol);
+    indicators_free();
+    indicators_init(config, count);
+}
+
+static int same_rows(const MarketSummary *a, const MarketSummary *b) {
+    if (a->count != b->count || a->valid != b->valid || a->positive != b->positive ||
+        a->bullish != b->bullish || a->bearish != b->bearish || a->neutral != b->neutral ||
+        a->best != b->best || a->worst != b->worst || a->most_volatile != b->most_volatile ||
+        a->highest_volume != b->highest_volume || a->top_count != b->top_count)
+        return 0;
+    return memcmp(a->top, b->top, a->top_count * sizeof(a->top[0])) == 0;
+}
+
+static int same_summary(const MarketSummary *a, const MarketSummary *b) {
+    return same_rows(a, b) && a->change_sum == b->change_sum && a->price_sum == b->price_sum &&
+           a->volume_sum == b->volume_sum;
+}
+
+// Run `rounds` refreshes; returns seconds spent analyzing
+static double run(Stock stocks[], int count, int rounds, const IndicatorConfig *indicators,
+                  const PipelineConfig *pipeline, MarketSummary *summary) {
+    reset_universe(stocks, count, indicators);
+    if (pipeline) pipeline_init(pipeline);
+
+    double elapsed = 0;
+    for (int r = 0; r < rounds; r++) {
+        make_quotes(stocks, count, r);
+        double start = now_seconds();
+        if (pipeline) {
+            pipeline_analyze(stocks, count, summary);
+        } else {
+            // What the refresher did before the pipeline
+            indicators_update_all(stocks, count);
+            for (int i = 0; i < count; i++) analyze_stock_performance(&stocks[i]);
+            market_summary_compute(stocks, count, summary);
+        }
+        elapsed += now_seconds() - start;
+    }
+
+    if (pipeline) pipeline_free();
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 50000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 50;
+    int max_threads = argc > 3 ? atoi(argv[3]) : 16;
+    if (count < 1) count = 1;
+    if (rounds < 1) rounds = 1;
+    if (max_threads < 1) max_threads = 1;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    IndicatorValues *reference_values = malloc(count * sizeof(IndicatorValues));
+    if (!stocks || !reference_values) return 1;
+
+    IndicatorConfig indicators;
+    indicators_config_defaults(&indicators);
+    PipelineConfig pipeline;
+    pipeline_config_defaults(&pipeline);
+
+    MarketSummary serial, reference, summary;
+    double serial_time = run(stocks, count, rounds, &indicators, NULL, &serial) / rounds;
+    printf("%d symbols  serial        %8.1f us/refresh\n", count, serial_time * 1e6);
+
+    pipeline.deterministic = 1;
+    double time = run(stocks, count, rounds, &indicators, &pipeline, &reference) / rounds;
+    memcpy(reference_values, indicators_values(), count * sizeof(IndicatorValues));
+    int ok = same_rows(&serial, &reference) &&
+             fabs(serial.change_sum - reference.change_sum) < 1e-6 * count;
+    printf("%d symbols  deterministic %8.1f us/refresh  %s\n", count, time * 1e6,
+           ok ? "matches serial" : "DIFFERS FROM SERIAL");
+
+    pipeline.deterministic = 0;
+    double one_thread = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        pipeline.threads = threads;
+        time = run(stocks, count, rounds, &indicators, &pipeline, &summary) / rounds;
+        if (threads == 1) one_thread = time;
+        int same = same_summary(&summary, &reference) &&
+                   memcmp(indicators_values(), reference_values, count * sizeof(IndicatorValues)) == 0;
+        ok = ok && same;
+        printf("%d symbols  %2d thread(s)  %8.1f us/refresh  speedup %5.2fx  %s\n", count, threads,
+               time * 1e6, one_thread / time, same ? "identical" : "DIFFERENT");
+    }
+
+    indicators_free();
+    free(reference_values);
+    free(stocks);
+    return ok ? 0 : 1;
+}
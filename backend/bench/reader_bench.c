@@ -0,0 +1,181 @@
+/*
+ * Smart Stock Tracker - Lock-Free Reader Benchmark
+ * One writer streams ticks into the leaderboard and churns the registry
+ * while reader threads look symbols up, read the top K and rank symbols.
+ * Reports reader latency percentiles and writer throughput per reader
+ * count, and checks every read was consistent: tracked symbols always
+ * resolve and every top-K copy is in order.
+ *
+ * Usage: reader_bench [symbols] [seconds per round] [max readers]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <pthread.h>
+
+#define LATENCY_SAMPLES 200000
+#define CHURN_SYMBOLS 64
+
+static int symbol_count;
+static char (*symbols)[SYMBOL_KEY_LENGTH + 1];
+static int stop = 0;
+static long writer_ops = 0;
+
+typedef struct {
+    double *latency;                         // seconds per sampled read
+    int samples;
+    long reads;
+    long failures;
+    unsigned int seed;
+} ReaderStats;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *writer_loop(void *arg) {
+    (void)arg;
+    Stock stock;
+    memset(&stock, 0, sizeof(stock));
+    unsigned int seed = 23;
+    long ops = 0;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) {
+        int row = rand_r(&seed) % symbol_count;
+        snprintf(stock.symbol, sizeof(stock.symbol), "%s", symbols[row]);
+        stock.current_price = 10.0 + rand_r(&seed) % 500;
+        stock.change_percent = ((int)(rand_r(&seed) % 2001) - 1000) / 100.0;
+        stock.last_update++;
+        // Now and then drop a row so its node is retired and reallocated
+        if (rand_r(&seed) % 64 == 0) leaderboard_remove(row);
+        leaderboard_update(row, &stock, NULL);
+
+        // Churn symbols past the tracked ones: adds grow, removes shift the index
+        char churn[SYMBOL_KEY_LENGTH + 1];
+        snprintf(churn, sizeof(churn), "C%d", rand_r(&seed) % CHURN_SYMBOLS);
+        if (registry_find(churn) >= 0) registry_remove(churn);
+        else registry_add(churn);
+        ops++;
+    }
+    __atomic_store_n(&writer_ops, ops, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *reader_loop(void *arg) {
+    ReaderStats *stats = arg;
+    LeaderboardView *view = malloc(sizeof(LeaderboardView));
+    if (!view) return NULL;
+
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) {
+        const char *symbol = symbols[rand_r(&stats->seed) % symbol_count];
+        double start = now_seconds();
+        int slot = registry_find(symbol);
+        int count = leaderboard_top_k(20, view);
+        int rank = leaderboard_rank(symbol);
+        double elapsed = now_seconds() - start;
+
+        int ok = slot >= 0 && rank >= 0 && rank <= symbol_count;
+        for (int i = 1; i < count && ok; i++)
+            ok = view->stocks[i - 1].change_percent >= view->stocks[i].change_percent;
+        stats->failures += !ok;
+        if (stats->samples < LATENCY_SAMPLES) stats->latency[stats->samples++] = elapsed;
+        stats->reads++;
+    }
+    free(view);
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Run the writer alongside `readers` reader threads; returns reads that failed a check
+static long run_round(int readers, double seconds) {
+    ReaderStats *stats = calloc(readers > 0 ? readers : 1, sizeof(ReaderStats));
+    pthread_t *threads = calloc(readers > 0 ? readers : 1, sizeof(pthread_t));
+    double *merged = malloc((size_t)(readers > 0 ? readers : 1) * LATENCY_SAMPLES * sizeof(double));
+    if (!stats || !threads || !merged) return 1;
+
+    __atomic_store_n(&stop, 0, __ATOMIC_RELEASE);
+    pthread_t writer;
+    pthread_create(&writer, NULL, writer_loop, NULL);
+    for (int i = 0; i < readers; i++) {
+        stats[i].latency = malloc(LATENCY_SAMPLES * sizeof(double));
+        stats[i].seed = 100 + i;
+        pthread_create(&threads[i], NULL, reader_loop, &stats[i]);
+    }
+
+    struct timespec pause = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+    nanosleep(&pause, NULL);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+
+    long reads = 0, failures = 0;
+    int samples = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+        reads += stats[i].reads;
+        failures += stats[i].failures;
+        memcpy(merged + samples, stats[i].latency, stats[i].samples * sizeof(double));
+        samples += stats[i].samples;
+        free(stats[i].latency);
+    }
+
+    long writes = __atomic_load_n(&writer_ops, __ATOMIC_ACQUIRE);
+    if (samples > 0) {
+        qsort(merged, samples, sizeof(double), compare_double);
+        printf("%2d reader(s)  %8.0f reads/s  p50 %6.2f us  p99 %7.2f us  max %8.2f us  "
+               "writer %8.0f ticks/s  %s\n",
+               readers, reads / seconds, merged[samples / 2] * 1e6,
+               merged[(int)(samples * 0.99)] * 1e6, merged[samples - 1] * 1e6,
+               writes / seconds, failures ? "INCONSISTENT" : "consistent");
+    } else {
+        printf("%2d reader(s)  writer %8.0f ticks/s\n", readers, writes / seconds);
+    }
+
+    free(stats);
+    free(threads);
+    free(merged);
+    return failures;
+}
+
+int main(int argc, char *argv[]) {
+    symbol_count = argc > 1 ? atoi(argv[1]) : 10000;
+    double seconds = argc > 2 ? atof(argv[2]) : 1.0;
+    int max_readers = argc > 3 ? atoi(argv[3]) : 8;
+    if (symbol_count < 1) symbol_count = 1;
+    if (seconds <= 0) seconds = 1.0;
+    if (max_readers < 1) max_readers = 1;
+
+    symbols = malloc(symbol_count * sizeof(*symbols));
+    if (!symbols || !registry_init(symbol_count + CHURN_SYMBOLS) || !leaderboard_init(symbol_count))
+        return 1;
+
+    // Tracked symbols take rows 0..n-1 and are never removed
+    Stock stock;
+    memset(&stock, 0, sizeof(stock));
+    for (int i = 0; i < symbol_count; i++) {
+        bench_symbol(i, symbols[i]);
+        registry_add(symbols[i]);
+        snprintf(stock.symbol, sizeof(stock.symbol), "%s", symbols[i]);
+        stock.current_price = 100.0;
+        stock.change_percent = (i % 2001 - 1000) / 100.0;
+        leaderboard_update(i, &stock, NULL);
+    }
+
+    long failures = run_round(0, seconds);
+    for (int readers = 1; readers <= max_readers; readers *= 2)
+        failures += run_round(readers, seconds);
+
+    epoch_reclaim();
+    printf("retired objects still pending: %d\n", epoch_pending());
+
+    leaderboard_free();
+    registry_free();
+    epoch_drain();
+    free(symbols);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Smart Stock Tracker - Symbol Registry Benchmark
+ * Registers a large universe, then times symbol -> slot lookups through the
+ * hash index against the linear strcmp scan they replace, and add/remove
+ * churn; checks every symbol still resolves to the slot holding it.
+ *
+ * Usage: registry_bench [symbols] [lookups]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../stock_tracker.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int linear_find(const Stock stocks[], int count, const char *symbol) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(stocks[i].symbol, symbol) == 0) return i;
+    }
+    return -1;
+}
+
+// Every slot's symbol must map back to that slot
+static int check_slots(void) {
+    const Stock *stocks = registry_stocks();
+    for (int i = 0; i < registry_count(); i++) {
+        if (registry_find(stocks[i].symbol) != i) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 50000;
+    int lookups = argc > 2 ? atoi(argv[2]) : 1000000;
+    if (count < 1) count = 1;
+    if (lookups < 1) lookups = 1;
+
+    char (*symbols)[SYMBOL_KEY_LENGTH + 1] = malloc(count * sizeof(*symbols));
+    if (!symbols || !registry_init(64)) return 1;
+    // Distinct 8-character symbols, scattered rather than sequential
+    for (int i = 0; i < count; i++)
+        snprintf(symbols[i], sizeof(symbols[i]), "T%07X", (i * 2654435761u) & 0xFFFFFFFu);
+
+    double start = now_seconds();
+    for (int i = 0; i < count; i++) registry_add(symbols[i]);
+    double add_time = now_seconds() - start;
+    int ok = registry_count() == count && check_slots();
+
+    srand(21);
+    start = now_seconds();
+    long found = 0;
+    for (int i = 0; i < lookups; i++) found += registry_find(symbols[rand() % count]) >= 0;
+    double hash_time = (now_seconds() - start) / lookups;
+    ok = ok && found == lookups;
+
+    int scans = lookups / 1000 > 0 ? lookups / 1000 : 1;
+    start = now_seconds();
+    found = 0;
+    for (int i = 0; i < scans; i++)
+        found += linear_find(registry_stocks(), registry_count(), symbols[rand() % count]) >= 0;
+    double scan_time = (now_seconds() - start) / scans;
+    ok = ok && found == scans;
+
+    // Churn: drop and re-add a tenth of the universe
+    int churn = count / 10 > 0 ? count / 10 : 1;
+    start = now_seconds();
+    for (int i = 0; i < churn; i++) registry_remove(symbols[(i * 7) % count]);
+    for (int i = 0; i < churn; i++) registry_add(symbols[(i * 7) % count]);
+    double churn_time = (now_seconds() - start) / (2.0 * churn);
+    ok = ok && registry_count() == count && check_slots();
+
+    printf("%d symbols  add %.1f ms  lookup %.1f ns (hash) vs %.1f us (scan)  "
+           "add/remove %.2f us  %s\n",
+           count, add_time * 1e3, hash_time * 1e9, scan_time * 1e6, churn_time * 1e6,
+           ok ? "consistent" : "INCONSISTENT");
+
+    registry_free();
+    free(symbols);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Smart Stock Tracker - Binary Snapshot Benchmark
+ * Saves and reloads N stocks through the binary snapshot format; reports
+ * load time and checks every field comes back bit-for-bit.
+ *
+ * Usage: snapshot_bench [stocks] [file]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double random_double(void) {
+    return (double)rand() / RAND_MAX * 1000.0 + (double)rand() / RAND_MAX / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    const char *file = argc > 2 ? argv[2] : "/tmp/stock_snapshot_bench.bin";
+    if (count < 1) count = 1;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    Stock *loaded = calloc(count, sizeof(Stock));
+    if (!stocks || !loaded) return 1;
+
+    srand(7);
+    for (int i = 0; i < count; i++) {
+        bench_symbol(i, stocks[i].symbol);
+        snprintf(stocks[i].name, sizeof(stocks[i].name), "Company %d", i);
+        stocks[i].status = STATUS_NEUTRAL;
+        stocks[i].current_price = random_double();
+        stocks[i].change_percent = random_double() - 500.0;
+        stocks[i].volume = random_double() * 1e5;
+        stocks[i].previous_close = random_double();
+        stocks[i].day_high = random_double();
+        stocks[i].day_low = random_double();
+        stocks[i].market_cap = random_double() * 1e9;
+        stocks[i].last_update = 1700000000 + i;
+    }
+
+    double start = now_seconds();
+    if (!save_stocks_binary(stocks, count, file)) return 1;
+    double saved = now_seconds();
+    int n = load_stocks_binary(loaded, count, file);
+    double done = now_seconds();
+
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        const Stock *a = &stocks[i], *b = &loaded[i];
+        if (strcmp(a->symbol, b->symbol) || strcmp(a->name, b->name) || a->status != b->status ||
+            a->current_price != b->current_price || a->change_percent != b->change_percent ||
+            a->volume != b->volume || a->previous_close != b->previous_close ||
+            a->day_high != b->day_high || a->day_low != b->day_low ||
+            a->market_cap != b->market_cap || a->last_update != b->last_update)
+            mismatches++;
+    }
+
+    printf("%d stocks  save %.2f ms  load %.2f ms  loaded %d  mismatches %d\n",
+           count, (saved - start) * 1e3, (done - saved) * 1e3, n, mismatches);
+
+    remove(file);
+    free(stocks);
+    free(loaded);
+    return (n == count && mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/*
+ * Smart Stock Tracker - Tick History Benchmark
+ * Appends rounds of ticks for a large universe into a scratch store, times
+ * the appends, a full-range tickstore_scan() per symbol and
+ * tickstore_recent_prices(), and checks both read paths return exactly
+ * the rows written. The store lives in a fresh temporary directory.
+ *
+ * Usage: tickstore_bench [symbols] [rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <unistd.h>
+
+#define RECENT_WINDOW 16
+
+typedef struct {
+    size_t rows;
+    int ok;
+    int round;                               // next round expected
+    int symbol;
+} ScanCheck;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double tick_price(int symbol, int round) {
+    return 10.0 + symbol % 1000 + round / 100.0;
+}
+
+static void check_run(const TickColumns *run, void *ctx) {
+    ScanCheck *check = ctx;
+    for (size_t i = 0; i < run->count; i++, check->round++) {
+        if (run->ts[i] != 1700000000 + check->round ||
+            run->price[i] != tick_price(check->symbol, check->round))
+            check->ok = 0;
+    }
+    check->rows += run->count;
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 5000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 200;
+    if (count < 1) count = 1;
+    if (rounds < RECENT_WINDOW) rounds = RECENT_WINDOW;
+
+    char dir[] = "/tmp/tickstore_bench.XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+
+    TickStoreConfig config;
+    tickstore_config_defaults(&config);
+    snprintf(config.dir, sizeof(config.dir), "%s", dir);
+    config.segment_rows = (unsigned int)rounds / 4 + 1;    // a few sealed segments per symbol
+    if (!tickstore_open(&config)) return 1;
+
+    Stock *stocks = calloc(count, sizeof(Stock));
+    if (!stocks) return 1;
+    for (int i = 0; i < count; i++) bench_symbol(i, stocks[i].symbol);
+
+    double start = now_seconds();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            stocks[i].current_price = tick_price(i, r);
+            stocks[i].volume = 1000.0 + r;
+            stocks[i].last_update = 1700000000 + r;
+        }
+        tickstore_append_since(stocks, count, 0);
+    }
+    double append_time = now_seconds() - start;
+
+    int ok = 1;
+    start = now_seconds();
+    for (int i = 0; i < count; i++) {
+        ScanCheck check = { 0, 1, 0, i };
+        tickstore_scan(stocks[i].symbol, 0, 1700000000 + rounds, check_run, &check);
+        ok = ok && check.ok && check.rows == (size_t)rounds;
+    }
+    double scan_time = now_seconds() - start;
+
+    start = now_seconds();
+    double prices[RECENT_WINDOW];
+    for (int i = 0; i < count; i++) {
+        int n = tickstore_recent_prices(stocks[i].symbol, prices, RECENT_WINDOW);
+        for (int j = 0; j < n; j++)
+            ok = ok && prices[j] == tick_price(i, rounds - RECENT_WINDOW + j);
+        ok = ok && n == RECENT_WINDOW;
+    }
+    double recent_time = now_seconds() - start;
+
+    long long ticks = (long long)count * rounds;
+    printf("%d symbols x %d rounds  append  %8.1f ns/tick\n", count, rounds, append_time * 1e9 / ticks);
+    printf("%d symbols x %d rounds  scan    %8.1f ns/tick\n", count, rounds, scan_time * 1e9 / ticks);
+    printf("%d symbols  recent %d prices    %8.1f us/symbol  %s\n", count, RECENT_WINDOW,
+           recent_time * 1e6 / count, ok ? "rows match" : "ROWS DIFFER");
+
+    tickstore_close();
+    free(stocks);
+    if (system(command) != 0) ok = 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+/*
+ * Smart Stock Tracker - Response Compression
+ * One-shot gzip and brotli encoders used when a snapshot is published
+ */
+
+#include "stock_tracker.h"
+#include <zlib.h>
+#ifdef HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+// Compress `in` into a gzip stream; returns a heap buffer the caller frees
+char* gzip_compress(const char* in, size_t in_size, size_t* out_size) {
+    if (!in || !out_size) return NULL;
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // windowBits 15 + 16 selects the gzip wrapper instead of zlib
+    if (deflateInit2(&zs, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+        return NULL;
+
+    size_t bound = deflateBound(&zs, in_size);
+    char* out = malloc(bound);
+    if (!out) {
+        deflateEnd(&zs);
+        return NULL;
+    }
+
+    zs.next_in = (Bytef*)in;
+    zs.avail_in = (uInt)in_size;
+    zs.next_out = (Bytef*)out;
+    zs.avail_out = (uInt)bound;
+
+    int res = deflate(&zs, Z_FINISH);
+    *out_size = zs.total_out;
+    deflateEnd(&zs);
+
+    if (res != Z_STREAM_END) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+// Compress `in` with brotli; returns NULL when built without brotli
+char* brotli_compress(const char* in, size_t in_size, size_t* out_size) {
+#ifdef HAVE_BROTLI
+    if (!in || !out_size) return NULL;
+
+    size_t bound = BrotliEncoderMaxCompressedSize(in_size);
+    if (bound == 0) return NULL;
+
+    char* out = malloc(bound);
+    if (!out) return NULL;
+
+    *out_size = bound;
+    if (!BrotliEncoderCompress(BROTLI_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               in_size, (const uint8_t*)in, out_size, (uint8_t*)out)) {
+        free(out);
+        return NULL;
+    }
+    return out;
+#else
+    (void)in;
+    (void)in_size;
+    (void)out_size;
+    return NULL;
+#endif
+}
@@ -0,0 +1,97 @@
+/*
+ * Smart Stock Tracker - Configuration
+ * key = value config files and --key=value command-line flags
+ */
+
+#include "stock_tracker.h"
+#include <ctype.h>
+
+// Trim leading/trailing whitespace in place
+static char* trim(char* text) {
+    while (isspace((unsigned char)*text)) text++;
+
+    char* end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+
+    return text;
+}
+
+int config_load(const char* filename, ConfigSetter setter, void* ctx) {
+    if (!filename || !setter) return 0;
+
+    FILE* file = fopen(filename, "r");
+    if (!file) return 0;
+
+    char line[256];
+    int line_no = 0;
+    int applied = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char* text = trim(line);
+        if (*text == '\0') continue;
+
+        char* eq = strchr(text, '=');
+        if (!eq) {
+            fprintf(stderr, "%s:%d: expected key = value\n", filename, line_no);
+            continue;
+        }
+        *eq = '\0';
+
+        char* key = trim(text);
+        char* value = trim(eq + 1);
+        if (setter(key, value, ctx)) applied++;
+    }
+
+    fclose(file);
+    return applied;
+}
+
+int config_parse_args(int argc, char* argv[], ConfigSetter setter, void* ctx) {
+    if (!argv || !setter) return 0;
+
+    int applied = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0) continue;
+
+        // --server-mode=pool is the same setting as server_mode = pool
+        char key[64];
+        const char* arg = argv[i] + 2;
+        const char* eq = strchr(arg, '=');
+        size_t len = eq ? (size_t)(eq - arg) : strlen(arg);
+        if (len == 0 || len >= sizeof(key)) continue;
+
+        for (size_t k = 0; k < len; k++)
+            key[k] = (arg[k] == '-') ? '_' : arg[k];
+        key[len] = '\0';
+
+        if (setter(key, eq ? eq + 1 : "1", ctx)) applied++;
+    }
+
+    return applied;
+}
+
+int config_parse_uint(const char* value, unsigned int max, unsigned int* out) {
+    char* end;
+    unsigned long v = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || v > max) return 0;
+    *out = (unsigned int)v;
+    return 1;
+}
+
+const char* config_find_arg(int argc, char* argv[], const char* name) {
+    size_t len = strlen(name);
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, name, len) == 0 &&
+            argv[i][2 + len] == '=')
+            return argv[i] + 3 + len;
+    }
+    return NULL;
+}
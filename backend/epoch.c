@@ -0,0 +1,230 @@
+/*
+ * Smart Stock Tracker - Lock-Free Reader Publication
+ * Epoch-based reclamation and sequence locks, so the HTTP threads can read
+ * what the refresher publishes without taking a lock or making it wait.
+ *
+ * Readers bracket every access to shared pointers with epoch_enter/exit,
+ * which only announce the global epoch in the thread's own slot. A writer
+ * unlinks an object, then retires it; it is reclaimed once the epoch has
+ * advanced twice, which needs every reader inside a critical section to
+ * have seen the newer epoch, so none can still hold the old pointer.
+ * Writers never wait for readers: retired objects simply stay queued
+ * until the readers have moved on.
+ *
+ * Structures updated in place (the leaderboard's links, the registry's
+ * hash index) pair this with a sequence lock: readers copy what they need
+ * and retry if a writer was active meanwhile, and epochs keep the memory
+ * they may have walked into alive.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define EPOCH_MAX_READERS 2048               // above server_threads' limit plus our own threads
+#define EPOCH_CACHE_LINE 64
+
+typedef struct {
+    void *object;
+    void (*reclaim)(void *object);
+    unsigned long epoch;                     // global epoch when it was retired
+} RetiredObject;
+
+// One cache line per thread so announcing an epoch never contends
+typedef union {
+    struct {
+        unsigned long epoch;                 // announced epoch, 0 while quiescent
+        int depth;                           // nested epoch_enter calls
+        int in_use;
+    } state;
+    char pad[EPOCH_CACHE_LINE];
+} ReaderSlot;
+
+static ReaderSlot reader_slots[EPOCH_MAX_READERS];
+static int slots_high = 0;                   // slots ever claimed; scans stop here
+static unsigned long global_epoch = 1;
+
+static pthread_key_t slot_key;
+static pthread_once_t slot_key_once = PTHREAD_ONCE_INIT;
+
+// Writers only: retired objects waiting for a grace period
+static RetiredObject *retired = NULL;
+static int retired_count = 0;
+static int retired_capacity = 0;
+static pthread_mutex_t retire_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// ============================================================================
+// Reader slots
+// ============================================================================
+static void release_slot(void *value) {
+    ReaderSlot *slot = &reader_slots[(intptr_t)value - 1];
+    __atomic_store_n(&slot->state.epoch, 0, __ATOMIC_RELEASE);
+    slot->state.depth = 0;
+    __atomic_store_n(&slot->state.in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void create_slot_key(void) {
+    pthread_key_create(&slot_key, release_slot);
+}
+
+// The calling thread's slot, claimed on first use and freed when it exits
+static ReaderSlot *thread_slot(void) {
+    pthread_once(&slot_key_once, create_slot_key);
+    intptr_t index = (intptr_t)pthread_getspecific(slot_key);
+    if (index) return &reader_slots[index - 1];
+
+    // Only reachable with more live reader threads than slots; wait for
+    // one of them to exit
+    for (;;) {
+        for (int i = 0; i < EPOCH_MAX_READERS; i++) {
+            int expected = 0;
+            if (!__atomic_compare_exchange_n(&reader_slots[i].state.in_use, &expected, 1, 0,
+                                             __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                continue;
+            int high = __atomic_load_n(&slots_high, __ATOMIC_RELAXED);
+            while (high < i + 1 &&
+                   !__atomic_compare_exchange_n(&slots_high, &high, i + 1, 0,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                ;
+            pthread_setspecific(slot_key, (void *)(intptr_t)(i + 1));
+            return &reader_slots[i];
+        }
+        sched_yield();
+    }
+}
+
+// ============================================================================
+// Reader side
+// ============================================================================
+void epoch_enter(void) {
+    ReaderSlot *slot = thread_slot();
+    if (slot->state.depth++ > 0) return;
+
+    // A stale epoch is harmless (it only holds reclamation back); the
+    // fence orders the announcement before every load of shared pointers
+    __atomic_store_n(&slot->state.epoch, __atomic_load_n(&global_epoch, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void epoch_exit(void) {
+    ReaderSlot *slot = thread_slot();
+    if (--slot->state.depth > 0) return;
+    __atomic_store_n(&slot->state.epoch, 0, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// Writer side
+// ============================================================================
+
+// Advance the global epoch if every reader inside a critical section has
+// seen the current one
+static int try_advance(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    unsigned long epoch = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    int high = __atomic_load_n(&slots_high, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < high; i++) {
+        unsigned long seen = __atomic_load_n(&reader_slots[i].state.epoch, __ATOMIC_ACQUIRE);
+        if (seen && seen != epoch) return 0;
+    }
+    __atomic_store_n(&global_epoch, epoch + 1, __ATOMIC_SEQ_CST);
+    return 1;
+}
+
+// Reclaim everything retired at least two epochs ago; caller holds retire_lock
+static int reclaim_expired(void) {
+    unsigned long epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    int kept = 0, reclaimed = 0;
+    for (int i = 0; i < retired_count; i++) {
+        if (retired[i].epoch + 2 <= epoch) {
+            retired[i].reclaim(retired[i].object);
+            reclaimed++;
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired_count = kept;
+    return reclaimed;
+}
+
+void epoch_retire(void *object, void (*reclaim)(void *object)) {
+    if (!object || !reclaim) return;
+
+    pthread_mutex_lock(&retire_lock);
+    if (retired_count == retired_capacity) {
+        int capacity = retired_capacity ? retired_capacity * 2 : 64;
+        RetiredObject *grown = realloc(retired, capacity * sizeof(RetiredObject));
+        if (!grown) {
+            // Cannot defer it; leaking is the only safe option while
+            // readers may still see it
+            pthread_mutex_unlock(&retire_lock);
+            display_error("Out of memory retiring an object; leaking it");
+            return;
+        }
+        retired = grown;
+        retired_capacity = capacity;
+    }
+    retired[retired_count++] = (RetiredObject){
+        object, reclaim, __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE)
+    };
+    pthread_mutex_unlock(&retire_lock);
+
+    epoch_reclaim();
+}
+
+int epoch_reclaim(void) {
+    pthread_mutex_lock(&retire_lock);
+    int reclaimed = 0;
+    if (retired_count > 0) {
+        // Two advances cover everything retired before this call when no
+        // reader is mid-section; otherwise what is left waits for next time
+        if (try_advance()) try_advance();
+        reclaimed = reclaim_expired();
+    }
+    pthread_mutex_unlock(&retire_lock);
+    return reclaimed;
+}
+
+void epoch_drain(void) {
+    pthread_mutex_lock(&retire_lock);
+    for (int i = 0; i < retired_count; i++)
+        retired[i].reclaim(retired[i].object);
+    free(retired);
+    retired = NULL;
+    retired_count = retired_capacity = 0;
+    pthread_mutex_unlock(&retire_lock);
+}
+
+int epoch_pending(void) {
+    pthread_mutex_lock(&retire_lock);
+    int pending = retired_count;
+    pthread_mutex_unlock(&retire_lock);
+    return pending;
+}
+
+// ============================================================================
+// Sequence locks
+// ============================================================================
+unsigned long seqlock_read_begin(const SeqLock *lock) {
+    unsigned long sequence;
+    // Odd while a writer is mid-update; its section is short
+    while ((sequence = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE)) & 1)
+        sched_yield();
+    return sequence;
+}
+
+int seqlock_read_retry(const SeqLock *lock, unsigned long start) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != start;
+}
+
+void seqlock_write_begin(SeqLock *lock) {
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seqlock_write_end(SeqLock *lock) {
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+}
@@ -1,12 +1,239 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "stock_tracker.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// fscanf field width for symbols: MAX_SYMBOL_LENGTH - 1
+#define SYMBOL_SCAN_WIDTH 9
+#define STRINGIFY_ARG(x) #x
+#define STRINGIFY(x) STRINGIFY_ARG(x)
+typedef char symbol_scan_width_matches[SYMBOL_SCAN_WIDTH == MAX_SYMBOL_LENGTH - 1 ? 1 : -1];
+
+// ---------------------------------------------------------------------------
+// Atomic writes: contents go to a temp file in the target's directory and
+// are renamed over it, so readers see the old file or the new one, never a
+// partial write.
+// ---------------------------------------------------------------------------
+static int fsync_path(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+static int fsync_directory_of(const char* path) {
+    char dir[MAX_PATH_LENGTH];
+    const char* slash = strrchr(path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else {
+        size_t len = (size_t)(slash - path);
+        if (len == 0) len = 1;  // "/file"
+        if (len >= sizeof(dir)) return 0;
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    return fsync_path(dir);
+}
+
+FILE* atomic_file_open(AtomicFile* af, const char* filename) {
+    memset(af, 0, sizeof(*af));
+    if (snprintf(af->target, sizeof(af->target), "%s", filename) >= (int)sizeof(af->target) ||
+        snprintf(af->temp_path, sizeof(af->temp_path), "%s.tmpXXXXXX", filename) >= (int)sizeof(af->temp_path))
+        return NULL;
+
+    int fd = mkstemp(af->temp_path);
+    if (fd < 0) return NULL;
+    fchmod(fd, 0644);  // mkstemp creates 0600; keep the usual file mode
+
+    af->fp = fdopen(fd, "w");
+    if (!af->fp) {
+        close(fd);
+        unlink(af->temp_path);
+    }
+    return af->fp;
+}
+
+int atomic_file_commit(AtomicFile* af) {
+    if (!af->fp) return 0;
+
+    int ok = fflush(af->fp) == 0 && !ferror(af->fp);
+    if (ok && FSYNC_POLICY >= FSYNC_DATA)
+        ok = fsync(fileno(af->fp)) == 0;
+    if (fclose(af->fp) != 0) ok = 0;
+    af->fp = NULL;
+
+    if (!ok || rename(af->temp_path, af->target) != 0) {
+        unlink(af->temp_path);
+        return 0;
+    }
+    if (FSYNC_POLICY >= FSYNC_FULL) fsync_directory_of(af->target);
+    return 1;
+}
+
+void atomic_file_abort(AtomicFile* af) {
+    if (!af->fp) return;
+    fclose(af->fp);
+    af->fp = NULL;
+    unlink(af->temp_path);
+}
+
+int write_file_atomic(const char* filename, const char* data, size_t size) {
+    AtomicFile af;
+    FILE* fp = atomic_file_open(&af, filename);
+    if (!fp) return 0;
+
+    if (fwrite(data, 1, size, fp) != size) {
+        atomic_file_abort(&af);
+        return 0;
+    }
+    return atomic_file_commit(&af);
+}
+
+// ---------------------------------------------------------------------------
+// Generations: a set of files published together. Each generation is a
+// fresh directory <dir>/gen-N; <dir>/current is a symlink renamed onto the
+// newest one, and <dir>/<name> are fixed symlinks to current/<name>. A
+// reader that resolves `current` once sees one consistent generation.
+// ---------------------------------------------------------------------------
+static unsigned long last_generation = 0;
+static int generation_links_ready = 0;
+
+// Replace `path` with a symlink to `target` in one rename
+static int replace_with_symlink(const char* target, const char* path) {
+    char temp[MAX_PATH_LENGTH];
+    if (snprintf(temp, sizeof(temp), "%s.tmp-link", path) >= (int)sizeof(temp)) return 0;
+
+    unlink(temp);
+    if (symlink(target, temp) != 0) return 0;
+    if (rename(temp, path) != 0) {
+        unlink(temp);
+        return 0;
+    }
+    return 1;
+}
+
+static void generation_path(char* out, size_t size, const char* dir, unsigned long gen, const char* name) {
+    if (name) snprintf(out, size, "%s/gen-%lu/%s", dir, gen, name);
+    else snprintf(out, size, "%s/gen-%lu", dir, gen);
+}
+
+static void remove_generation(const char* dir, unsigned long gen, const GenerationFile files[], int count) {
+    char path[MAX_PATH_LENGTH];
+    for (int i = 0; i < count; i++) {
+        generation_path(path, sizeof(path), dir, gen, files[i].name);
+        unlink(path);
+    }
+    generation_path(path, sizeof(path), dir, gen, NULL);
+    rmdir(path);
+}
+
+// Write one file into a not-yet-visible generation directory
+static int write_generation_file(const char* path, const GenerationFile* file) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+
+    const char* p = file->data;
+    size_t left = file->size;
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            return 0;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+
+    int ok = FSYNC_POLICY >= FSYNC_DATA ? fsync(fd) == 0 : 1;
+    if (close(fd) != 0) ok = 0;
+    return ok;
+}
+
+int publish_generation(const char* dir, const GenerationFile files[], int count) {
+    char path[MAX_PATH_LENGTH], previous[MAX_PATH_LENGTH], current[MAX_PATH_LENGTH];
+    snprintf(current, sizeof(current), "%s/current", dir);
+
+    // Continue numbering from whatever a previous run left behind
+    if (last_generation == 0) {
+        char target[64];
+        ssize_t len = readlink(current, target, sizeof(target) - 1);
+        if (len > 0) {
+            target[len] = '\0';
+            sscanf(target, "gen-%lu", &last_generation);
+        }
+    }
+
+    unsigned long gen = last_generation + 1;
+    remove_generation(dir, gen, files, count);  // debris from a crashed run
+    generation_path(path, sizeof(path), dir, gen, NULL);
+    if (mkdir(path, 0755) != 0) {
+        display_error("Failed to create snapshot generation directory.");
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        generation_path(path, sizeof(path), dir, gen, files[i].name);
+
+        // Unchanged files are hard-linked from the previous generation:
+        // no rewrite and no second fsync of data that is already durable
+        if (files[i].unchanged && last_generation) {
+            generation_path(previous, sizeof(previous), dir, last_generation, files[i].name);
+            if (link(previous, path) == 0) continue;
+        }
+
+        if (!write_generation_file(path, &files[i])) {
+            remove_generation(dir, gen, files, count);
+            display_error("Failed to write snapshot generation.");
+            return 0;
+        }
+    }
+
+    // One directory fsync for the whole batch, then the switch itself
+    generation_path(path, sizeof(path), dir, gen, NULL);
+    if (FSYNC_POLICY >= FSYNC_DATA) fsync_path(path);
+
+    char target[64];
+    snprintf(target, sizeof(target), "gen-%lu", gen);
+    if (!replace_with_symlink(target, current)) {
+        remove_generation(dir, gen, files, count);
+        display_error("Failed to switch snapshot generation.");
+        return 0;
+    }
+    if (FSYNC_POLICY >= FSYNC_FULL) fsync_directory_of(current);
+
+    if (!generation_links_ready) {
+        generation_links_ready = 1;
+        for (int i = 0; i < count; i++) {
+            char link_target[MAX_PATH_LENGTH];
+            snprintf(link_target, sizeof(link_target), "current/%s", files[i].name);
+            snprintf(path, sizeof(path), "%s/%s", dir, files[i].name);
+            if (!replace_with_symlink(link_target, path)) generation_links_ready = 0;
+        }
+    }
+
+    // Keep the previous generation for readers that resolved it just before
+    // the switch; anything older goes
+    if (gen > 2) remove_generation(dir, gen - 2, files, count);
+    last_generation = gen;
+    return 1;
+}
 
 // Save stock data to file
 int save_stocks_to_file(Stock stocks[], int count, const char* filename) {
-    FILE* file = fopen(filename, "w");
+    AtomicFile af;
+    FILE* file = atomic_file_open(&af, filename);
     if (!file) {
         display_error("Failed to open stock file for writing.");
         return 0;
@@ -20,7 +247,10 @@ int save_stocks_to_file(Stock stocks[], int count, const char* filename) {
                 stocks[i].change_percent);
     }
 
-    fclose(file);
+    if (!atomic_file_commit(&af)) {
+        display_error("Failed to save stock file.");
+        return 0;
+    }
     display_success("Stock data saved successfully.");
     return 1;
 }
@@ -33,8 +263,9 @@ int load_stocks_from_file(Stock stocks[], int max_count, const char* filename) {
         return 0;
     }
 
+    // Width-limited so a long token cannot overflow symbol[]
     int i = 0;
-    while (i < max_count && fscanf(file, "%s %lf %lf %lf",
+    while (i < max_count && fscanf(file, "%" STRINGIFY(SYMBOL_SCAN_WIDTH) "s %lf %lf %lf",
                                    stocks[i].symbol,
                                    &stocks[i].current_price,
                                    &stocks[i].previous_close,
@@ -46,9 +277,202 @@ int load_stocks_from_file(Stock stocks[], int max_count, const char* filename) {
     return i;
 }
 
+// ---------------------------------------------------------------------------
+// Binary snapshot: header + fixed-width records for the full Stock, checked
+// with a CRC32 and loaded with one mmap. Fields are copied one by one so the
+// on-disk layout does not depend on the in-memory struct.
+// ---------------------------------------------------------------------------
+#define STOCK_SNAPSHOT_MAGIC "STKSNAP1"
+#define STOCK_SNAPSHOT_VERSION 1
+#define STOCK_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;     // written natively; a foreign-endian file reads back swapped
+    uint32_t record_size;
+    uint32_t crc32;          // over the records
+    uint64_t count;
+    int64_t saved_at;
+} StockSnapshotHeader;
+
+typedef struct {
+    char symbol[16];
+    char name[104];
+    char status[56];
+    double current_price;
+    double change_percent;
+    double volume;
+    double previous_close;
+    double day_high;
+    double day_low;
+    double market_cap;
+    int64_t last_update;
+} StockRecord;
+
+// Layout is part of the file format: fail the build if it drifts
+typedef char stock_snapshot_header_is_40_bytes[sizeof(StockSnapshotHeader) == 40 ? 1 : -1];
+typedef char stock_record_is_240_bytes[sizeof(StockRecord) == 240 ? 1 : -1];
+
+static void stock_to_record(const Stock* stock, StockRecord* rec) {
+    memset(rec, 0, sizeof(*rec));
+    snprintf(rec->symbol, sizeof(rec->symbol), "%s", stock->symbol);
+    snprintf(rec->name, sizeof(rec->name), "%s", stock->name);
+    // Files store the label, not the code, so renumbering StockStatus keeps them readable
+    snprintf(rec->status, sizeof(rec->status), "%s", stock_status_label((StockStatus)stock->status));
+    rec->current_price = stock->current_price;
+    rec->change_percent = stock->change_percent;
+    rec->volume = stock->volume;
+    rec->previous_close = stock->previous_close;
+    rec->day_high = stock->day_high;
+    rec->day_low = stock->day_low;
+    rec->market_cap = stock->market_cap;
+    rec->last_update = (int64_t)stock->last_update;
+}
+
+// Copy a record string field, always NUL-terminated within `size`
+static void copy_record_string(char* dst, size_t size, const char* src, size_t src_size) {
+    size_t len = src_size < size - 1 ? src_size : size - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+static void record_to_stock(const StockRecord* rec, Stock* stock) {
+    // Records are zero-padded, but never trust the file for termination
+    copy_record_string(stock->symbol, sizeof(stock->symbol), rec->symbol, sizeof(rec->symbol));
+    copy_record_string(stock->name, sizeof(stock->name), rec->name, sizeof(rec->name));
+    char status[sizeof(rec->status) + 1];
+    copy_record_string(status, sizeof(status), rec->status, sizeof(rec->status));
+    stock->status = (unsigned char)stock_status_from_label(status);
+    stock->current_price = rec->current_price;
+    stock->change_percent = rec->change_percent;
+    stock->volume = rec->volume;
+    stock->previous_close = rec->previous_close;
+    stock->day_high = rec->day_high;
+    stock->day_low = rec->day_low;
+    stock->market_cap = rec->market_cap;
+    stock->last_update = (time_t)rec->last_update;
+}
+
+int save_stocks_binary(Stock stocks[], int count, const char* filename) {
+    if (!stocks || count < 0) return 0;
+
+    AtomicFile af;
+    FILE* file = atomic_file_open(&af, filename);
+    if (!file) {
+        display_error("Failed to open binary stock file for writing.");
+        return 0;
+    }
+
+    StockSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STOCK_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = STOCK_SNAPSHOT_VERSION;
+    header.byte_order = STOCK_SNAPSHOT_BYTE_ORDER;
+    header.record_size = sizeof(StockRecord);
+    header.count = (uint64_t)count;
+    header.saved_at = (int64_t)time(NULL);
+
+    // Header goes first with a zero CRC and is rewritten once records are in
+    uLong crc = crc32(0L, Z_NULL, 0);
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; ok && i < count; i++) {
+        StockRecord rec;
+        stock_to_record(&stocks[i], &rec);
+        crc = crc32(crc, (const Bytef*)&rec, sizeof(rec));
+        ok = fwrite(&rec, sizeof(rec), 1, file) == 1;
+    }
+
+    header.crc32 = (uint32_t)crc;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    if (!ok) {
+        atomic_file_abort(&af);
+        display_error("Failed to write binary stock file.");
+        return 0;
+    }
+    return atomic_file_commit(&af);
+}
+
+int load_stocks_binary(Stock stocks[], int max_count, const char* filename) {
+    if (!stocks || max_count < 0) return -1;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(StockSnapshotHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    StockSnapshotHeader header;
+    memcpy(&header, map, sizeof(header));
+    const char* records = map + sizeof(header);
+    size_t records_size = size - sizeof(header);
+
+    int loaded = -1;
+    if (memcmp(header.magic, STOCK_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != STOCK_SNAPSHOT_VERSION || header.byte_order != STOCK_SNAPSHOT_BYTE_ORDER ||
+        header.record_size != sizeof(StockRecord) ||
+        header.count != records_size / sizeof(StockRecord) || records_size % sizeof(StockRecord) != 0) {
+        display_error("Binary stock file has an unsupported or damaged header.");
+    } else if (crc32(crc32(0L, Z_NULL, 0), (const Bytef*)records, (uInt)records_size) != header.crc32) {
+        display_error("Binary stock file failed its checksum.");
+    } else {
+        loaded = header.count < (uint64_t)max_count ? (int)header.count : max_count;
+        for (int i = 0; i < loaded; i++)
+            record_to_stock((const StockRecord*)(records + (size_t)i * sizeof(StockRecord)), &stocks[i]);
+    }
+
+    munmap((void*)map, size);
+    return loaded;
+}
+
+int count_stocks_binary(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return -1;
+
+    StockSnapshotHeader header;
+    int ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             memcmp(header.magic, STOCK_SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+             header.byte_order == STOCK_SNAPSHOT_BYTE_ORDER && header.count <= INT32_MAX;
+    fclose(file);
+    return ok ? (int)header.count : -1;
+}
+
+int convert_legacy_stock_file(const char* text_file, const char* binary_file) {
+    int capacity = 64, count = 0;
+    Stock* stocks = NULL;
+
+    // The text format has no header; grow until a read comes back short
+    for (;;) {
+        Stock* grown = realloc(stocks, capacity * sizeof(Stock));
+        if (!grown) {
+            free(stocks);
+            return -1;
+        }
+        stocks = grown;
+        memset(stocks, 0, capacity * sizeof(Stock));
+
+        count = load_stocks_from_file(stocks, capacity, text_file);
+        if (count < capacity) break;
+        capacity *= 2;
+    }
+
+    int ok = count > 0 && save_stocks_binary(stocks, count, binary_file);
+    free(stocks);
+    return ok ? count : -1;
+}
+
 // Generate JSON output file
 int generate_json_file(Stock stocks[], int count, const char* filename) {
-    FILE* file = fopen(filename, "w");
+    AtomicFile af;
+    FILE* file = atomic_file_open(&af, filename);
     if (!file) {
         display_error("Failed to create JSON file.");
         return 0;
@@ -65,11 +489,43 @@ int generate_json_file(Stock stocks[], int count, const char* filename) {
     }
     fprintf(file, "  ]\n}\n");
 
-    fclose(file);
+    if (!atomic_file_commit(&af)) {
+        display_error("Failed to write JSON file.");
+        return 0;
+    }
     display_success("JSON file generated successfully.");
     return 1;
 }
 
+// Read entire file into a heap string the caller frees
+char *read_file_to_string(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        display_error("Could not open file for reading.");
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size < 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    char *buffer = malloc(size + 1);
+    if (!buffer) {
+        fclose(file);
+        return NULL;
+    }
+
+    size_t read = fread(buffer, 1, size, file);
+    buffer[read] = '\0';
+    fclose(file);
+
+    return buffer;
+}
+
 // Log trading or fetch activity
 int log_trading_activity(const char* message, Stock* stock) {
     FILE* log_file = fopen("logs/activity.log", "a");
@@ -0,0 +1,353 @@
+/*
+ * Smart Stock Tracker - Streaming Technical Indicators
+ * Per-symbol state updated in constant time on every new quote:
+ *   SMA, Bollinger   rolling sum / rolling variance over a ring of prices
+ *   EMA              exponential smoothing, seeded with the first SMA
+ *   RSI, ATR         Wilder smoothing
+ *   VWAP             session sums, reset when the trading day changes
+ * Prices are per tick (one fetched quote); ATR uses the daily bar the
+ * quote carries (day high/low, previous close) so it stays a true range.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    time_t last_tick;
+    unsigned long ticks;
+
+    // Ring of the last `window_capacity` prices; head is the next slot
+    double *window;
+    unsigned int head;
+
+    double sma_sum;
+    double bb_mean, bb_m2;            // rolling mean and sum of squared deviations
+    double ema;
+
+    double prev_price;
+    double avg_gain, avg_loss;        // Wilder averages once rsi_seeded
+    int rsi_seeded;
+
+    int session_day;                  // days since epoch of the VWAP session
+    double session_volume;            // last cumulative volume seen
+    double pv_sum, volume_sum;
+
+    int atr_day;
+    double atr;                       // committed ATR through the previous day
+    unsigned long atr_days;
+} IndicatorState;
+
+static IndicatorConfig engine_config;
+static IndicatorState *states = NULL;
+static IndicatorValues *values = NULL;
+static double *windows = NULL;
+static unsigned int window_capacity = 0;
+static int state_count = 0;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+void indicators_config_defaults(IndicatorConfig *config) {
+    config->sma_period = INDICATOR_SMA_PERIOD;
+    config->ema_period = INDICATOR_EMA_PERIOD;
+    config->rsi_period = INDICATOR_RSI_PERIOD;
+    config->bollinger_period = INDICATOR_BOLLINGER_PERIOD;
+    config->bollinger_k = INDICATOR_BOLLINGER_K;
+    config->atr_period = INDICATOR_ATR_PERIOD;
+}
+
+int indicators_config_set(const char *key, const char *value, void *ctx) {
+    IndicatorConfig *config = ctx;
+    unsigned int *period = NULL;
+
+    if (strcmp(key, "sma_period") == 0) period = &config->sma_period;
+    else if (strcmp(key, "ema_period") == 0) period = &config->ema_period;
+    else if (strcmp(key, "rsi_period") == 0) period = &config->rsi_period;
+    else if (strcmp(key, "bollinger_period") == 0) period = &config->bollinger_period;
+    else if (strcmp(key, "atr_period") == 0) period = &config->atr_period;
+    else if (strcmp(key, "bollinger_k") == 0) {
+        char *end;
+        double k = strtod(value, &end);
+        if (end == value || *end != '\0' || !(k > 0 && k <= 10)) return 0;
+        config->bollinger_k = k;
+        return 1;
+    }
+    if (!period) return 0;
+
+    unsigned int parsed;
+    if (!config_parse_uint(value, INDICATOR_MAX_PERIOD, &parsed) || parsed == 0) return 0;
+    *period = parsed;
+    return 1;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+static void reset_state(IndicatorState *s, double *window) {
+    memset(s, 0, sizeof(*s));
+    s->window = window;
+    s->session_day = s->atr_day = -1;
+}
+
+static void reset_values(IndicatorValues *v) {
+    v->sma = v->ema = v->rsi = v->vwap = NAN;
+    v->bollinger_upper = v->bollinger_middle = v->bollinger_lower = v->stddev = NAN;
+    v->atr = NAN;
+    v->samples = 0;
+}
+
+int indicators_init(const IndicatorConfig *config, int count) {
+    indicators_free();
+    if (!config || count <= 0) return 0;
+
+    engine_config = *config;
+    window_capacity = config->sma_period > config->bollinger_period ? config->sma_period
+                                                                     : config->bollinger_period;
+
+    // One block for every symbol's ring keeps the state dense
+    states = calloc(count, sizeof(IndicatorState));
+    values = malloc(count * sizeof(IndicatorValues));
+    windows = calloc((size_t)count * window_capacity, sizeof(double));
+    if (!states || !values || !windows) {
+        indicators_free();
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        reset_state(&states[i], windows + (size_t)i * window_capacity);
+        reset_values(&values[i]);
+    }
+    state_count = count;
+    return 1;
+}
+
+int indicators_reserve(int count) {
+    if (count <= state_count) return 1;
+    if (!states) return 0;
+
+    int grown = state_count;
+    while (grown < count) grown *= 2;
+
+    IndicatorState *new_states = realloc(states, grown * sizeof(IndicatorState));
+    if (!new_states) return 0;
+    states = new_states;
+    IndicatorValues *new_values = realloc(values, grown * sizeof(IndicatorValues));
+    if (!new_values) return 0;
+    values = new_values;
+    double *new_windows = realloc(windows, (size_t)grown * window_capacity * sizeof(double));
+    if (!new_windows) return 0;
+    windows = new_windows;
+
+    // The rings moved with the block
+    for (int i = 0; i < grown; i++) {
+        double *window = windows + (size_t)i * window_capacity;
+        if (i < state_count) {
+            states[i].window = window;
+        } else {
+            reset_state(&states[i], window);
+            reset_values(&values[i]);
+        }
+    }
+    state_count = grown;
+    return 1;
+}
+
+void indicators_move(int from, int to) {
+    if (from < 0 || to < 0 || from >= state_count || to >= state_count || from == to) return;
+
+    double *window = states[to].window;
+    memcpy(window, states[from].window, window_capacity * sizeof(double));
+    states[to] = states[from];
+    states[to].window = window;
+    values[to] = values[from];
+
+    // Whatever lands in `from` next starts from scratch
+    reset_state(&states[from], states[from].window);
+    reset_values(&values[from]);
+}
+
+void indicators_free(void) {
+    free(states);
+    free(values);
+    free(windows);
+    states = NULL;
+    values = NULL;
+    windows = NULL;
+    state_count = 0;
+}
+
+// ============================================================================
+// O(1) update per tick
+// ============================================================================
+// Price `back` ticks before the newest stored one (0 = previous tick)
+static double window_at(const IndicatorState *s, unsigned int back) {
+    return s->window[(s->head + window_capacity - 1 - back) % window_capacity];
+}
+
+static void update_sma(IndicatorState *s, IndicatorValues *v, double price) {
+    unsigned int n = engine_config.sma_period;
+    s->sma_sum += price;
+    if (s->ticks > n) s->sma_sum -= window_at(s, n - 1);
+    if (s->ticks >= n) v->sma = s->sma_sum / n;
+}
+
+// Rolling mean/variance: Welford while filling, then replace the price that
+// leaves the window in one step (no sum-of-squares cancellation)
+static void update_bollinger(IndicatorState *s, IndicatorValues *v, double price) {
+    unsigned int n = engine_config.bollinger_period;
+    if (s->ticks <= n) {
+        double delta = price - s->bb_mean;
+        s->bb_mean += delta / s->ticks;
+        s->bb_m2 += delta * (price - s->bb_mean);
+    } else {
+        double old = window_at(s, n - 1);
+        double old_mean = s->bb_mean;
+        s->bb_mean += (price - old) / n;
+        s->bb_m2 += (price - old) * (price - s->bb_mean + old - old_mean);
+        if (s->bb_m2 < 0) s->bb_m2 = 0;  // rounding
+    }
+    if (s->ticks < n) return;
+
+    double stddev = sqrt(s->bb_m2 / n);
+    v->stddev = stddev;
+    v->bollinger_middle = s->bb_mean;
+    v->bollinger_upper = s->bb_mean + engine_config.bollinger_k * stddev;
+    v->bollinger_lower = s->bb_mean - engine_config.bollinger_k * stddev;
+}
+
+static void update_ema(IndicatorState *s, IndicatorValues *v, double price) {
+    unsigned int n = engine_config.ema_period;
+    if (s->ticks < n) {
+        s->ema += price;                  // accumulate the seed SMA
+        return;
+    }
+    if (s->ticks == n) {
+        s->ema = (s->ema + price) / n;
+    } else {
+        double alpha = 2.0 / (n + 1.0);
+        s->ema += alpha * (price - s->ema);
+    }
+    v->ema = s->ema;
+}
+
+static void update_rsi(IndicatorState *s, IndicatorValues *v, double price) {
+    if (s->ticks < 2) return;
+
+    unsigned int n = engine_config.rsi_period;
+    double change = price - s->prev_price;
+    double gain = change > 0 ? change : 0;
+    double loss = change < 0 ? -change : 0;
+    unsigned long changes = s->ticks - 1;
+
+    if (!s->rsi_seeded) {
+        s->avg_gain += gain;              // simple average of the first n changes
+        s->avg_loss += loss;
+        if (changes < n) return;
+        s->avg_gain /= n;
+        s->avg_loss /= n;
+        s->rsi_seeded = 1;
+    } else {
+        s->avg_gain = (s->avg_gain * (n - 1) + gain) / n;
+        s->avg_loss = (s->avg_loss * (n - 1) + loss) / n;
+    }
+
+    if (s->avg_loss == 0) v->rsi = s->avg_gain == 0 ? 50.0 : 100.0;
+    else v->rsi = 100.0 - 100.0 / (1.0 + s->avg_gain / s->avg_loss);
+}
+
+// Quotes carry the day's cumulative volume; each tick trades the increase
+static void update_vwap(IndicatorState *s, IndicatorValues *v, const Stock *stock, int day) {
+    if (day != s->session_day || stock->volume < s->session_volume) {
+        s->session_day = day;
+        s->pv_sum = s->volume_sum = 0;
+        s->session_volume = 0;
+    }
+
+    double traded = stock->volume - s->session_volume;
+    s->session_volume = stock->volume;
+    if (traded > 0) {
+        s->pv_sum += stock->current_price * traded;
+        s->volume_sum += traded;
+    }
+    if (s->volume_sum > 0) v->vwap = s->pv_sum / s->volume_sum;
+}
+
+// Wilder ATR over daily bars; today's bar is provisional until the day rolls
+static void update_atr(IndicatorState *s, IndicatorValues *v, const Stock *stock, int day) {
+    if (stock->day_high <= 0 || stock->day_low <= 0) return;
+
+    double range = stock->day_high - stock->day_low;
+    if (stock->previous_close > 0) {
+        double up = fabs(stock->day_high - stock->previous_close);
+        double down = fabs(stock->day_low - stock->previous_close);
+        if (up > range) range = up;
+        if (down > range) range = down;
+    }
+
+    unsigned int n = engine_config.atr_period;
+    if (day != s->atr_day) {
+        // Commit yesterday's provisional value before starting a new bar
+        if (s->atr_day >= 0) {
+            s->atr = v->atr;
+            s->atr_days++;
+        }
+        s->atr_day = day;
+    }
+
+    if (s->atr_days == 0) v->atr = range;
+    else if (s->atr_days < n) v->atr = (s->atr * s->atr_days + range) / (s->atr_days + 1);
+    else v->atr = (s->atr * (n - 1) + range) / n;
+}
+
+int indicators_update(int index, const Stock *stock) {
+    if (index < 0 || index >= state_count || !stock || stock->current_price <= 0) return 0;
+
+    IndicatorState *s = &states[index];
+    IndicatorValues *v = &values[index];
+
+    // Same quote as last time: nothing new to add
+    if (stock->last_update != 0 && stock->last_update <= s->last_tick) return 0;
+    if (strcmp(s->symbol, stock->symbol) != 0) {
+        reset_state(s, s->window);
+        snprintf(s->symbol, sizeof(s->symbol), "%s", stock->symbol);
+        reset_values(v);
+    }
+    s->last_tick = stock->last_update;
+
+    double price = stock->current_price;
+    int day = (int)(stock->last_update / 86400);
+
+    s->ticks++;
+    update_sma(s, v, price);
+    update_bollinger(s, v, price);
+    update_ema(s, v, price);
+    update_rsi(s, v, price);
+    update_vwap(s, v, stock, day);
+    update_atr(s, v, stock, day);
+
+    // The oldest price has been used by the rolling windows; overwrite it
+    s->window[s->head] = price;
+    s->head = (s->head + 1) % window_capacity;
+    s->prev_price = price;
+    v->samples = s->ticks;
+    return 1;
+}
+
+int indicators_update_all(const Stock stocks[], int count) {
+    int updated = 0;
+    for (int i = 0; i < count && i < state_count; i++)
+        updated += indicators_update(i, &stocks[i]);
+    return updated;
+}
+
+const IndicatorValues *indicators_values(void) {
+    return values;
+}
+
+const IndicatorValues *indicators_lookup(const char *symbol) {
+    // Slots follow the registry, so its index finds the slot directly
+    int slot = registry_find(symbol);
+    if (slot < 0 || slot >= state_count || strcmp(states[slot].symbol, symbol) != 0) return NULL;
+    return &values[slot];
+}
@@ -1,66 +1,478 @@
-#include <stdio.h>
-#include <json-c/json.h>
-#include "stock_tracker.h"
-
-void write_all_stocks_json(Stock stocks[], int count, const char* filename) {
-    struct json_object* jarray = json_object_new_array();
-
-    for (int i = 0; i < count; i++) {
-        // Skip invalid or empty stocks
-        if (stocks[i].current_price <= 0) continue;
-
-        struct json_object* jobj = json_object_new_object();
-        json_object_object_add(jobj, "symbol", json_object_new_string(stocks[i].symbol));
-        json_object_object_add(jobj, "price", json_object_new_double(stocks[i].current_price));
-        json_object_object_add(jobj, "change_percent", json_object_new_double(stocks[i].change_percent));
-        json_object_array_add(jarray, jobj);
-    }
-
-    FILE* fp = fopen(filename, "w");
-    if (fp) {
-        fputs(json_object_to_json_string_ext(jarray, JSON_C_TO_STRING_PRETTY), fp);
-        fclose(fp);
-    }
-
-    json_object_put(jarray);
-}
-
-void write_best_stock_json(Stock* best, const char* filename) {
-    struct json_object* jobj = json_object_new_object();
-
-    if (best != NULL) {
-        json_object_object_add(jobj, "symbol", json_object_new_string(best->symbol));
-        json_object_object_add(jobj, "price", json_object_new_double(best->current_price));
-        json_object_object_add(jobj, "change_percent", json_object_new_double(best->change_percent));
-    }
-
-    FILE* fp = fopen(filename, "w");
-    if (fp) {
-        fputs(json_object_to_json_string_ext(jobj, JSON_C_TO_STRING_PRETTY), fp);
-        fclose(fp);
-    }
-
-    json_object_put(jobj);
-}
-
-void write_trending_json(Stock stocks[], int count, const char* filename) {
-    struct json_object* jarray = json_object_new_array();
-
-    for (int i = 0; i < count; i++) {
-        if (stocks[i].current_price <= 0) continue;
-
-        struct json_object* jobj = json_object_new_object();
-        json_object_object_add(jobj, "symbol", json_object_new_string(stocks[i].symbol));
-        json_object_object_add(jobj, "price", json_object_new_double(stocks[i].current_price));
-        json_object_object_add(jobj, "change_percent", json_object_new_double(stocks[i].change_percent));
-        json_object_array_add(jarray, jobj);
-    }
-
-    FILE* fp = fopen(filename, "w");
-    if (fp) {
-        fputs(json_object_to_json_string_ext(jarray, JSON_C_TO_STRING_PRETTY), fp);
-        fclose(fp);
-    }
-
-    json_object_put(jarray);
-}
+#include <stdio.h>
+#include <math.h>
+#include "stock_tracker.h"
+
+// ---------------------------------------------------------------------------
+// Streaming writer: formats straight into one growable buffer. The pretty
+// layout matches what json-c's JSON_C_TO_STRING_PRETTY produced (two-space
+// indent, "key":value, "[\n]" for empty containers).
+// ---------------------------------------------------------------------------
+static int json_reserve(JsonWriter* w, size_t extra) {
+    if (w->failed) return 0;
+    if (w->size + extra + 1 <= w->capacity) return 1;
+    if (w->fixed) {
+        w->failed = 1;
+        return 0;
+    }
+
+    size_t capacity = w->capacity ? w->capacity : 256;
+    while (capacity < w->size + extra + 1) capacity *= 2;
+
+    char* data = realloc(w->data, capacity);
+    if (!data) {
+        w->failed = 1;
+        return 0;
+    }
+    w->data = data;
+    w->capacity = capacity;
+    return 1;
+}
+
+static void json_append(JsonWriter* w, const char* text, size_t len) {
+    if (!json_reserve(w, len)) return;
+    memcpy(w->data + w->size, text, len);
+    w->size += len;
+    w->data[w->size] = '\0';
+}
+
+static void json_indent(JsonWriter* w, int level) {
+    if (!w->pretty || !json_reserve(w, (size_t)level * 2)) return;
+    memset(w->data + w->size, ' ', (size_t)level * 2);
+    w->size += (size_t)level * 2;
+    w->data[w->size] = '\0';
+}
+
+// Separator and indentation ahead of an array element or object key
+static void json_next_item(JsonWriter* w) {
+    if (w->after_key) {
+        w->after_key = 0;
+        return;
+    }
+    if (w->depth == 0) return;
+
+    if (w->has_items[w->depth - 1]) json_append(w, w->pretty ? ",\n" : ",", w->pretty ? 2 : 1);
+    w->has_items[w->depth - 1] = 1;
+    json_indent(w, w->depth);
+}
+
+static void json_open(JsonWriter* w, char bracket) {
+    json_next_item(w);
+    if (w->depth >= JSON_MAX_DEPTH) {
+        w->failed = 1;
+        return;
+    }
+    char open[2] = { bracket, '\n' };
+    json_append(w, open, w->pretty ? 2 : 1);
+    w->has_items[w->depth++] = 0;
+}
+
+static void json_close(JsonWriter* w, char bracket) {
+    if (w->depth == 0) {
+        w->failed = 1;
+        return;
+    }
+    int had_items = w->has_items[--w->depth];
+    if (w->pretty && had_items) json_append(w, "\n", 1);
+    json_indent(w, w->depth);
+    json_append(w, &bracket, 1);
+}
+
+void json_writer_init(JsonWriter* w, int pretty, size_t size_hint) {
+    memset(w, 0, sizeof(*w));
+    w->pretty = pretty;
+    if (size_hint) json_reserve(w, size_hint);
+}
+
+void json_writer_init_fixed(JsonWriter* w, char* buffer, size_t capacity, int pretty) {
+    memset(w, 0, sizeof(*w));
+    w->pretty = pretty;
+    w->fixed = 1;
+    w->data = buffer;
+    w->capacity = capacity;
+    if (capacity) buffer[0] = '\0';
+    else w->failed = 1;
+}
+
+void json_writer_reset(JsonWriter* w) {
+    w->size = 0;
+    w->depth = 0;
+    w->after_key = 0;
+    w->failed = 0;
+    if (w->data) w->data[0] = '\0';
+}
+
+char* json_writer_finish(JsonWriter* w, size_t* size) {
+    if (w->fixed) {
+        if (w->failed || w->depth != 0) return NULL;
+        if (size) *size = w->size;
+        return w->data;
+    }
+    if (w->failed || w->depth != 0 || !json_reserve(w, 0)) {
+        free(w->data);
+        w->data = NULL;
+        return NULL;
+    }
+
+    char* text = w->data;
+    if (size) *size = w->size;
+    w->data = NULL;
+    w->size = w->capacity = 0;
+    return text;
+}
+
+void json_writer_free(JsonWriter* w) {
+    if (!w->fixed) free(w->data);
+    memset(w, 0, sizeof(*w));
+}
+
+void json_begin_object(JsonWriter* w) { json_open(w, '{'); }
+void json_end_object(JsonWriter* w) { json_close(w, '}'); }
+void json_begin_array(JsonWriter* w) { json_open(w, '['); }
+void json_end_array(JsonWriter* w) { json_close(w, ']'); }
+
+void json_write_string(JsonWriter* w, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+
+    json_next_item(w);
+    json_append(w, "\"", 1);
+    for (const char* p = text ? text : ""; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        const char* escape = NULL;
+        switch (c) {
+        case '"': escape = "\\\""; break;
+        case '\\': escape = "\\\\"; break;
+        case '/': escape = "\\/"; break;
+        case '\b': escape = "\\b"; break;
+        case '\f': escape = "\\f"; break;
+        case '\n': escape = "\\n"; break;
+        case '\r': escape = "\\r"; break;
+        case '\t': escape = "\\t"; break;
+        }
+        if (escape) {
+            json_append(w, escape, 2);
+        } else if (c < 0x20) {
+            char unicode[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+            json_append(w, unicode, sizeof(unicode));
+        } else {
+            // Copy the run of plain bytes in one go
+            const char* run = p;
+            while (p[1] && (unsigned char)p[1] >= 0x20 && p[1] != '"' && p[1] != '\\' && p[1] != '/')
+                p++;
+            json_append(w, run, (size_t)(p - run + 1));
+        }
+    }
+    json_append(w, "\"", 1);
+}
+
+void json_write_key(JsonWriter* w, const char* key) {
+    json_write_string(w, key);
+    json_append(w, ":", 1);
+    w->after_key = 1;
+}
+
+void json_write_double(JsonWriter* w, double value) {
+    char buf[JSON_DOUBLE_BUFSIZE];
+    size_t len = json_format_double(value, buf);
+    json_next_item(w);
+    json_append(w, buf, len);
+}
+
+void json_write_int(JsonWriter* w, long long value) {
+    char buf[24];
+    int len = snprintf(buf, sizeof(buf), "%lld", value);
+    json_next_item(w);
+    json_append(w, buf, (size_t)len);
+}
+
+void json_write_null(JsonWriter* w) {
+    json_next_item(w);
+    json_append(w, "null", 4);
+}
+
+// ---------------------------------------------------------------------------
+// Shortest round-trip doubles. Prices are short decimals, so first look for
+// an exact n / 10^d with few digits (one division, correctly rounded); fall
+// back to the shortest of %.15g/%.16g/%.17g that parses back to the value.
+// Integral values get ".0" so they still read as doubles.
+// ---------------------------------------------------------------------------
+static size_t format_fixed_digits(unsigned long long n, int decimals, int negative, char* out) {
+    char digits[24];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + n % 10);
+        n /= 10;
+    } while (n);
+    while (len <= decimals) digits[len++] = '0';  // leading "0." for values below 1
+
+    size_t pos = 0;
+    if (negative) out[pos++] = '-';
+    for (int i = len - 1; i >= 0; i--) {
+        out[pos++] = digits[i];
+        if (i == decimals && decimals > 0) out[pos++] = '.';
+    }
+    if (decimals == 0) {
+        out[pos++] = '.';
+        out[pos++] = '0';
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+size_t json_format_double(double value, char out[JSON_DOUBLE_BUFSIZE]) {
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+    if (isnan(value)) return (size_t)snprintf(out, JSON_DOUBLE_BUFSIZE, "NaN");
+    if (isinf(value)) return (size_t)snprintf(out, JSON_DOUBLE_BUFSIZE, value < 0 ? "-Infinity" : "Infinity");
+
+    double magnitude = fabs(value);
+    if (magnitude == 0.0) return format_fixed_digits(0, 0, signbit(value) != 0, out);
+
+    // Same range %g prints without an exponent
+    if (magnitude >= 1e-4 && magnitude < 1e15) {
+        for (int d = 0; d < 10; d++) {
+            double scaled = magnitude * pow10[d];
+            if (scaled >= 9007199254740992.0) break;  // 2^53: n no longer exact
+            unsigned long long n = (unsigned long long)(scaled + 0.5);
+            if ((double)n / pow10[d] == magnitude)
+                return format_fixed_digits(n, d, value < 0, out);
+        }
+    }
+
+    int len = 0;
+    for (int precision = 15; precision <= 17; precision++) {
+        len = snprintf(out, JSON_DOUBLE_BUFSIZE, "%.*g", precision, value);
+        if (strtod(out, NULL) == value) break;
+    }
+    if (!strchr(out, '.') && !strchr(out, 'e') && len + 2 < JSON_DOUBLE_BUFSIZE) {
+        memcpy(out + len, ".0", 3);
+        len += 2;
+    }
+    return (size_t)len;
+}
+
+// ---------------------------------------------------------------------------
+// Stock documents
+// ---------------------------------------------------------------------------
+// Rough bytes per pretty-printed row, so most documents need one allocation
+#define JSON_ROW_SIZE_HINT 96
+
+// Indicator values are NAN until warmed up; those go out as null
+static void write_indicator(JsonWriter* w, const char* key, double value) {
+    json_write_key(w, key);
+    if (isnan(value)) json_write_null(w);
+    else json_write_double(w, value);
+}
+
+static void write_indicators(JsonWriter* w, const IndicatorValues* v) {
+    json_write_key(w, "indicators");
+    json_begin_object(w);
+    write_indicator(w, "sma", v->sma);
+    write_indicator(w, "ema", v->ema);
+    write_indicator(w, "rsi", v->rsi);
+    write_indicator(w, "vwap", v->vwap);
+    json_write_key(w, "bollinger");
+    json_begin_object(w);
+    write_indicator(w, "upper", v->bollinger_upper);
+    write_indicator(w, "middle", v->bollinger_middle);
+    write_indicator(w, "lower", v->bollinger_lower);
+    json_end_object(w);
+    write_indicator(w, "atr", v->atr);
+    json_end_object(w);
+}
+
+static void write_stock_row(JsonWriter* w, const Stock* stock, const IndicatorValues* indicators) {
+    json_begin_object(w);
+    json_write_key(w, "symbol");
+    json_write_string(w, stock->symbol);
+    json_write_key(w, "price");
+    json_write_double(w, stock->current_price);
+    json_write_key(w, "change_percent");
+    json_write_double(w, stock->change_percent);
+    if (indicators) write_indicators(w, indicators);
+    json_end_object(w);
+}
+
+static char* build_stock_array(Stock stocks[], int count, const IndicatorValues indicators[], int pretty) {
+    size_t row_hint = indicators ? JSON_ROW_SIZE_HINT * 4 : JSON_ROW_SIZE_HINT;
+    JsonWriter w;
+    json_writer_init(&w, pretty, (size_t)(count > 0 ? count : 0) * row_hint + 16);
+
+    json_begin_array(&w);
+    for (int i = 0; i < count; i++) {
+        // Skip invalid or empty stocks
+        if (stocks[i].current_price <= 0) continue;
+        write_stock_row(&w, &stocks[i], indicators ? &indicators[i] : NULL);
+    }
+    json_end_array(&w);
+
+    return json_writer_finish(&w, NULL);
+}
+
+static int write_string_to_file(const char* text, const char* filename) {
+    if (!text) return 0;
+    return write_file_atomic(filename, text, strlen(text));
+}
+
+// ---------------------------------------------------------------------------
+// Quote projection: any subset of a row's fields, in a fixed order
+// ---------------------------------------------------------------------------
+static const char* quote_field_names[QUOTE_FIELD_COUNT] = {
+    "name", "price", "change_percent", "volume", "previous_close", "day_high",
+    "day_low", "status", "last_update", "rank", "indicators"
+};
+
+int quote_fields_parse(const char* list, unsigned int* mask) {
+    unsigned int fields = 0;
+    while (list && *list) {
+        const char* end = strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : strlen(list);
+        if (len > 0) {
+            int field = 0;
+            while (field < QUOTE_FIELD_COUNT &&
+                   (strncmp(quote_field_names[field], list, len) != 0 ||
+                    quote_field_names[field][len] != '\0'))
+                field++;
+            if (field == QUOTE_FIELD_COUNT) return 0;
+            fields |= 1u << field;
+        }
+        list = end ? end + 1 : NULL;
+    }
+    if (!fields) return 0;
+    *mask = fields;
+    return 1;
+}
+
+void json_write_quote(JsonWriter* w, const Stock* stock, const IndicatorValues* indicators,
+                      int rank, unsigned int fields) {
+    json_begin_object(w);
+    json_write_key(w, "symbol");
+    json_write_string(w, stock->symbol);
+    if (fields & (1u << QUOTE_FIELD_NAME)) {
+        json_write_key(w, "name");
+        json_write_string(w, stock->name);
+    }
+    if (fields & (1u << QUOTE_FIELD_PRICE)) {
+        json_write_key(w, "price");
+        json_write_double(w, stock->current_price);
+    }
+    if (fields & (1u << QUOTE_FIELD_CHANGE_PERCENT)) {
+        json_write_key(w, "change_percent");
+        json_write_double(w, stock->change_percent);
+    }
+    if (fields & (1u << QUOTE_FIELD_VOLUME)) {
+        json_write_key(w, "volume");
+        json_write_double(w, stock->volume);
+    }
+    if (fields & (1u << QUOTE_FIELD_PREVIOUS_CLOSE)) {
+        json_write_key(w, "previous_close");
+        json_write_double(w, stock->previous_close);
+    }
+    if (fields & (1u << QUOTE_FIELD_DAY_HIGH)) {
+        json_write_key(w, "day_high");
+        json_write_double(w, stock->day_high);
+    }
+    if (fields & (1u << QUOTE_FIELD_DAY_LOW)) {
+        json_write_key(w, "day_low");
+        json_write_double(w, stock->day_low);
+    }
+    if (fields & (1u << QUOTE_FIELD_STATUS)) {
+        json_write_key(w, "status");
+        json_write_string(w, stock_status_label((StockStatus)stock->status));
+    }
+    if (fields & (1u << QUOTE_FIELD_LAST_UPDATE)) {
+        json_write_key(w, "last_update");
+        json_write_int(w, (long long)stock->last_update);
+    }
+    if (fields & (1u << QUOTE_FIELD_RANK)) {
+        json_write_key(w, "rank");
+        if (rank > 0) json_write_int(w, rank);
+        else json_write_null(w);
+    }
+    if ((fields & (1u << QUOTE_FIELD_INDICATORS)) && indicators) write_indicators(w, indicators);
+    json_end_object(w);
+}
+
+char* build_all_stocks_json(Stock stocks[], int count, const IndicatorValues indicators[]) {
+    return build_stock_array(stocks, count, indicators, 1);
+}
+
+char* build_best_stock_json(Stock* best, const IndicatorValues* indicators) {
+    JsonWriter w;
+    json_writer_init(&w, 1, JSON_ROW_SIZE_HINT * 4);
+
+    if (best != NULL) {
+        write_stock_row(&w, best, indicators);
+    } else {
+        json_begin_object(&w);
+        json_end_object(&w);
+    }
+
+    return json_writer_finish(&w, NULL);
+}
+
+char* build_trending_json(Stock stocks[], const int rows[], int row_count,
+                          const IndicatorValues indicators[]) {
+    size_t row_hint = indicators ? JSON_ROW_SIZE_HINT * 4 : JSON_ROW_SIZE_HINT;
+    JsonWriter w;
+    json_writer_init(&w, 1, (size_t)(row_count > 0 ? row_count : 0) * row_hint + 16);
+
+    json_begin_array(&w);
+    for (int i = 0; i < row_count; i++) {
+        int row = rows[i];
+        write_stock_row(&w, &stocks[row], indicators ? &indicators[row] : NULL);
+    }
+    json_end_array(&w);
+
+    return json_writer_finish(&w, NULL);
+}
+
+char* build_stream_json(Stock stocks[], int count, const Stock prev[], const int prev_row[]) {
+    if (!prev) {
+        // SSE data lines cannot contain newlines, so always compact
+        return build_stock_array(stocks, count, NULL, 0);
+    }
+
+    JsonWriter w;
+    json_writer_init(&w, 0, 0);
+    int rows = 0;
+
+    json_begin_array(&w);
+    for (int i = 0; i < count; i++) {
+        if (stocks[i].current_price <= 0) continue;
+
+        const Stock* old = prev_row[i] >= 0 ? &prev[prev_row[i]] : NULL;
+        if (old && old->current_price == stocks[i].current_price &&
+            old->change_percent == stocks[i].change_percent)
+            continue;
+
+        write_stock_row(&w, &stocks[i], NULL);
+        rows++;
+    }
+    json_end_array(&w);
+
+    if (rows == 0) {
+        json_writer_free(&w);
+        return NULL;
+    }
+    return json_writer_finish(&w, NULL);
+}
+
+void write_all_stocks_json(Stock stocks[], int count, const char* filename) {
+    char* text = build_all_stocks_json(stocks, count, NULL);
+    write_string_to_file(text, filename);
+    free(text);
+}
+
+void write_best_stock_json(Stock* best, const char* filename) {
+    char* text = build_best_stock_json(best, NULL);
+    write_string_to_file(text, filename);
+    free(text);
+}
+
+void write_trending_json(Stock stocks[], int count, const char* filename) {
+    MarketSummary summary;
+    market_summary_compute(stocks, count, &summary);
+    char* text = build_trending_json(stocks, summary.top, summary.top_count, NULL);
+    write_string_to_file(text, filename);
+    free(text);
+}
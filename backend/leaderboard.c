@@ -0,0 +1,438 @@
+/*
+ * Smart Stock Tracker - Live Leaderboard
+ * An indexed skip list ordered by change percent (largest first, ties by
+ * row). Every link records how many rows it skips, so a quote moves to its
+ * new position, a symbol finds its rank and the K-th row is reached in
+ * O(log n); best, worst and the top or bottom K are read straight off the
+ * ends of the list. Updates arrive one quote at a time from the refresher
+ * while the HTTP threads read without locking: each write is bracketed by
+ * a sequence lock and readers redo their copy if one got in between, while
+ * epochs keep unlinked nodes and replaced tables alive until no reader can
+ * still be walking them.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <math.h>
+#include <pthread.h>
+
+#define LEADERBOARD_MAX_LEVEL 24
+#define LEADERBOARD_INITIAL_SLOTS 64
+
+typedef struct LeaderNode LeaderNode;
+
+typedef struct {
+    LeaderNode *next;
+    int span;                                // rows passed by following next
+} LeaderLink;
+
+struct LeaderNode {
+    double change;
+    int row;
+    int level;                               // number of links, fixed at allocation
+    LeaderNode *prev;                        // level-0 back link, for the bottom rows
+    Stock stock;
+    IndicatorValues indicators;
+    LeaderLink links[];
+};
+
+// Row -> node, NULL when the row is not ranked; replaced whole when it grows
+typedef struct {
+    int capacity;
+    LeaderNode *at[];
+} NodeTable;
+
+// Symbol -> row, open addressing (row + 1, 0 = empty). Entries are never
+// deleted; one whose row no longer carries the symbol is skipped and
+// dropped at the next rebuild, which replaces the whole index.
+typedef struct {
+    int count;
+    int used;
+    int slots[];
+} SymbolIndex;
+
+static LeaderNode *head = NULL;              // sentinel with LEADERBOARD_MAX_LEVEL links
+static LeaderNode *tail = NULL;
+static int level = 1;
+static int length = 0;
+static NodeTable *node_table = NULL;
+static SymbolIndex *symbol_index = NULL;
+static unsigned long version = 0;
+static int has_indicators = 0;
+static uint32_t level_seed = 2463534242u;
+
+// Writers serialize on the mutex; readers only watch the sequence
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static SeqLock board_seq = { 0 };
+
+// Shared pointers are loaded and stored whole; readers may race a writer
+// and then retry, but never see a torn link
+static LeaderNode *load_ptr(LeaderNode *const *ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static void store_ptr(LeaderNode **ptr, LeaderNode *value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+static LeaderNode *row_node(int row) {
+    NodeTable *table = __atomic_load_n(&node_table, __ATOMIC_ACQUIRE);
+    return table && row >= 0 && row < table->capacity ? load_ptr(&table->at[row]) : NULL;
+}
+
+// ============================================================================
+// Symbol index
+// ============================================================================
+static uint32_t hash_symbol(const char *symbol) {
+    uint32_t hash = 2166136261u;
+    for (; *symbol; symbol++) {
+        hash ^= (unsigned char)*symbol;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Bounded compare: a reader may see a symbol half overwritten
+static int symbol_matches(int row, const char *symbol) {
+    const LeaderNode *node = row_node(row);
+    return node && strncmp(node->stock.symbol, symbol, sizeof(node->stock.symbol)) == 0;
+}
+
+static int find_row(const char *symbol) {
+    const SymbolIndex *index = __atomic_load_n(&symbol_index, __ATOMIC_ACQUIRE);
+    if (!index) return -1;
+    int mask = index->count - 1;
+    int slot = hash_symbol(symbol) & mask;
+    for (int probes = 0; probes < index->count; probes++, slot = (slot + 1) & mask) {
+        int entry = __atomic_load_n(&index->slots[slot], __ATOMIC_RELAXED);
+        if (!entry) break;
+        if (symbol_matches(entry - 1, symbol)) return entry - 1;
+    }
+    return -1;
+}
+
+static void place_symbol(SymbolIndex *index, const char *symbol, int row) {
+    int mask = index->count - 1;
+    int slot = hash_symbol(symbol) & mask;
+    while (index->slots[slot]) slot = (slot + 1) & mask;
+    __atomic_store_n(&index->slots[slot], row + 1, __ATOMIC_RELAXED);
+    index->used++;
+}
+
+// Rebuild from the ranked rows only, at least twice their number of slots
+static int rebuild_symbols(void) {
+    int count = LEADERBOARD_INITIAL_SLOTS;
+    while (count < 4 * (length + 1)) count *= 2;
+    SymbolIndex *index = calloc(1, sizeof(SymbolIndex) + count * sizeof(int));
+    if (!index) return 0;
+    index->count = count;
+
+    for (LeaderNode *node = head->links[0].next; node; node = node->links[0].next)
+        place_symbol(index, node->stock.symbol, node->row);
+    SymbolIndex *old = __atomic_exchange_n(&symbol_index, index, __ATOMIC_ACQ_REL);
+    epoch_retire(old, free);
+    return 1;
+}
+
+static void index_symbol(const char *symbol, int row) {
+    if (find_row(symbol) == row) return;
+    if (2 * (symbol_index->used + 1) > symbol_index->count && !rebuild_symbols()) return;
+    if (find_row(symbol) == row) return;     // the rebuild already placed it
+    place_symbol(symbol_index, symbol, row);
+}
+
+// ============================================================================
+// Skip list
+// ============================================================================
+// Does `a` rank ahead of (change, row)?
+static int ranks_ahead(const LeaderNode *a, double change, int row) {
+    if (a->change != change) return a->change > change;
+    return a->row < row;
+}
+
+// Geometric levels with p = 1/4 (xorshift32)
+static int random_level(void) {
+    int lvl = 1;
+    for (;;) {
+        level_seed ^= level_seed << 13;
+        level_seed ^= level_seed >> 17;
+        level_seed ^= level_seed << 5;
+        if ((level_seed & 3) != 0 || lvl == LEADERBOARD_MAX_LEVEL) return lvl;
+        lvl++;
+    }
+}
+
+static LeaderNode *alloc_node(int lvl) {
+    LeaderNode *node = calloc(1, sizeof(LeaderNode) + lvl * sizeof(LeaderLink));
+    if (node) node->level = lvl;
+    return node;
+}
+
+static void link_node(LeaderNode *node) {
+    LeaderNode *update[LEADERBOARD_MAX_LEVEL];
+    int rank[LEADERBOARD_MAX_LEVEL];
+    LeaderNode *x = head;
+
+    for (int i = level - 1; i >= 0; i--) {
+        rank[i] = i == level - 1 ? 0 : rank[i + 1];
+        while (x->links[i].next && ranks_ahead(x->links[i].next, node->change, node->row)) {
+            rank[i] += x->links[i].span;
+            x = x->links[i].next;
+        }
+        update[i] = x;
+    }
+    if (node->level > level) {
+        for (int i = level; i < node->level; i++) {
+            rank[i] = 0;
+            update[i] = head;
+            head->links[i].span = length;
+        }
+        level = node->level;
+    }
+
+    for (int i = 0; i < node->level; i++) {
+        store_ptr(&node->links[i].next, update[i]->links[i].next);
+        store_ptr(&update[i]->links[i].next, node);
+        node->links[i].span = update[i]->links[i].span - (rank[0] - rank[i]);
+        update[i]->links[i].span = rank[0] - rank[i] + 1;
+    }
+    for (int i = node->level; i < level; i++)
+        update[i]->links[i].span++;
+
+    store_ptr(&node->prev, update[0] == head ? NULL : update[0]);
+    if (node->links[0].next) store_ptr(&node->links[0].next->prev, node);
+    else store_ptr(&tail, node);
+    length++;
+}
+
+static void unlink_node(LeaderNode *node) {
+    LeaderNode *x = head;
+    for (int i = level - 1; i >= 0; i--) {
+        while (x->links[i].next && ranks_ahead(x->links[i].next, node->change, node->row))
+            x = x->links[i].next;
+        if (x->links[i].next == node) {
+            x->links[i].span += node->links[i].span - 1;
+            store_ptr(&x->links[i].next, node->links[i].next);
+        } else {
+            x->links[i].span--;
+        }
+    }
+
+    if (node->links[0].next) store_ptr(&node->links[0].next->prev, node->prev);
+    else store_ptr(&tail, node->prev);
+    while (level > 1 && !head->links[level - 1].next) level--;
+    length--;
+}
+
+// Grow by copying into a new table; readers may still be indexing the old one
+static int reserve_rows(int row) {
+    int old_capacity = node_table ? node_table->capacity : 0;
+    if (row < old_capacity) return 1;
+    int capacity = old_capacity > 0 ? old_capacity : LEADERBOARD_INITIAL_SLOTS;
+    while (capacity <= row) capacity *= 2;
+    NodeTable *grown = calloc(1, sizeof(NodeTable) + capacity * sizeof(LeaderNode *));
+    if (!grown) return 0;
+    grown->capacity = capacity;
+    if (old_capacity) memcpy(grown->at, node_table->at, old_capacity * sizeof(LeaderNode *));
+
+    NodeTable *old = __atomic_exchange_n(&node_table, grown, __ATOMIC_ACQ_REL);
+    epoch_retire(old, free);
+    return 1;
+}
+
+static void clear_indicators(IndicatorValues *v) {
+    v->sma = v->ema = v->rsi = v->vwap = NAN;
+    v->bollinger_upper = v->bollinger_middle = v->bollinger_lower = v->stddev = NAN;
+    v->atr = NAN;
+    v->samples = 0;
+}
+
+static int remove_row(int row) {
+    LeaderNode *node = row_node(row);
+    if (!node) return 0;
+    unlink_node(node);
+    store_ptr(&node_table->at[row], NULL);
+    epoch_retire(node, free);
+    return 1;
+}
+
+// ============================================================================
+// Lifecycle (only while no reader can be active, e.g. before the server
+// starts or after it stops)
+// ============================================================================
+int leaderboard_init(int capacity) {
+    leaderboard_free();
+
+    pthread_mutex_lock(&writer_lock);
+    head = alloc_node(LEADERBOARD_MAX_LEVEL);
+    int ok = head && reserve_rows(capacity > 0 ? capacity - 1 : 0) && rebuild_symbols();
+    pthread_mutex_unlock(&writer_lock);
+
+    if (!ok) leaderboard_free();
+    return ok;
+}
+
+void leaderboard_free(void) {
+    pthread_mutex_lock(&writer_lock);
+    seqlock_write_begin(&board_seq);
+    for (int row = 0; node_table && row < node_table->capacity; row++)
+        free(node_table->at[row]);
+    free(node_table);
+    free(head);
+    free(symbol_index);
+    node_table = NULL;
+    head = tail = NULL;
+    symbol_index = NULL;
+    level = 1;
+    length = 0;
+    has_indicators = 0;
+    __atomic_add_fetch(&version, 1, __ATOMIC_RELEASE);
+    seqlock_write_end(&board_seq);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+// ============================================================================
+// Writer side
+// ============================================================================
+int leaderboard_update(int row, const Stock *stock, const IndicatorValues *indicators) {
+    if (row < 0 || !stock) return 0;
+
+    pthread_mutex_lock(&writer_lock);
+    seqlock_write_begin(&board_seq);
+    int changed = 0;
+    if (!head) goto done;
+
+    double change = stock->change_percent;
+    if (stock->current_price <= 0 || isnan(change)) {
+        changed = remove_row(row);
+        goto done;
+    }
+    if (!reserve_rows(row)) goto done;
+
+    LeaderNode *node = node_table->at[row];
+    if (!node) {
+        node = alloc_node(random_level());
+        if (!node) goto done;
+        node->row = row;
+        node->change = change;
+        clear_indicators(&node->indicators);
+        link_node(node);
+        store_ptr(&node_table->at[row], node);
+        changed = 1;
+    } else if (node->change != change) {
+        // Same node, same level: relinking never allocates
+        unlink_node(node);
+        node->change = change;
+        link_node(node);
+        changed = 1;
+    }
+
+    if (memcmp(&node->stock, stock, sizeof(Stock)) != 0) {
+        int renamed = strcmp(node->stock.symbol, stock->symbol) != 0;
+        node->stock = *stock;
+        if (renamed) index_symbol(stock->symbol, row);
+        changed = 1;
+    }
+    if (indicators && memcmp(&node->indicators, indicators, sizeof(IndicatorValues)) != 0) {
+        node->indicators = *indicators;
+        has_indicators = 1;
+        changed = 1;
+    }
+
+done:
+    if (changed) __atomic_add_fetch(&version, 1, __ATOMIC_RELEASE);
+    seqlock_write_end(&board_seq);
+    pthread_mutex_unlock(&writer_lock);
+    return changed;
+}
+
+int leaderboard_remove(int row) {
+    pthread_mutex_lock(&writer_lock);
+    seqlock_write_begin(&board_seq);
+    int removed = head ? remove_row(row) : 0;
+    if (removed) __atomic_add_fetch(&version, 1, __ATOMIC_RELEASE);
+    seqlock_write_end(&board_seq);
+    pthread_mutex_unlock(&writer_lock);
+    return removed;
+}
+
+// ============================================================================
+// Reader side: copy under the sequence, redo the copy if a write got in.
+// A torn walk can run long or stop early, so every walk is bounded and its
+// result is only trusted once the sequence confirms it.
+// ============================================================================
+static void copy_row(LeaderboardView *view, const LeaderNode *node) {
+    view->stocks[view->count] = node->stock;
+    view->indicators[view->count] = node->indicators;
+    view->count++;
+}
+
+static void read_rows(int k, int from_bottom, LeaderboardView *view) {
+    epoch_enter();
+    unsigned long start;
+    do {
+        start = seqlock_read_begin(&board_seq);
+        view->count = 0;
+        view->version = __atomic_load_n(&version, __ATOMIC_ACQUIRE);
+        view->has_indicators = __atomic_load_n(&has_indicators, __ATOMIC_RELAXED);
+        LeaderNode *node = from_bottom ? load_ptr(&tail)
+                         : head ? load_ptr(&head->links[0].next) : NULL;
+        for (; node && view->count < k; node = load_ptr(from_bottom ? &node->prev : &node->links[0].next))
+            copy_row(view, node);
+    } while (seqlock_read_retry(&board_seq, start));
+    epoch_exit();
+}
+
+int leaderboard_top_k(int k, LeaderboardView *view) {
+    if (!view) return 0;
+    if (k > LEADERBOARD_MAX_K) k = LEADERBOARD_MAX_K;
+    read_rows(k, 0, view);
+    return view->count;
+}
+
+int leaderboard_bottom_k(int k, LeaderboardView *view) {
+    if (!view) return 0;
+    if (k > LEADERBOARD_MAX_K) k = LEADERBOARD_MAX_K;
+    read_rows(k, 1, view);
+    return view->count;
+}
+
+int leaderboard_rank(const char *symbol) {
+    if (!symbol) return 0;
+
+    epoch_enter();
+    unsigned long start;
+    int rank;
+    do {
+        start = seqlock_read_begin(&board_seq);
+        rank = 0;
+        int row = find_row(symbol);
+        const LeaderNode *node = row >= 0 ? row_node(row) : NULL;
+        if (!node || !head) continue;
+
+        // Sum the spans on the search path down to the node itself
+        double change = node->change;
+        int node_row = node->row;
+        int budget = __atomic_load_n(&length, __ATOMIC_RELAXED) + LEADERBOARD_MAX_LEVEL;
+        const LeaderNode *x = head;
+        for (int i = __atomic_load_n(&level, __ATOMIC_RELAXED) - 1; i >= 0 && x != node; i--) {
+            const LeaderNode *next;
+            while ((next = load_ptr(&x->links[i].next)) && budget-- > 0 &&
+                   (next == node || ranks_ahead(next, change, node_row))) {
+                rank += x->links[i].span;
+                x = next;
+            }
+        }
+    } while (seqlock_read_retry(&board_seq, start));
+    epoch_exit();
+    return rank;
+}
+
+int leaderboard_count(void) {
+    return __atomic_load_n(&length, __ATOMIC_RELAXED);
+}
+
+unsigned long leaderboard_version(void) {
+    return __atomic_load_n(&version, __ATOMIC_ACQUIRE);
+}
@@ -1,73 +1,293 @@
 /*
  * Smart Stock Tracker - Main Entry Point
- * Fetches live stock data from Finnhub and updates JSON for frontend.
+ * Fetches live stock data from Finnhub and serves it over HTTP.
+ * The HTTP daemon and the quote refresher run concurrently and share the
+ * in-memory snapshot; SIGINT/SIGTERM drain both and exit.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "stock_tracker.h"
+#include "server.h"
+#include <pthread.h>
+#include <signal.h>
 #include <unistd.h>
 #include <time.h>
 
-#define STOCK_COUNT 8
-#define REFRESH_INTERVAL 5  // seconds
-#define JSON_FILE_PATH "web/stock_data.json"
+#define REFRESH_INTERVAL 5  // seconds, minimum age before a quote is refetched
+#define JSON_FILE_PATH STOCKS_JSON_FILE
 
-int main() {
-     start_server();
-    Stock stocks[STOCK_COUNT];
-    const char *symbols[STOCK_COUNT] = {
-        "AAPL", "MSFT", "GOOGL", "AMZN",
-        "TSLA", "NVDA", "META", "AMD"
-    };
+// Tracked when there is no watchlist file yet; written out as the first one
+static const char *default_symbols[] = {
+    "AAPL", "MSFT", "GOOGL", "AMZN",
+    "TSLA", "NVDA", "META", "AMD"
+};
 
-    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
-    printf("║                 📊 SMART STOCK TRACKER (LIVE)              ║\n");
-    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
+// Every setting main() reads from the config file and command line
+typedef struct {
+    ServerConfig server;
+    TickStoreConfig ticks;
+    IndicatorConfig indicators;
+    PipelineConfig pipeline;
+    RulesConfig rules;
+} Settings;
 
-    if (!initialize_curl()) {
-        display_error("Failed to initialize CURL.");
-        return 1;
+static int stop_requested = 0;
+
+// Restore the last saved quotes for our symbols so the first cycle only
+// refetches what is actually stale
+static int warm_start(void) {
+    if (access(DATA_BINARY_FILE, F_OK) != 0 && access(DATA_FILE, F_OK) == 0 &&
+        convert_legacy_stock_file(DATA_FILE, DATA_BINARY_FILE) > 0)
+        printf("📦 Converted %s to %s\n", DATA_FILE, DATA_BINARY_FILE);
+
+    int saved_count = count_stocks_binary(DATA_BINARY_FILE);
+    if (saved_count <= 0) return 0;
+
+    Stock *saved = malloc(saved_count * sizeof(Stock));
+    if (!saved) return 0;
+    saved_count = load_stocks_binary(saved, saved_count, DATA_BINARY_FILE);
+
+    Stock *stocks = registry_stocks();
+    int restored = 0;
+    for (int j = 0; j < saved_count; j++) {
+        int slot = registry_find(saved[j].symbol);
+        if (slot < 0) continue;
+        stocks[slot] = saved[j];
+        restored++;
     }
+    free(saved);
+    return restored;
+}
 
-    while (1) {
-        printf("🔄 Fetching live stock data from Finnhub...\n");
-        int success_count = 0;
+static int settings_set(const char *key, const char *value, void *ctx) {
+    Settings *settings = ctx;
+    return server_config_set(key, value, &settings->server) ||
+           tickstore_config_set(key, value, &settings->ticks) ||
+           indicators_config_set(key, value, &settings->indicators) ||
+           pipeline_config_set(key, value, &settings->pipeline) ||
+           rules_config_set(key, value, &settings->rules);
+}
 
-        for (int i = 0; i < STOCK_COUNT; i++) {
-            printf("   • Fetching %s ... ", symbols[i]);
-            if (fetch_stock_data(symbols[i], &stocks[i])) {
-                analyze_stock_performance(&stocks[i]);
-                printf("✅ $%.2f (%+.2f%%)\n",
+// Per-slot state follows the registry's slots when symbols come and go
+static void follow_registry(RegistryEvent event, int slot, int from, void *ctx) {
+    (void)ctx;
+    switch (event) {
+    case REGISTRY_ADDED:
+        indicators_reserve(slot + 1);
+        break;
+    case REGISTRY_REMOVED:
+        leaderboard_remove(slot);
+        break;
+    case REGISTRY_MOVED: {
+        indicators_move(from, slot);
+        leaderboard_remove(from);
+        const IndicatorValues *values = indicators_values();
+        leaderboard_update(slot, &registry_stocks()[slot], values ? &values[slot] : NULL);
+        break;
+    }
+    }
+}
+
+// Apply watchlist edits and queued admin requests; admin changes are
+// written back so they survive a restart
+static int update_universe(void) {
+    int changes = registry_apply_pending();
+    if (changes > 0) registry_save_watchlist(WATCHLIST_FILE);
+
+    int synced = registry_sync_watchlist(WATCHLIST_FILE);
+    if (synced > 0) changes += synced;
+
+    if (changes > 0)
+        printf("📋 Watchlist updated: %d symbol(s) tracked\n", registry_count());
+    return changes;
+}
+
+// ---------------------------------------------------------------------------
+// Quote refresher thread (owns the registry's slots)
+// ---------------------------------------------------------------------------
+static void *refresh_loop(void *arg) {
+    (void)arg;
+    time_t next_maintenance = time(NULL) + TICK_MAINTENANCE_INTERVAL;
+
+    while (!__atomic_load_n(&stop_requested, __ATOMIC_ACQUIRE)) {
+        int universe_changed = update_universe() > 0;
+        Stock *stocks = registry_stocks();
+        int count = registry_count();
+
+        time_t cycle_start = time(NULL);
+        int success_count = scheduler_refresh(registry_symbols(), stocks, count);
+
+        if (success_count > 0)
+            printf("🔄 Refreshed %d quote(s) from Finnhub:\n", success_count);
+        for (int i = 0; i < count; i++) {
+            if (stocks[i].last_update >= cycle_start && stocks[i].current_price > 0) {
+                printf("   • %s ✅ $%.2f (%+.2f%%)\n", stocks[i].symbol,
                        stocks[i].current_price, stocks[i].change_percent);
-                success_count++;
-            } else {
-                printf("❌ Failed\n");
             }
-            usleep(400000); // brief delay between API calls (0.4s)
         }
 
-                if (success_count > 0) {
-            write_all_stocks_json(stocks, STOCK_COUNT, "stocks.json");
-write_best_stock_json(&stocks[0], "best_stock.json");
-write_trending_json(stocks, STOCK_COUNT, "trending.json");
+        if (success_count > 0 || universe_changed) {
+            // Publish in memory first; the server never touches the files
+            MarketSummary summary;
+            pipeline_analyze(stocks, count, &summary);
+            const IndicatorValues *values = indicators_values();
+            snapshot_publish(stocks, count, &summary, values);
 
+            // Only the quotes that moved are repositioned on the live board
+            for (int i = 0; i < count; i++) {
+                if (stocks[i].last_update >= cycle_start)
+                    leaderboard_update(i, &stocks[i], values ? &values[i] : NULL);
+            }
+            tickstore_append_since(stocks, count, cycle_start);
 
-            // ✅ Add this line: Save for debugging / JS reading if needed
-            save_stocks_to_file(stocks, STOCK_COUNT, "stock_data.txt");
+            if (PERSIST_JSON_FILES) {
+                Snapshot *snap = snapshot_acquire();
+                if (snapshot_persist(snap))
+                    printf("\n💾 JSON updated successfully → %s\n", JSON_FILE_PATH);
+                snapshot_release(snap);
+            }
 
+            // Full-precision copy for the next warm start
+            save_stocks_binary(stocks, count, DATA_BINARY_FILE);
 
-            printf("\n💾 JSON updated successfully → %s\n", JSON_FILE_PATH);
             time_t now = time(NULL);
             printf("🕒 Last Update: %s\n", ctime(&now));
-        } else {
-            display_error("No data fetched this cycle.");
+
+            // Flat allocation count across refreshes = zero allocations per quote
+            unsigned long allocations, quotes;
+            fetch_alloc_stats(&allocations, &quotes);
+            printf("🧮 Fetch heap allocations: %lu for %lu quote(s)\n", allocations, quotes);
+            printf("\n──────────────────────────────────────────────────────────────\n");
+        }
+
+        if (time(NULL) >= next_maintenance) {
+            tickstore_maintain(time(NULL));
+            next_maintenance = time(NULL) + TICK_MAINTENANCE_INTERVAL;
         }
 
+        // Old snapshots and leaderboard nodes whose readers have moved on
+        epoch_reclaim();
+        scheduler_wait(stocks, count);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    // Settings: built-in defaults < config file < command-line flags
+    Settings settings;
+    server_config_defaults(&settings.server);
+    tickstore_config_defaults(&settings.ticks);
+    indicators_config_defaults(&settings.indicators);
+    pipeline_config_defaults(&settings.pipeline);
+    rules_config_defaults(&settings.rules);
+    const char *config_file = config_find_arg(argc, argv, "config");
+    config_load(config_file ? config_file : CONFIG_FILE, settings_set, &settings);
+    config_parse_args(argc, argv, settings_set, &settings);
+    // Before any thread scores a quote
+    rules_init(&settings.rules);
+
+    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
+    printf("║                 📊 SMART STOCK TRACKER (LIVE)              ║\n");
+    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
 
-        printf("⏳ Waiting %d seconds before next refresh...\n", REFRESH_INTERVAL);
-        sleep(REFRESH_INTERVAL);
-        printf("\n──────────────────────────────────────────────────────────────\n");
+    // Block shutdown signals before any thread starts; the main thread
+    // collects them with sigwait() and every other thread inherits the mask
+    sigset_t shutdown_signals;
+    sigemptyset(&shutdown_signals);
+    sigaddset(&shutdown_signals, SIGINT);
+    sigaddset(&shutdown_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &shutdown_signals, NULL);
+
+    if (!initialize_curl()) {
+        display_error("Failed to initialize CURL.");
+        return 1;
     }
 
+    // The tracked symbols: the watchlist file, or the defaults on first run
+    if (!registry_init(sizeof(default_symbols) / sizeof(default_symbols[0]))) {
+        display_error("Failed to allocate the symbol registry.");
+        cleanup_curl();
+        return 1;
+    }
+    if (registry_sync_watchlist(WATCHLIST_FILE) < 0) {
+        for (size_t i = 0; i < sizeof(default_symbols) / sizeof(default_symbols[0]); i++)
+            registry_add(default_symbols[i]);
+        registry_save_watchlist(WATCHLIST_FILE);
+    }
+    int count = registry_count();
+    printf("📋 Tracking %d symbol(s) from %s\n", count, WATCHLIST_FILE);
+
+    // Serve whatever the previous run persisted until the first refresh
+    int restored = warm_start();
+    if (restored > 0)
+        printf("♻️  Restored %d quote(s) from %s\n", restored, DATA_BINARY_FILE);
+    snapshot_seed_from_files(registry_stocks(), count);
+    // Restored quotes rank until their first refresh
+    if (leaderboard_init(count)) {
+        for (int i = 0; i < count; i++) leaderboard_update(i, &registry_stocks()[i], NULL);
+    } else {
+        display_error("Failed to allocate the leaderboard.");
+    }
+    if (settings.ticks.enabled && !tickstore_open(&settings.ticks))
+        display_error("Tick history disabled for this run.");
+
+    // Everything a request or an admin change can reach is ready before
+    // the first connection
+    if (!indicators_init(&settings.indicators, count > 0 ? count : 1))
+        display_error("Failed to allocate indicator state.");
+    if (!pipeline_init(&settings.pipeline))
+        display_error("Analysis pipeline running on the refresher thread only.");
+    registry_set_listener(&follow_registry, NULL);
+
+    if (start_server(&settings.server) != 0) {
+        pipeline_free();
+        tickstore_close();
+        indicators_free();
+        leaderboard_free();
+        registry_free();
+        epoch_drain();
+        cleanup_curl();
+        return 1;
+    }
+
+    // Refreshes are paced by the token bucket in scheduler.c
+    scheduler_init(API_CALLS_PER_MINUTE, API_BURST, REFRESH_INTERVAL);
+
+    pthread_t refresher;
+    if (pthread_create(&refresher, NULL, refresh_loop, NULL) != 0) {
+        display_error("Failed to start the refresh thread.");
+        stop_server();
+        pipeline_free();
+        tickstore_close();
+        indicators_free();
+        leaderboard_free();
+        registry_free();
+        epoch_drain();
+        cleanup_curl();
+        return 1;
+    }
+
+    int sig = 0;
+    sigwait(&shutdown_signals, &sig);
+    printf("\n🛑 Received %s, shutting down...\n", sig == SIGINT ? "SIGINT" : "SIGTERM");
+
+    // Stop accepting connections while the refresher finishes its batch
+    __atomic_store_n(&stop_requested, 1, __ATOMIC_RELEASE);
+    scheduler_interrupt();
+    quiesce_server();
+
+    pthread_join(refresher, NULL);
+    stop_server();
+    pipeline_free();
+    tickstore_close();
+    indicators_free();
+    leaderboard_free();
+    registry_free();
+    epoch_drain();
     cleanup_curl();
+
+    display_success("Shutdown complete.");
     return 0;
 }
@@ -0,0 +1,347 @@
+/*
+ * Smart Stock Tracker - Cross-Sectional Analytics Kernels
+ * Counts, sums and arg-max over the contiguous MarketState columns, in
+ * AVX2, SSE2 and portable scalar versions. The widest version the CPU
+ * supports is picked once at first use.
+ *
+ * Every version returns the same counts and the same index as the scalar
+ * loop (first row holding the maximum); sums may differ in the last bits
+ * because lanes are added in a different order.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MARKET_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    const char *name;
+    void (*buckets)(const double *price, const double *change, int count, MarketBuckets *out);
+    int (*argmax)(const double *price, const double *values, int count, double floor);
+    int (*argmax_abs)(const double *price, const double *values, int count);
+} MarketKernels;
+
+// ============================================================================
+// Scalar
+// ============================================================================
+static void buckets_scalar(const double *price, const double *change, int count,
+                           MarketBuckets *out) {
+    MarketBuckets b = {0};
+    for (int i = 0; i < count; i++) {
+        int ok = price[i] > 0;
+        b.valid += ok;
+        b.positive += ok & (change[i] > 0);
+        b.bullish += ok & (change[i] > SENTIMENT_THRESHOLD);
+        b.bearish += ok & (change[i] < -SENTIMENT_THRESHOLD);
+        b.change_sum += ok ? change[i] : 0.0;
+        b.price_sum += ok ? price[i] : 0.0;
+    }
+    *out = b;
+}
+
+static int argmax_scalar(const double *price, const double *values, int count, double floor) {
+    int best = -1;
+    double highest = floor;
+    for (int i = 0; i < count; i++) {
+        if (price[i] > 0 && values[i] > highest) {
+            best = i;
+            highest = values[i];
+        }
+    }
+    return best;
+}
+
+static int argmax_abs_scalar(const double *price, const double *values, int count) {
+    int best = -1;
+    double highest = 0.0;
+    for (int i = 0; i < count; i++) {
+        double magnitude = fabs(values[i]);
+        if (price[i] > 0 && magnitude > highest) {
+            best = i;
+            highest = magnitude;
+        }
+    }
+    return best;
+}
+
+static const MarketKernels scalar_kernels = {
+    "scalar", buckets_scalar, argmax_scalar, argmax_abs_scalar
+};
+
+#ifdef MARKET_KERNELS_X86
+// Merge per-lane (max, first index) pairs: larger value wins, ties go to the
+// lower row so the result matches the scalar loop. Lanes that never matched
+// still hold index -1.
+static int reduce_lanes(const double *lane_max, const double *lane_index, int lanes,
+                        int best, double highest) {
+    for (int l = 0; l < lanes; l++) {
+        int index = (int)lane_index[l];
+        if (index < 0) continue;
+        if (lane_max[l] > highest || (lane_max[l] == highest && (best < 0 || index < best))) {
+            best = index;
+            highest = lane_max[l];
+        }
+    }
+    return best;
+}
+
+// Finish the rows left over after the last full vector
+static int argmax_tail(const double *price, const double *values, int start, int count,
+                       int best, double highest, int absolute) {
+    for (int i = start; i < count; i++) {
+        double v = absolute ? fabs(values[i]) : values[i];
+        if (price[i] > 0 && v > highest) {
+            best = i;
+            highest = v;
+        }
+    }
+    return best;
+}
+
+// Value of the winning row, for continuing into the tail
+static double best_value(const double *values, int best, double floor, int absolute) {
+    if (best < 0) return floor;
+    return absolute ? fabs(values[best]) : values[best];
+}
+
+// ============================================================================
+// SSE2 (2 doubles per vector)
+// ============================================================================
+static void buckets_sse2(const double *price, const double *change, int count,
+                         MarketBuckets *out) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d up = _mm_set1_pd(SENTIMENT_THRESHOLD);
+    const __m128d down = _mm_set1_pd(-SENTIMENT_THRESHOLD);
+    __m128d change_sum = zero, price_sum = zero;
+    // A true compare is all ones (-1 as an integer): subtracting it counts
+    __m128i valid = _mm_setzero_si128(), positive = valid, bullish = valid, bearish = valid;
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d p = _mm_loadu_pd(price + i);
+        __m128d c = _mm_loadu_pd(change + i);
+        __m128d ok = _mm_cmpgt_pd(p, zero);
+        valid = _mm_sub_epi64(valid, _mm_castpd_si128(ok));
+        positive = _mm_sub_epi64(positive, _mm_castpd_si128(_mm_and_pd(ok, _mm_cmpgt_pd(c, zero))));
+        bullish = _mm_sub_epi64(bullish, _mm_castpd_si128(_mm_and_pd(ok, _mm_cmpgt_pd(c, up))));
+        bearish = _mm_sub_epi64(bearish, _mm_castpd_si128(_mm_and_pd(ok, _mm_cmplt_pd(c, down))));
+        change_sum = _mm_add_pd(change_sum, _mm_and_pd(ok, c));
+        price_sum = _mm_add_pd(price_sum, _mm_and_pd(ok, p));
+    }
+
+    MarketBuckets b;
+    buckets_scalar(price + i, change + i, count - i, &b);
+
+    long long counts[2];
+    double sums[2];
+    _mm_storeu_si128((__m128i *)counts, valid);
+    b.valid += (int)(counts[0] + counts[1]);
+    _mm_storeu_si128((__m128i *)counts, positive);
+    b.positive += (int)(counts[0] + counts[1]);
+    _mm_storeu_si128((__m128i *)counts, bullish);
+    b.bullish += (int)(counts[0] + counts[1]);
+    _mm_storeu_si128((__m128i *)counts, bearish);
+    b.bearish += (int)(counts[0] + counts[1]);
+    _mm_storeu_pd(sums, change_sum);
+    b.change_sum += sums[0] + sums[1];
+    _mm_storeu_pd(sums, price_sum);
+    b.price_sum += sums[0] + sums[1];
+    *out = b;
+}
+
+static int argmax_sse2_impl(const double *price, const double *values, int count,
+                            double floor, int absolute) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d step = _mm_set1_pd(2.0);
+    __m128d lane_max = _mm_set1_pd(floor);
+    __m128d lane_index = _mm_set1_pd(-1.0);
+    __m128d index = _mm_set_pd(1.0, 0.0);
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        if (absolute) v = _mm_andnot_pd(sign, v);
+        __m128d hit = _mm_and_pd(_mm_cmpgt_pd(_mm_loadu_pd(price + i), zero),
+                                 _mm_cmpgt_pd(v, lane_max));
+        lane_max = _mm_or_pd(_mm_and_pd(hit, v), _mm_andnot_pd(hit, lane_max));
+        lane_index = _mm_or_pd(_mm_and_pd(hit, index), _mm_andnot_pd(hit, lane_index));
+        index = _mm_add_pd(index, step);
+    }
+
+    double max[2], idx[2];
+    _mm_storeu_pd(max, lane_max);
+    _mm_storeu_pd(idx, lane_index);
+    int best = reduce_lanes(max, idx, 2, -1, floor);
+    return argmax_tail(price, values, i, count, best,
+                       best_value(values, best, floor, absolute), absolute);
+}
+
+static int argmax_sse2(const double *price, const double *values, int count, double floor) {
+    return argmax_sse2_impl(price, values, count, floor, 0);
+}
+
+static int argmax_abs_sse2(const double *price, const double *values, int count) {
+    return argmax_sse2_impl(price, values, count, 0.0, 1);
+}
+
+static const MarketKernels sse2_kernels = {
+    "sse2", buckets_sse2, argmax_sse2, argmax_abs_sse2
+};
+
+// ============================================================================
+// AVX2 (4 doubles per vector)
+// ============================================================================
+__attribute__((target("avx2")))
+static void buckets_avx2(const double *price, const double *change, int count,
+                         MarketBuckets *out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d up = _mm256_set1_pd(SENTIMENT_THRESHOLD);
+    const __m256d down = _mm256_set1_pd(-SENTIMENT_THRESHOLD);
+    __m256d change_sum = zero, price_sum = zero;
+    __m256i valid = _mm256_setzero_si256(), positive = valid, bullish = valid, bearish = valid;
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d p = _mm256_loadu_pd(price + i);
+        __m256d c = _mm256_loadu_pd(change + i);
+        __m256d ok = _mm256_cmp_pd(p, zero, _CMP_GT_OQ);
+        __m256d gain = _mm256_and_pd(ok, _mm256_cmp_pd(c, zero, _CMP_GT_OQ));
+        __m256d rally = _mm256_and_pd(ok, _mm256_cmp_pd(c, up, _CMP_GT_OQ));
+        __m256d slump = _mm256_and_pd(ok, _mm256_cmp_pd(c, down, _CMP_LT_OQ));
+        valid = _mm256_sub_epi64(valid, _mm256_castpd_si256(ok));
+        positive = _mm256_sub_epi64(positive, _mm256_castpd_si256(gain));
+        bullish = _mm256_sub_epi64(bullish, _mm256_castpd_si256(rally));
+        bearish = _mm256_sub_epi64(bearish, _mm256_castpd_si256(slump));
+        change_sum = _mm256_add_pd(change_sum, _mm256_and_pd(ok, c));
+        price_sum = _mm256_add_pd(price_sum, _mm256_and_pd(ok, p));
+    }
+
+    long long counts[4][4];
+    double sums[2][4];
+    _mm256_storeu_si256((__m256i *)counts[0], valid);
+    _mm256_storeu_si256((__m256i *)counts[1], positive);
+    _mm256_storeu_si256((__m256i *)counts[2], bullish);
+    _mm256_storeu_si256((__m256i *)counts[3], bearish);
+    _mm256_storeu_pd(sums[0], change_sum);
+    _mm256_storeu_pd(sums[1], price_sum);
+    // Clear the upper halves before running legacy-SSE scalar code, or every
+    // scalar instruction pays an AVX state transition
+    _mm256_zeroupper();
+
+    MarketBuckets b;
+    buckets_scalar(price + i, change + i, count - i, &b);
+    b.valid += (int)(counts[0][0] + counts[0][1] + counts[0][2] + counts[0][3]);
+    b.positive += (int)(counts[1][0] + counts[1][1] + counts[1][2] + counts[1][3]);
+    b.bullish += (int)(counts[2][0] + counts[2][1] + counts[2][2] + counts[2][3]);
+    b.bearish += (int)(counts[3][0] + counts[3][1] + counts[3][2] + counts[3][3]);
+    b.change_sum += (sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]);
+    b.price_sum += (sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]);
+    *out = b;
+}
+
+__attribute__((target("avx2")))
+static int argmax_avx2_impl(const double *price, const double *values, int count,
+                            double floor, int absolute) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d lane_max = _mm256_set1_pd(floor);
+    __m256d lane_index = _mm256_set1_pd(-1.0);
+    __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        if (absolute) v = _mm256_andnot_pd(sign, v);
+        __m256d hit = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(price + i), zero, _CMP_GT_OQ),
+                                    _mm256_cmp_pd(v, lane_max, _CMP_GT_OQ));
+        lane_max = _mm256_blendv_pd(lane_max, v, hit);
+        lane_index = _mm256_blendv_pd(lane_index, index, hit);
+        index = _mm256_add_pd(index, step);
+    }
+
+    double max[4], idx[4];
+    _mm256_storeu_pd(max, lane_max);
+    _mm256_storeu_pd(idx, lane_index);
+    _mm256_zeroupper();
+    int best = reduce_lanes(max, idx, 4, -1, floor);
+    return argmax_tail(price, values, i, count, best,
+                       best_value(values, best, floor, absolute), absolute);
+}
+
+static int argmax_avx2(const double *price, const double *values, int count, double floor) {
+    return argmax_avx2_impl(price, values, count, floor, 0);
+}
+
+static int argmax_abs_avx2(const double *price, const double *values, int count) {
+    return argmax_avx2_impl(price, values, count, 0.0, 1);
+}
+
+static const MarketKernels avx2_kernels = {
+    "avx2", buckets_avx2, argmax_avx2, argmax_abs_avx2
+};
+#endif
+
+// ============================================================================
+// Runtime dispatch
+// ============================================================================
+static const MarketKernels *active = &scalar_kernels;
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+
+static void select_best_kernels(void) {
+#ifdef MARKET_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) active = &avx2_kernels;
+    else if (__builtin_cpu_supports("sse2")) active = &sse2_kernels;
+#endif
+}
+
+static const MarketKernels *kernels(void) {
+    pthread_once(&dispatch_once, select_best_kernels);
+    return active;
+}
+
+const char *market_kernels_name(void) {
+    return kernels()->name;
+}
+
+int market_kernels_select(const char *name) {
+    kernels();  // settle the automatic choice first so it cannot override this one
+    if (!name || strcmp(name, "auto") == 0) {
+        active = &scalar_kernels;
+        select_best_kernels();
+        return 1;
+    }
+    if (strcmp(name, "scalar") == 0) {
+        active = &scalar_kernels;
+        return 1;
+    }
+#ifdef MARKET_KERNELS_X86
+    if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+        active = &sse2_kernels;
+        return 1;
+    }
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        active = &avx2_kernels;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+void market_buckets(const double *price, const double *change, int count, MarketBuckets *out) {
+    kernels()->buckets(price, change, count > 0 ? count : 0, out);
+}
+
+int market_argmax(const double *price, const double *values, int count, double floor) {
+    return kernels()->argmax(price, values, count > 0 ? count : 0, floor);
+}
+
+int market_argmax_abs(const double *price, const double *values, int count) {
+    return kernels()->argmax_abs(price, values, count > 0 ? count : 0);
+}
@@ -0,0 +1,310 @@
+/*
+ * Smart Stock Tracker - Columnar Market State
+ * The fields every analytics pass reads (price, change, volume, day range,
+ * previous close, status) live in parallel arrays, so a scan touches only
+ * the bytes it uses. Symbol and name strings are interned once in a side
+ * table and referenced by offset; Stock rows are rebuilt only for display.
+ */
+
+#include "stock_tracker.h"
+
+#define STRING_POOL_INITIAL_SLOTS 64
+#define STRING_POOL_INITIAL_BYTES 1024
+
+// ============================================================================
+// String interning
+// ============================================================================
+static uint32_t hash_string(const char *text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int pool_init(StringPool *pool) {
+    memset(pool, 0, sizeof(*pool));
+    pool->data = malloc(STRING_POOL_INITIAL_BYTES);
+    pool->slots = calloc(STRING_POOL_INITIAL_SLOTS, sizeof(uint32_t));
+    if (!pool->data || !pool->slots) {
+        free(pool->data);
+        free(pool->slots);
+        return 0;
+    }
+    // Offset 0 is the empty string, which is never hashed
+    pool->data[0] = '\0';
+    pool->size = 1;
+    pool->capacity = STRING_POOL_INITIAL_BYTES;
+    pool->slot_count = STRING_POOL_INITIAL_SLOTS;
+    return 1;
+}
+
+static void pool_free(StringPool *pool) {
+    free(pool->data);
+    free(pool->slots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+static int pool_rehash(StringPool *pool) {
+    size_t slot_count = pool->slot_count * 2;
+    uint32_t *slots = calloc(slot_count, sizeof(uint32_t));
+    if (!slots) return 0;
+
+    for (size_t i = 0; i < pool->slot_count; i++) {
+        uint32_t entry = pool->slots[i];
+        if (!entry) continue;
+        const char *text = pool->data + entry - 1;
+        size_t slot = hash_string(text, strlen(text)) & (slot_count - 1);
+        while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = entry;
+    }
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slot_count = slot_count;
+    return 1;
+}
+
+// Offset of `text` in the pool, adding it on first sight
+static int pool_intern(StringPool *pool, const char *text, uint32_t *offset) {
+    size_t length = text ? strlen(text) : 0;
+    if (length == 0) {
+        *offset = 0;
+        return 1;
+    }
+
+    uint32_t hash = hash_string(text, length);
+    size_t mask = pool->slot_count - 1;
+    size_t slot = hash & mask;
+    for (; pool->slots[slot]; slot = (slot + 1) & mask) {
+        const char *existing = pool->data + pool->slots[slot] - 1;
+        if (strcmp(existing, text) == 0) {
+            *offset = pool->slots[slot] - 1;
+            return 1;
+        }
+    }
+
+    if (pool->size + length + 1 > UINT32_MAX - 1) return 0;
+    if (pool->size + length + 1 > pool->capacity) {
+        size_t capacity = pool->capacity * 2;
+        while (capacity < pool->size + length + 1) capacity *= 2;
+        char *data = realloc(pool->data, capacity);
+        if (!data) return 0;
+        pool->data = data;
+        pool->capacity = capacity;
+    }
+
+    *offset = (uint32_t)pool->size;
+    memcpy(pool->data + pool->size, text, length + 1);
+    pool->size += length + 1;
+    pool->slots[slot] = *offset + 1;
+
+    // Keep probes short: at most half the slots in use
+    if (++pool->used * 2 > pool->slot_count) return pool_rehash(pool);
+    return 1;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+#define GROW_COLUMN(column) do { \
+        void *grown = realloc(state->column, (size_t)capacity * sizeof(*state->column)); \
+        if (!grown) return 0; \
+        state->column = grown; \
+    } while (0)
+
+static int grow_columns(MarketState *state, int capacity) {
+    GROW_COLUMN(price);
+    GROW_COLUMN(change);
+    GROW_COLUMN(volume);
+    GROW_COLUMN(high);
+    GROW_COLUMN(low);
+    GROW_COLUMN(prev_close);
+    GROW_COLUMN(status);
+    GROW_COLUMN(symbol);
+    GROW_COLUMN(name);
+    GROW_COLUMN(market_cap);
+    GROW_COLUMN(last_update);
+    state->capacity = capacity;
+    return 1;
+}
+
+#undef GROW_COLUMN
+
+int market_state_init(MarketState *state, int capacity) {
+    memset(state, 0, sizeof(*state));
+    if (capacity < 1) capacity = 1;
+    if (!pool_init(&state->strings) || !grow_columns(state, capacity)) {
+        market_state_free(state);
+        return 0;
+    }
+    return 1;
+}
+
+void market_state_free(MarketState *state) {
+    free(state->price);
+    free(state->change);
+    free(state->volume);
+    free(state->high);
+    free(state->low);
+    free(state->prev_close);
+    free(state->status);
+    free(state->symbol);
+    free(state->name);
+    free(state->market_cap);
+    free(state->last_update);
+    pool_free(&state->strings);
+    memset(state, 0, sizeof(*state));
+}
+
+void market_state_clear(MarketState *state) {
+    state->count = 0;
+}
+
+// ============================================================================
+// Stock[] adapters
+// ============================================================================
+int market_state_set(MarketState *state, int index, const Stock *stock) {
+    if (index < 0 || index >= state->count || !stock) return 0;
+
+    // A refresh rewrites rows in place; only look up strings that changed
+    uint32_t symbol = state->symbol[index], name = state->name[index];
+    if (strcmp(state->strings.data + symbol, stock->symbol) != 0 &&
+        !pool_intern(&state->strings, stock->symbol, &symbol))
+        return 0;
+    if (strcmp(state->strings.data + name, stock->name) != 0 &&
+        !pool_intern(&state->strings, stock->name, &name))
+        return 0;
+
+    state->price[index] = stock->current_price;
+    state->change[index] = stock->change_percent;
+    state->volume[index] = stock->volume;
+    state->high[index] = stock->day_high;
+    state->low[index] = stock->day_low;
+    state->prev_close[index] = stock->previous_close;
+    state->status[index] = stock->status;
+    state->symbol[index] = symbol;
+    state->name[index] = name;
+    state->market_cap[index] = stock->market_cap;
+    state->last_update[index] = stock->last_update;
+    return 1;
+}
+
+int market_state_append(MarketState *state, const Stock *stock) {
+    if (state->count == state->capacity &&
+        !grow_columns(state, state->capacity * 2))
+        return -1;
+
+    int index = state->count++;
+    state->symbol[index] = state->name[index] = 0;
+    if (!market_state_set(state, index, stock)) {
+        state->count--;
+        return -1;
+    }
+    return index;
+}
+
+// Rows that already exist are overwritten so unchanged symbols skip interning
+int market_state_from_stocks(MarketState *state, const Stock stocks[], int count) {
+    if (count > state->capacity && !grow_columns(state, count)) return 0;
+    int reused = state->count < count ? state->count : count;
+    state->count = reused;
+    for (int i = 0; i < reused; i++) {
+        if (!market_state_set(state, i, &stocks[i])) return 0;
+    }
+    for (int i = reused; i < count; i++) {
+        if (market_state_append(state, &stocks[i]) < 0) return 0;
+    }
+    return 1;
+}
+
+void market_state_get(const MarketState *state, int index, Stock *out) {
+    memset(out, 0, sizeof(*out));
+    if (index < 0 || index >= state->count) return;
+
+    snprintf(out->symbol, sizeof(out->symbol), "%s", market_state_symbol(state, index));
+    snprintf(out->name, sizeof(out->name), "%s", market_state_name(state, index));
+    out->status = state->status[index];
+    out->current_price = state->price[index];
+    out->change_percent = state->change[index];
+    out->volume = state->volume[index];
+    out->day_high = state->high[index];
+    out->day_low = state->low[index];
+    out->previous_close = state->prev_close[index];
+    out->market_cap = state->market_cap[index];
+    out->last_update = state->last_update[index];
+}
+
+int market_state_to_stocks(const MarketState *state, Stock stocks[], int max_count) {
+    int count = state->count < max_count ? state->count : max_count;
+    for (int i = 0; i < count; i++) market_state_get(state, i, &stocks[i]);
+    return count;
+}
+
+const char *market_state_symbol(const MarketState *state, int index) {
+    return state->strings.data + state->symbol[index];
+}
+
+const char *market_state_name(const MarketState *state, int index) {
+    return state->strings.data + state->name[index];
+}
+
+// ============================================================================
+// Column scans (market_kernels.c picks the SIMD width)
+// ============================================================================
+void market_state_classify(MarketState *state) {
+    classify_stock_statuses(state->price, state->change, state->count, state->status);
+}
+
+int market_count_bullish(const MarketState *state) {
+    MarketBuckets b;
+    market_buckets(state->price, state->change, state->count, &b);
+    return b.positive;
+}
+
+double market_average_change(const MarketState *state) {
+    MarketBuckets b;
+    market_buckets(state->price, state->change, state->count, &b);
+    return b.valid > 0 ? b.change_sum / b.valid : 0.0;
+}
+
+double market_total_value(const MarketState *state) {
+    MarketBuckets b;
+    market_buckets(state->price, state->change, state->count, &b);
+    return b.price_sum;
+}
+
+int market_find_best(const MarketState *state) {
+    // Same floor as find_best_performing_stock
+    return market_argmax(state->price, state->change, state->count, -1000.0);
+}
+
+int market_find_most_volatile(const MarketState *state) {
+    return market_argmax_abs(state->price, state->change, state->count);
+}
+
+int market_find_highest_volume(const MarketState *state) {
+    return market_argmax(state->price, state->volume, state->count, 0.0);
+}
+
+const char *market_sentiment(const MarketState *state) {
+    if (state->count <= 0) return "UNKNOWN";
+
+    MarketBuckets b;
+    market_buckets(state->price, state->change, state->count, &b);
+    int neutral = b.valid - b.bullish - b.bearish;
+    if (b.bullish > b.bearish && b.bullish > neutral) return "🟢 BULLISH MARKET";
+    if (b.bearish > b.bullish && b.bearish > neutral) return "🔴 BEARISH MARKET";
+    return "🟡 NEUTRAL MARKET";
+}
+
+// Share of the minority direction, as in calculate_portfolio_diversity
+double market_portfolio_diversity(const MarketState *state) {
+    MarketBuckets b;
+    market_buckets(state->price, state->change, state->count, &b);
+    if (b.valid == 0) return 0.0;
+
+    int negative = b.valid - b.positive;
+    int minority = b.positive < negative ? b.positive : negative;
+    return (double)minority / b.valid * 100.0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Smart Stock Tracker - Post-Fetch Analysis Pipeline
+ * Everything the refresher does per row once a batch of quotes is in:
+ * feed the streaming indicators, classify the row's status and summarize
+ * the market. Rows are independent, so grain-sized chunks of them run on
+ * the work pool; each chunk summarizes into its own partial and the
+ * partials are merged in chunk order, which gives exactly the summary one
+ * serial pass would, whatever the thread count.
+ *
+ * Parsing is not part of it: quotes are parsed as their transfers
+ * complete, overlapped with the rest of the network I/O.
+ */
+
+#include "stock_tracker.h"
+
+typedef struct {
+    Stock *stocks;
+    MarketSummary *partials;                 // one per chunk
+    int *advanced;                           // indicator updates per chunk
+} PipelineJob;
+
+static PipelineConfig pipeline_config;
+static MarketSummary *partials = NULL;
+static int *advanced = NULL;
+static int partial_capacity = 0;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+void pipeline_config_defaults(PipelineConfig *config) {
+    config->threads = PIPELINE_THREADS;
+    config->grain = PIPELINE_GRAIN;
+    config->deterministic = 0;
+}
+
+int pipeline_config_set(const char *key, const char *value, void *ctx) {
+    PipelineConfig *config = ctx;
+    unsigned int parsed;
+
+    if (strcmp(key, "pipeline_threads") == 0) {
+        if (!config_parse_uint(value, PIPELINE_MAX_THREADS, &parsed)) return 0;
+        config->threads = parsed;
+        return 1;
+    }
+    if (strcmp(key, "pipeline_grain") == 0) {
+        if (!config_parse_uint(value, PIPELINE_MAX_GRAIN, &parsed) || parsed == 0) return 0;
+        config->grain = parsed;
+        return 1;
+    }
+    if (strcmp(key, "pipeline_deterministic") == 0) {
+        if (!config_parse_uint(value, 1, &parsed)) return 0;
+        config->deterministic = parsed;
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+int pipeline_init(const PipelineConfig *config) {
+    pipeline_config = *config;
+    if (pipeline_config.grain == 0) pipeline_config.grain = PIPELINE_GRAIN;
+    if (pipeline_config.deterministic) return workpool_init(1);
+    return workpool_init(pipeline_config.threads);
+}
+
+void pipeline_free(void) {
+    workpool_free();
+    free(partials);
+    free(advanced);
+    partials = NULL;
+    advanced = NULL;
+    partial_capacity = 0;
+}
+
+// ============================================================================
+// Analysis
+// ============================================================================
+static void analyze_range(void *ctx, int begin, int end, int chunk) {
+    PipelineJob *job = ctx;
+    int updated = 0;
+    for (int i = begin; i < end; i++) {
+        Stock *stock = &job->stocks[i];
+        updated += indicators_update(i, stock);
+        if (stock->current_price > 0) analyze_stock_performance(stock);
+    }
+    job->advanced[chunk] = updated;
+    market_summary_partial(job->stocks, begin, end, &job->partials[chunk]);
+}
+
+static int reserve_partials(int chunks) {
+    if (chunks <= partial_capacity) return 1;
+    MarketSummary *grown = realloc(partials, chunks * sizeof(MarketSummary));
+    if (!grown) return 0;
+    partials = grown;
+    int *counts = realloc(advanced, chunks * sizeof(int));
+    if (!counts) return 0;
+    advanced = counts;
+    partial_capacity = chunks;
+    return 1;
+}
+
+int pipeline_analyze(Stock stocks[], int count, MarketSummary *summary) {
+    int grain = pipeline_config.grain ? (int)pipeline_config.grain : PIPELINE_GRAIN;
+    int chunks = workpool_chunks(count, grain);
+
+    if (!reserve_partials(chunks)) {
+        display_error("Out of memory for the analysis pipeline; running it serially.");
+        int updated = indicators_update_all(stocks, count);
+        for (int i = 0; i < count; i++) {
+            if (stocks[i].current_price > 0) analyze_stock_performance(&stocks[i]);
+        }
+        market_summary_compute(stocks, count, summary);
+        return updated;
+    }
+
+    PipelineJob job = { stocks, partials, advanced };
+    workpool_parallel_for(count, grain, analyze_range, &job, pipeline_config.deterministic);
+
+    // Join in row order
+    int updated = 0;
+    market_summary_partial(stocks, 0, 0, summary);
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        market_summary_merge(summary, &partials[chunk], stocks);
+        updated += advanced[chunk];
+    }
+    market_summary_finish(stocks, count, summary);
+    return updated;
+}
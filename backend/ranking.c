@@ -0,0 +1,191 @@
+/*
+ * Smart Stock Tracker - Ranking
+ * Top-K / bottom-K selection over an index array: a bounded heap keeps the
+ * K best (key, row) pairs seen so far, so ranking n rows costs O(n log K)
+ * and no Stock is ever copied. Ties go to the lower row, which makes every
+ * ranking deterministic.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+#define RANK_STACK_ENTRIES 64
+
+typedef struct {
+    double value;
+    int index;
+} RankEntry;
+
+static const char *rank_key_names[RANK_KEY_COUNT] = {
+    [RANK_BY_CHANGE]     = "change",
+    [RANK_BY_VOLUME]     = "volume",
+    [RANK_BY_VOLATILITY] = "volatility",
+};
+
+const char *rank_key_name(RankKey key) {
+    return key < RANK_KEY_COUNT ? rank_key_names[key] : "unknown";
+}
+
+int rank_key_parse(const char *name, RankKey *key) {
+    for (int i = 0; name && i < RANK_KEY_COUNT; i++) {
+        if (strcmp(name, rank_key_names[i]) == 0) {
+            *key = (RankKey)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Every key is one double per row, optionally taken as |value|. Rows are
+// either Stock structs or MarketState columns; resolving the key to a base
+// pointer and stride once keeps the selection loop free of switches.
+typedef struct {
+    const char *price;                       // first row's price
+    const char *value;                       // first row's key value
+    size_t stride;                           // bytes from one row to the next
+    int absolute;
+} RankSource;
+
+static RankSource stock_source(const Stock stocks[], RankKey key) {
+    RankSource src = { (const char *)&stocks[0].current_price,
+                       (const char *)&stocks[0].change_percent, sizeof(Stock), 0 };
+    if (key == RANK_BY_VOLUME) src.value = (const char *)&stocks[0].volume;
+    else if (key == RANK_BY_VOLATILITY) src.absolute = 1;
+    return src;
+}
+
+static RankSource column_source(const MarketState *state, RankKey key) {
+    RankSource src = { (const char *)state->price, (const char *)state->change, sizeof(double), 0 };
+    if (key == RANK_BY_VOLUME) src.value = (const char *)state->volume;
+    else if (key == RANK_BY_VOLATILITY) src.absolute = 1;
+    return src;
+}
+
+static double source_price(const RankSource *src, int i) {
+    return *(const double *)(src->price + (size_t)i * src->stride);
+}
+
+static double source_value(const RankSource *src, int i) {
+    double value = *(const double *)(src->value + (size_t)i * src->stride);
+    return src->absolute ? fabs(value) : value;
+}
+
+// Does `a` rank ahead of `b`? `descending` ranks large values first.
+static int ranks_ahead(const RankEntry *a, const RankEntry *b, int descending) {
+    if (a->value != b->value) return descending ? a->value > b->value : a->value < b->value;
+    return a->index < b->index;
+}
+
+// Heap whose root is the entry ranked last, i.e. the first to be evicted
+static void sift_down(RankEntry heap[], int size, int pos, int descending) {
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= size) return;
+        if (child + 1 < size && ranks_ahead(&heap[child], &heap[child + 1], descending)) child++;
+        if (!ranks_ahead(&heap[pos], &heap[child], descending)) return;
+        RankEntry tmp = heap[pos];
+        heap[pos] = heap[child];
+        heap[child] = tmp;
+        pos = child;
+    }
+}
+
+static void sift_up(RankEntry heap[], int pos, int descending) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!ranks_ahead(&heap[parent], &heap[pos], descending)) return;
+        RankEntry tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+static int select_k(const RankSource *src, int count, int k, int out[], int descending) {
+    if (!out || count <= 0 || k <= 0) return 0;
+    if (k > count) k = count;
+
+    RankEntry stack_heap[RANK_STACK_ENTRIES];
+    RankEntry *heap = k <= RANK_STACK_ENTRIES ? stack_heap : malloc(k * sizeof(RankEntry));
+    if (!heap) return 0;
+
+    int size = 0;
+    for (int i = 0; i < count; i++) {
+        RankEntry entry = { source_value(src, i), i };
+        // Once the heap is full most rows lose to its root; reject them on
+        // the value alone (later rows also lose ties, so equal is out too)
+        if (size == k && (descending ? !(entry.value > heap[0].value)
+                                     : !(entry.value < heap[0].value)))
+            continue;
+        if (source_price(src, i) <= 0 || isnan(entry.value)) continue;
+
+        if (size < k) {
+            heap[size] = entry;
+            sift_up(heap, size++, descending);
+        } else if (ranks_ahead(&entry, &heap[0], descending)) {
+            heap[0] = entry;
+            sift_down(heap, size, 0, descending);
+        }
+    }
+
+    // Pop the last-ranked entry each time to fill out[] from the back
+    int selected = size;
+    while (size > 0) {
+        out[--size] = heap[0].index;
+        heap[0] = heap[size];
+        sift_down(heap, size, 0, descending);
+    }
+
+    if (heap != stack_heap) free(heap);
+    return selected;
+}
+
+int rank_top_k(const Stock stocks[], int count, RankKey key, int k, int out[]) {
+    if (!stocks) return 0;
+    RankSource src = stock_source(stocks, key);
+    return select_k(&src, count, k, out, 1);
+}
+
+int rank_bottom_k(const Stock stocks[], int count, RankKey key, int k, int out[]) {
+    if (!stocks) return 0;
+    RankSource src = stock_source(stocks, key);
+    return select_k(&src, count, k, out, 0);
+}
+
+int market_rank_top_k(const MarketState *state, RankKey key, int k, int out[]) {
+    if (!state) return 0;
+    RankSource src = column_source(state, key);
+    return select_k(&src, state->count, k, out, 1);
+}
+
+int market_rank_bottom_k(const MarketState *state, RankKey key, int k, int out[]) {
+    if (!state) return 0;
+    RankSource src = column_source(state, key);
+    return select_k(&src, state->count, k, out, 0);
+}
+
+// Full ordering for callers that need every row: value descending, NaN last
+static int compare_entries_descending(const void *a, const void *b) {
+    const RankEntry *x = a, *y = b;
+    int x_nan = !!isnan(x->value), y_nan = !!isnan(y->value);
+    if (x_nan != y_nan) return x_nan - y_nan;
+    if (!x_nan && x->value != y->value) return x->value < y->value ? 1 : -1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+int rank_order(const Stock stocks[], int count, RankKey key, int out[]) {
+    if (!stocks || !out || count <= 0) return 0;
+
+    RankEntry *entries = malloc(count * sizeof(RankEntry));
+    if (!entries) return 0;
+    RankSource src = stock_source(stocks, key);
+    for (int i = 0; i < count; i++) {
+        entries[i].value = source_value(&src, i);
+        entries[i].index = i;
+    }
+    qsort(entries, count, sizeof(RankEntry), compare_entries_descending);
+    for (int i = 0; i < count; i++) out[i] = entries[i].index;
+
+    free(entries);
+    return count;
+}
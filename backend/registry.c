@@ -0,0 +1,472 @@
+/*
+ * Smart Stock Tracker - Symbol Registry
+ * The tracked universe. Quotes live in one dense Stock array (slot i is one
+ * symbol, no holes) and an open-addressing hash maps each symbol's 8-byte
+ * key to its slot. Removing a symbol moves the last slot into the hole so
+ * scans stay dense; the listener hears about every move so per-slot state
+ * elsewhere (indicators, leaderboard rows) can follow.
+ *
+ * The refresher thread owns the slots. Other threads queue adds and
+ * removes, which the owner applies between cycles; lookups are safe from
+ * any thread and never lock: they probe under a sequence lock and retry if
+ * the owner edited the index meanwhile, and a grown index is retired
+ * through epochs rather than freed under a reader.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define REGISTRY_INITIAL_CAPACITY 64
+#define REGISTRY_MAX_PENDING 1024            // queued requests between two cycles
+
+typedef struct {
+    SymbolKey key;                           // 0 = empty
+    int slot;
+} IndexEntry;
+
+typedef struct {
+    size_t size;                             // power of two
+    IndexEntry entries[];
+} IndexTable;
+
+typedef struct {
+    int add;                                 // 1 = add, 0 = remove
+    SymbolKey key;
+} PendingChange;
+
+// Dense slot storage, parallel arrays of `capacity` entries
+static Stock *stocks = NULL;
+static SymbolKey *keys = NULL;
+static char (*names)[SYMBOL_KEY_LENGTH + 1] = NULL;
+static const char **symbols = NULL;          // symbols[i] = names[i], for the fetch API
+static int count = 0;
+static int capacity = 0;
+
+// Symbol key -> slot; linear probing, at most half full
+static IndexTable *index_table = NULL;
+
+static RegistryListener listener = NULL;
+static void *listener_ctx = NULL;
+
+static PendingChange pending[REGISTRY_MAX_PENDING];
+static int pending_count = 0;
+static time_t watchlist_mtime = 0;
+
+// Writers hold the mutex across a mutation; lookups only watch the sequence
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static SeqLock index_seq = { 0 };
+static pthread_mutex_t pending_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// ============================================================================
+// Symbol keys
+// ============================================================================
+int symbol_key_make(const char *symbol, SymbolKey *key) {
+    if (!symbol || !key) return 0;
+
+    char packed[SYMBOL_KEY_LENGTH] = {0};
+    size_t len = 0;
+    for (; symbol[len]; len++) {
+        if (len == SYMBOL_KEY_LENGTH || !isalnum((unsigned char)symbol[len])) return 0;
+        packed[len] = (char)toupper((unsigned char)symbol[len]);
+    }
+    if (len == 0) return 0;
+
+    memcpy(key, packed, sizeof(*key));
+    return 1;
+}
+
+void symbol_key_text(SymbolKey key, char text[SYMBOL_KEY_LENGTH + 1]) {
+    memcpy(text, &key, SYMBOL_KEY_LENGTH);
+    text[SYMBOL_KEY_LENGTH] = '\0';
+}
+
+// 64-bit finalizer (MurmurHash3 fmix64): every key byte reaches the low bits
+static size_t hash_key(SymbolKey key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+// ============================================================================
+// Hash index
+// ============================================================================
+static size_t index_probe(const IndexTable *table, SymbolKey key) {
+    size_t mask = table->size - 1;
+    size_t pos = hash_key(key) & mask;
+    while (table->entries[pos].key && table->entries[pos].key != key) pos = (pos + 1) & mask;
+    return pos;
+}
+
+// Build the larger table aside and swap it in; lookups may still be
+// probing the old one, so it is retired rather than freed
+static int index_grow(size_t size) {
+    IndexTable *grown = calloc(1, sizeof(IndexTable) + size * sizeof(IndexEntry));
+    if (!grown) return 0;
+    grown->size = size;
+
+    IndexTable *old = index_table;
+    for (size_t i = 0; old && i < old->size; i++) {
+        if (old->entries[i].key) grown->entries[index_probe(grown, old->entries[i].key)] = old->entries[i];
+    }
+    __atomic_store_n(&index_table, grown, __ATOMIC_RELEASE);
+    epoch_retire(old, free);
+    return 1;
+}
+
+// Delete by shifting later entries of the probe run back, so lookups
+// never need tombstones
+static void index_delete(SymbolKey key) {
+    IndexEntry *entries = index_table->entries;
+    size_t mask = index_table->size - 1;
+    size_t hole = index_probe(index_table, key);
+    if (!entries[hole].key) return;
+
+    for (size_t pos = (hole + 1) & mask; entries[pos].key; pos = (pos + 1) & mask) {
+        size_t home = hash_key(entries[pos].key) & mask;
+        // Move the entry if its home is not in (hole, pos]
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            entries[hole] = entries[pos];
+            hole = pos;
+        }
+    }
+    entries[hole].key = 0;
+}
+
+// ============================================================================
+// Slot storage
+// ============================================================================
+static int reserve_slots(int wanted) {
+    if (wanted <= capacity) return 1;
+    int grown = capacity > 0 ? capacity : REGISTRY_INITIAL_CAPACITY;
+    while (grown < wanted) grown *= 2;
+
+    Stock *new_stocks = realloc(stocks, grown * sizeof(Stock));
+    if (!new_stocks) return 0;
+    stocks = new_stocks;
+    SymbolKey *new_keys = realloc(keys, grown * sizeof(SymbolKey));
+    if (!new_keys) return 0;
+    keys = new_keys;
+    char (*new_names)[SYMBOL_KEY_LENGTH + 1] = realloc(names, grown * sizeof(*names));
+    if (!new_names) return 0;
+    names = new_names;
+    const char **new_symbols = realloc(symbols, grown * sizeof(char *));
+    if (!new_symbols) return 0;
+    symbols = new_symbols;
+
+    for (int i = 0; i < count; i++) symbols[i] = names[i];
+    capacity = grown;
+    return 1;
+}
+
+static void notify(RegistryEvent event, int slot, int from) {
+    if (listener) listener(event, slot, from, listener_ctx);
+}
+
+static int add_key(SymbolKey key) {
+    pthread_mutex_lock(&registry_lock);
+    size_t pos = index_probe(index_table, key);
+    if (index_table->entries[pos].key) {
+        int slot = index_table->entries[pos].slot;
+        pthread_mutex_unlock(&registry_lock);
+        return slot;
+    }
+
+    int slot = -1;
+    if (reserve_slots(count + 1) &&
+        (2 * (size_t)(count + 1) <= index_table->size || index_grow(index_table->size * 2))) {
+        slot = count;
+        keys[slot] = key;
+        symbol_key_text(key, names[slot]);
+        symbols[slot] = names[slot];
+        memset(&stocks[slot], 0, sizeof(Stock));
+        snprintf(stocks[slot].symbol, sizeof(stocks[slot].symbol), "%s", names[slot]);
+        seqlock_write_begin(&index_seq);
+        index_table->entries[index_probe(index_table, key)] = (IndexEntry){ key, slot };
+        __atomic_store_n(&count, slot + 1, __ATOMIC_RELEASE);
+        seqlock_write_end(&index_seq);
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    if (slot >= 0) notify(REGISTRY_ADDED, slot, slot);
+    return slot;
+}
+
+static int remove_key(SymbolKey key) {
+    pthread_mutex_lock(&registry_lock);
+    size_t pos = index_probe(index_table, key);
+    if (!index_table->entries[pos].key) {
+        pthread_mutex_unlock(&registry_lock);
+        return 0;
+    }
+
+    int slot = index_table->entries[pos].slot;
+    int last = count - 1;
+    seqlock_write_begin(&index_seq);
+    __atomic_store_n(&count, last, __ATOMIC_RELEASE);
+    index_delete(key);
+    if (slot != last) {
+        stocks[slot] = stocks[last];
+        keys[slot] = keys[last];
+        memcpy(names[slot], names[last], sizeof(names[slot]));
+        index_table->entries[index_probe(index_table, keys[slot])].slot = slot;
+    }
+    seqlock_write_end(&index_seq);
+    pthread_mutex_unlock(&registry_lock);
+
+    notify(REGISTRY_REMOVED, slot, slot);
+    if (slot != last) notify(REGISTRY_MOVED, slot, last);
+    return 1;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+int registry_init(int initial_capacity) {
+    registry_free();
+
+    pthread_mutex_lock(&registry_lock);
+    size_t size = 16;
+    while (size < 2 * (size_t)(initial_capacity > 0 ? initial_capacity : 1)) size *= 2;
+    int ok = reserve_slots(initial_capacity > 0 ? initial_capacity : 1) && index_grow(size);
+    pthread_mutex_unlock(&registry_lock);
+
+    if (!ok) registry_free();
+    return ok;
+}
+
+// Only while no lookup can be running (before the server starts or after it stops)
+void registry_free(void) {
+    pthread_mutex_lock(&registry_lock);
+    free(stocks);
+    free(keys);
+    free(names);
+    free(symbols);
+    free(index_table);
+    stocks = NULL;
+    keys = NULL;
+    names = NULL;
+    symbols = NULL;
+    index_table = NULL;
+    count = capacity = 0;
+    watchlist_mtime = 0;
+    pthread_mutex_unlock(&registry_lock);
+
+    pthread_mutex_lock(&pending_lock);
+    pending_count = 0;
+    pthread_mutex_unlock(&pending_lock);
+}
+
+void registry_set_listener(RegistryListener fn, void *ctx) {
+    listener = fn;
+    listener_ctx = ctx;
+}
+
+// ============================================================================
+// Owner thread
+// ============================================================================
+int registry_add(const char *symbol) {
+    SymbolKey key;
+    if (!index_table || !symbol_key_make(symbol, &key)) return -1;
+    return add_key(key);
+}
+
+int registry_remove(const char *symbol) {
+    SymbolKey key;
+    if (!index_table || !symbol_key_make(symbol, &key)) return 0;
+    return remove_key(key);
+}
+
+Stock *registry_stocks(void) {
+    return stocks;
+}
+
+const char **registry_symbols(void) {
+    return symbols;
+}
+
+int registry_apply_pending(void) {
+    PendingChange batch[REGISTRY_MAX_PENDING];
+    pthread_mutex_lock(&pending_lock);
+    int n = pending_count;
+    memcpy(batch, pending, n * sizeof(PendingChange));
+    pending_count = 0;
+    pthread_mutex_unlock(&pending_lock);
+
+    int changes = 0;
+    for (int i = 0; i < n && index_table; i++) {
+        if (batch[i].add) {
+            int before = count;
+            changes += add_key(batch[i].key) >= 0 && count > before;
+        } else {
+            changes += remove_key(batch[i].key);
+        }
+    }
+    return changes;
+}
+
+// ============================================================================
+// Watchlist file: symbols separated by whitespace or commas, '#' comments
+// ============================================================================
+static time_t file_mtime(const char *filename) {
+    struct stat st;
+    return stat(filename, &st) == 0 ? st.st_mtime : 0;
+}
+
+static int read_watchlist(const char *filename, SymbolKey **out) {
+    FILE *file = fopen(filename, "r");
+    if (!file) return -1;
+
+    int n = 0, cap = 0;
+    SymbolKey *list = NULL;
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char *save = NULL;
+        for (char *token = strtok_r(line, " \t\r\n,", &save); token;
+             token = strtok_r(NULL, " \t\r\n,", &save)) {
+            SymbolKey key;
+            if (!symbol_key_make(token, &key)) {
+                fprintf(stderr, "%s:%d: invalid symbol '%s'\n", filename, line_no, token);
+                continue;
+            }
+            if (n == cap) {
+                cap = cap ? cap * 2 : REGISTRY_INITIAL_CAPACITY;
+                SymbolKey *grown = realloc(list, cap * sizeof(SymbolKey));
+                if (!grown) {
+                    free(list);
+                    fclose(file);
+                    return -1;
+                }
+                list = grown;
+            }
+            list[n++] = key;
+        }
+    }
+    fclose(file);
+    *out = list;
+    return n;
+}
+
+int registry_sync_watchlist(const char *filename) {
+    time_t mtime = file_mtime(filename);
+    if (!index_table || mtime == 0) return -1;
+    if (mtime == watchlist_mtime) return 0;
+
+    SymbolKey *listed_keys = NULL;
+    int listed_count = read_watchlist(filename, &listed_keys);
+    if (listed_count < 0) return -1;
+    watchlist_mtime = mtime;
+
+    // Flag the slots the file keeps; everything else goes
+    unsigned char *listed = calloc(count > 0 ? count : 1, 1);
+    if (!listed) {
+        free(listed_keys);
+        return -1;
+    }
+    for (int i = 0; i < listed_count; i++) {
+        int slot = registry_find_key(listed_keys[i]);
+        if (slot >= 0) listed[slot] = 1;
+    }
+
+    // Walk down so the slot moved into each hole has already been checked
+    int changes = 0;
+    for (int slot = count - 1; slot >= 0; slot--) {
+        if (listed[slot]) continue;
+        int last = count - 1;
+        changes += remove_key(keys[slot]);
+        if (slot != last) listed[slot] = listed[last];
+    }
+    for (int i = 0; i < listed_count; i++) {
+        int before = count;
+        if (add_key(listed_keys[i]) >= 0 && count > before) changes++;
+    }
+
+    free(listed);
+    free(listed_keys);
+    return changes;
+}
+
+int registry_save_watchlist(const char *filename) {
+    size_t size = (size_t)count * (SYMBOL_KEY_LENGTH + 1) + 64;
+    char *text = malloc(size);
+    if (!text) return 0;
+
+    size_t used = (size_t)snprintf(text, size, "# Tracked symbols, one per line\n");
+    for (int i = 0; i < count; i++)
+        used += (size_t)snprintf(text + used, size - used, "%s\n", names[i]);
+
+    int ok = write_file_atomic(filename, text, used);
+    free(text);
+    // Our own write must not read back as an edit
+    if (ok) watchlist_mtime = file_mtime(filename);
+    return ok;
+}
+
+// ============================================================================
+// Any thread
+// ============================================================================
+int registry_find_key(SymbolKey key) {
+    epoch_enter();
+    unsigned long start;
+    int slot;
+    do {
+        start = seqlock_read_begin(&index_seq);
+        slot = -1;
+        const IndexTable *table = __atomic_load_n(&index_table, __ATOMIC_ACQUIRE);
+        if (!table) continue;
+
+        // Bounded: mid-delete the probe run can look different from any
+        // state the owner leaves it in
+        size_t mask = table->size - 1;
+        size_t pos = hash_key(key) & mask;
+        for (size_t probes = 0; probes < table->size; probes++, pos = (pos + 1) & mask) {
+            IndexEntry entry = table->entries[pos];
+            if (!entry.key) break;
+            if (entry.key == key) {
+                slot = entry.slot;
+                break;
+            }
+        }
+    } while (seqlock_read_retry(&index_seq, start));
+    epoch_exit();
+    return slot;
+}
+
+int registry_find(const char *symbol) {
+    SymbolKey key;
+    return symbol_key_make(symbol, &key) ? registry_find_key(key) : -1;
+}
+
+int registry_count(void) {
+    return __atomic_load_n(&count, __ATOMIC_ACQUIRE);
+}
+
+static int request_change(const char *symbol, int add) {
+    SymbolKey key;
+    if (!symbol_key_make(symbol, &key)) return 0;
+
+    pthread_mutex_lock(&pending_lock);
+    int queued = pending_count < REGISTRY_MAX_PENDING;
+    if (queued) pending[pending_count++] = (PendingChange){ add, key };
+    pthread_mutex_unlock(&pending_lock);
+    return queued;
+}
+
+int registry_request_add(const char *symbol) {
+    return request_change(symbol, 1);
+}
+
+int registry_request_remove(const char *symbol) {
+    return request_change(symbol, 0);
+}
@@ -0,0 +1,272 @@
+/*
+ * Smart Stock Tracker - Scoring Rules
+ * Status, recommendation, risk and pattern verdicts as small enum codes.
+ * Every verdict is a table lookup: a quote's level is the number of
+ * threshold rules it passes (the thresholds are ordered, so each rule
+ * passed moves it one bucket up) and the level indexes a code table. The
+ * comparisons are summed rather than branched on, so scoring a column of
+ * quotes is a straight loop, and the tables are only written by rules_init
+ * before any thread scores, so scoring is safe from any thread.
+ *
+ * Display strings live in the label tables at the bottom and are only
+ * looked up where a code leaves the process.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+#include <stddef.h>
+
+#define STATUS_RULES 6
+#define RECOMMEND_RULES 6
+#define RISK_RULES 2
+
+// Passed when change > cut, or change == cut for an inclusive rule
+typedef struct {
+    double cut;
+    int inclusive;
+} ChangeRule;
+
+// Passed when change >= change and volume > volume
+typedef struct {
+    double change;
+    double volume;
+} MomentumRule;
+
+// Weakest bucket first; a quote passing n rules lands in bucket n
+static ChangeRule status_rules[STATUS_RULES] = {
+    { STRONG_SELL_THRESHOLD, 0 },
+    { SELL_THRESHOLD, 0 },
+    { 0.0, 1 },
+    { 0.0, 0 },
+    { BUY_THRESHOLD, 1 },
+    { STRONG_BUY_THRESHOLD, 1 },
+};
+
+static const unsigned char status_by_level[STATUS_RULES + 1] = {
+    STATUS_AVOID, STATUS_BEARISH, STATUS_WATCH, STATUS_NEUTRAL,
+    STATUS_POSITIVE, STATUS_BULLISH, STATUS_STRONG_BUY,
+};
+
+static MomentumRule recommend_rules[RECOMMEND_RULES] = {
+    { RECOMMEND_SELL_CHANGE, -HUGE_VAL },
+    { RECOMMEND_WATCH_CHANGE, -HUGE_VAL },
+    { RECOMMEND_HOLD_CHANGE, -HUGE_VAL },
+    { RECOMMEND_HOLD_UP_CHANGE, -HUGE_VAL },
+    { RECOMMEND_BUY_CHANGE, RECOMMEND_BUY_VOLUME },
+    { RECOMMEND_STRONG_BUY_CHANGE, RECOMMEND_STRONG_BUY_VOLUME },
+};
+
+static double risk_cuts[RISK_RULES] = { RISK_MEDIUM_CHANGE, RISK_HIGH_CHANGE };
+static double pattern_breakout = PATTERN_BREAKOUT_CHANGE;
+static double pattern_sideways = PATTERN_SIDEWAYS_CHANGE;
+
+// Indexed by breakout | breakdown << 1 | sideways << 2 | up << 3; the
+// lowest set bit wins
+static const unsigned char pattern_by_flags[16] = {
+    PATTERN_DOWNWARD, PATTERN_BREAKOUT, PATTERN_BREAKDOWN, PATTERN_BREAKOUT,
+    PATTERN_SIDEWAYS, PATTERN_BREAKOUT, PATTERN_BREAKDOWN, PATTERN_BREAKOUT,
+    PATTERN_UPWARD,   PATTERN_BREAKOUT, PATTERN_BREAKDOWN, PATTERN_BREAKOUT,
+    PATTERN_SIDEWAYS, PATTERN_BREAKOUT, PATTERN_BREAKDOWN, PATTERN_BREAKOUT,
+};
+
+// ============================================================================
+// Configuration
+// ============================================================================
+static const struct {
+    const char *key;
+    size_t offset;
+} rule_keys[] = {
+    { "status_strong_buy", offsetof(RulesConfig, strong_buy) },
+    { "status_buy", offsetof(RulesConfig, buy) },
+    { "status_sell", offsetof(RulesConfig, sell) },
+    { "status_strong_sell", offsetof(RulesConfig, strong_sell) },
+    { "recommend_strong_buy", offsetof(RulesConfig, recommend_strong_buy) },
+    { "recommend_strong_buy_volume", offsetof(RulesConfig, recommend_strong_buy_volume) },
+    { "recommend_buy", offsetof(RulesConfig, recommend_buy) },
+    { "recommend_buy_volume", offsetof(RulesConfig, recommend_buy_volume) },
+    { "recommend_hold_up", offsetof(RulesConfig, recommend_hold_up) },
+    { "recommend_hold", offsetof(RulesConfig, recommend_hold) },
+    { "recommend_watch", offsetof(RulesConfig, recommend_watch) },
+    { "recommend_sell", offsetof(RulesConfig, recommend_sell) },
+    { "risk_medium", offsetof(RulesConfig, risk_medium) },
+    { "risk_high", offsetof(RulesConfig, risk_high) },
+    { "pattern_breakout", offsetof(RulesConfig, pattern_breakout) },
+    { "pattern_sideways", offsetof(RulesConfig, pattern_sideways) },
+};
+
+void rules_config_defaults(RulesConfig *config) {
+    config->strong_buy = STRONG_BUY_THRESHOLD;
+    config->buy = BUY_THRESHOLD;
+    config->sell = SELL_THRESHOLD;
+    config->strong_sell = STRONG_SELL_THRESHOLD;
+    config->recommend_strong_buy = RECOMMEND_STRONG_BUY_CHANGE;
+    config->recommend_strong_buy_volume = RECOMMEND_STRONG_BUY_VOLUME;
+    config->recommend_buy = RECOMMEND_BUY_CHANGE;
+    config->recommend_buy_volume = RECOMMEND_BUY_VOLUME;
+    config->recommend_hold_up = RECOMMEND_HOLD_UP_CHANGE;
+    config->recommend_hold = RECOMMEND_HOLD_CHANGE;
+    config->recommend_watch = RECOMMEND_WATCH_CHANGE;
+    config->recommend_sell = RECOMMEND_SELL_CHANGE;
+    config->risk_medium = RISK_MEDIUM_CHANGE;
+    config->risk_high = RISK_HIGH_CHANGE;
+    config->pattern_breakout = PATTERN_BREAKOUT_CHANGE;
+    config->pattern_sideways = PATTERN_SIDEWAYS_CHANGE;
+}
+
+int rules_config_set(const char *key, const char *value, void *ctx) {
+    for (size_t i = 0; i < sizeof(rule_keys) / sizeof(rule_keys[0]); i++) {
+        if (strcmp(key, rule_keys[i].key) != 0) continue;
+        char *end;
+        double parsed = strtod(value, &end);
+        if (end == value || *end != '\0' || !isfinite(parsed)) return 0;
+        *(double *)((char *)ctx + rule_keys[i].offset) = parsed;
+        return 1;
+    }
+    return 0;
+}
+
+// Buckets only nest when every threshold sits above the one below it
+static int rules_ordered(const RulesConfig *c) {
+    return c->strong_sell <= c->sell && c->sell < 0 && 0 < c->buy && c->buy <= c->strong_buy &&
+           c->recommend_sell <= c->recommend_watch && c->recommend_watch <= c->recommend_hold &&
+           c->recommend_hold <= c->recommend_hold_up && c->recommend_hold_up <= c->recommend_buy &&
+           c->recommend_buy <= c->recommend_strong_buy &&
+           c->recommend_buy_volume <= c->recommend_strong_buy_volume &&
+           0 <= c->risk_medium && c->risk_medium <= c->risk_high &&
+           c->pattern_breakout >= 0 && c->pattern_sideways >= 0;
+}
+
+int rules_init(const RulesConfig *config) {
+    if (!rules_ordered(config)) {
+        display_error("Scoring thresholds are out of order; keeping the previous rules.");
+        return 0;
+    }
+
+    status_rules[0].cut = config->strong_sell;
+    status_rules[1].cut = config->sell;
+    status_rules[4].cut = config->buy;
+    status_rules[5].cut = config->strong_buy;
+
+    recommend_rules[0].change = config->recommend_sell;
+    recommend_rules[1].change = config->recommend_watch;
+    recommend_rules[2].change = config->recommend_hold;
+    recommend_rules[3].change = config->recommend_hold_up;
+    recommend_rules[4] = (MomentumRule){ config->recommend_buy, config->recommend_buy_volume };
+    recommend_rules[5] = (MomentumRule){ config->recommend_strong_buy,
+                                         config->recommend_strong_buy_volume };
+
+    risk_cuts[0] = config->risk_medium;
+    risk_cuts[1] = config->risk_high;
+    pattern_breakout = config->pattern_breakout;
+    pattern_sideways = config->pattern_sideways;
+    return 1;
+}
+
+// ============================================================================
+// Scoring
+// ============================================================================
+StockStatus classify_stock_status(double price, double change) {
+    int level = 0;
+    for (int r = 0; r < STATUS_RULES; r++)
+        level += (change > status_rules[r].cut) | (status_rules[r].inclusive & (change == status_rules[r].cut));
+    // STATUS_INVALID is 0: a row without a price zeroes its code
+    return (StockStatus)(status_by_level[level] * (price > 0));
+}
+
+void classify_stock_statuses(const double price[], const double change[], int count,
+                             unsigned char status[]) {
+    for (int i = 0; i < count; i++)
+        status[i] = (unsigned char)classify_stock_status(price[i], change[i]);
+}
+
+Recommendation stock_recommendation(const Stock *stock) {
+    if (!stock) return RECOMMEND_INVALID;
+    double change = stock->change_percent, volume = stock->volume;
+    int level = 0;
+    for (int r = 0; r < RECOMMEND_RULES; r++)
+        level += (change >= recommend_rules[r].change) & (volume > recommend_rules[r].volume);
+    return (Recommendation)((RECOMMEND_STRONG_SELL + level) * (stock->current_price > 0));
+}
+
+RiskLevel stock_risk_level(const Stock *stock) {
+    if (!stock) return RISK_UNKNOWN;
+    double move = fabs(stock->change_percent);
+    int level = (move >= risk_cuts[0]) + (move >= risk_cuts[1]);
+    return (RiskLevel)((RISK_LOW + level) * (stock->current_price > 0));
+}
+
+PricePattern stock_price_pattern(const Stock *stock) {
+    if (!stock) return PATTERN_UNKNOWN;
+    double change = stock->change_percent;
+    double midpoint = (stock->day_high + stock->day_low) / 2;
+    int flags = ((change > pattern_breakout) & (stock->current_price > midpoint)) |
+                ((change < -pattern_breakout) & (stock->current_price < midpoint)) << 1 |
+                (fabs(change) < pattern_sideways) << 2 |
+                (change > 0) << 3;
+    return (PricePattern)(pattern_by_flags[flags] * (stock->current_price > 0));
+}
+
+// ============================================================================
+// Labels
+// ============================================================================
+static const char *status_labels[STATUS_COUNT] = {
+    [STATUS_INVALID]    = "❌ INVALID",
+    [STATUS_STRONG_BUY] = "🚀 STRONG BUY",
+    [STATUS_BULLISH]    = "📈 BULLISH",
+    [STATUS_POSITIVE]   = "🟢 POSITIVE",
+    [STATUS_NEUTRAL]    = "⚪ NEUTRAL",
+    [STATUS_WATCH]      = "🟡 WATCH",
+    [STATUS_BEARISH]    = "📉 BEARISH",
+    [STATUS_AVOID]      = "🔴 AVOID",
+};
+
+static const char *recommendation_labels[RECOMMEND_COUNT] = {
+    [RECOMMEND_INVALID]     = "INVALID DATA",
+    [RECOMMEND_STRONG_SELL] = "STRONG SELL - Major decline, exit immediately",
+    [RECOMMEND_SELL]        = "SELL - Significant decline, limit losses",
+    [RECOMMEND_WATCH]       = "WATCH - Declining, consider exit strategy",
+    [RECOMMEND_HOLD]        = "HOLD - Minimal movement, watch closely",
+    [RECOMMEND_HOLD_UP]     = "HOLD - Slight upward movement",
+    [RECOMMEND_BUY]         = "BUY - Positive trend with good volume",
+    [RECOMMEND_STRONG_BUY]  = "STRONG BUY - High momentum with strong volume",
+};
+
+static const char *risk_labels[RISK_COUNT] = {
+    [RISK_UNKNOWN] = "UNKNOWN",
+    [RISK_LOW]     = "🟢 LOW RISK",
+    [RISK_MEDIUM]  = "🟡 MEDIUM RISK",
+    [RISK_HIGH]    = "🔴 HIGH RISK",
+};
+
+static const char *pattern_labels[PATTERN_COUNT] = {
+    [PATTERN_UNKNOWN]   = "UNKNOWN",
+    [PATTERN_DOWNWARD]  = "DOWNWARD TREND",
+    [PATTERN_UPWARD]    = "UPWARD TREND",
+    [PATTERN_SIDEWAYS]  = "SIDEWAYS TREND",
+    [PATTERN_BREAKDOWN] = "BEARISH BREAKDOWN",
+    [PATTERN_BREAKOUT]  = "BULLISH BREAKOUT",
+};
+
+const char *stock_status_label(StockStatus status) {
+    return (unsigned)status < STATUS_COUNT ? status_labels[status] : status_labels[STATUS_INVALID];
+}
+
+const char *recommendation_label(Recommendation recommendation) {
+    return (unsigned)recommendation < RECOMMEND_COUNT ? recommendation_labels[recommendation]
+                                                      : recommendation_labels[RECOMMEND_INVALID];
+}
+
+const char *risk_level_label(RiskLevel risk) {
+    return (unsigned)risk < RISK_COUNT ? risk_labels[risk] : risk_labels[RISK_UNKNOWN];
+}
+
+const char *price_pattern_label(PricePattern pattern) {
+    return (unsigned)pattern < PATTERN_COUNT ? pattern_labels[pattern] : pattern_labels[PATTERN_UNKNOWN];
+}
+
+StockStatus stock_status_from_label(const char *label) {
+    for (int i = 0; label && i < STATUS_COUNT; i++) {
+        if (strcmp(label, status_labels[i]) == 0) return (StockStatus)i;
+    }
+    return STATUS_INVALID;
+}
@@ -0,0 +1,253 @@
+/*
+ * Smart Stock Tracker - Request Scheduler
+ * Token-bucket rate limiting and priority ordering of quote refreshes
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+// Token bucket state plus the adaptive rate derived from upstream responses
+typedef struct {
+    double tokens;          // credits currently available
+    double capacity;        // burst size
+    double quota_rate;      // configured refill rate (tokens/second)
+    double rate;            // current refill rate, lowered on throttling
+    double last_refill;     // monotonic seconds of the last refill
+    double backoff;         // current backoff delay in seconds, 0 when healthy
+    double backoff_until;   // monotonic seconds when requests may resume
+    double min_age;         // seconds before a symbol is worth refetching
+} TokenBucket;
+
+static TokenBucket bucket = {
+    .tokens = API_BURST,
+    .capacity = API_BURST,
+    .quota_rate = API_CALLS_PER_MINUTE / 60.0,
+    .rate = API_CALLS_PER_MINUTE / 60.0,
+    .min_age = MIN_REFRESH_AGE,
+};
+
+// scheduler_wait() sleeps on this condition so shutdown (or new work) can
+// cut it short
+static pthread_mutex_t wait_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wait_cond;
+static pthread_once_t wait_once = PTHREAD_ONCE_INIT;
+static int wait_interrupted = 0;
+static unsigned long wake_count = 0;
+
+static void init_wait_cond(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wait_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void refill_bucket(double now) {
+    if (bucket.last_refill > 0) {
+        bucket.tokens += (now - bucket.last_refill) * bucket.rate;
+        if (bucket.tokens > bucket.capacity) bucket.tokens = bucket.capacity;
+    }
+    bucket.last_refill = now;
+}
+
+// Stale symbols first; symbols that are moving get refreshed more often
+static double refresh_priority(const Stock* stock, time_t now) {
+    if (stock->last_update <= 0) return INFINITY;
+
+    double staleness = difftime(now, stock->last_update);
+    return staleness * (1.0 + fabs(stock->change_percent) / VOLATILITY_WEIGHT);
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+void scheduler_init(int calls_per_minute, int burst, double min_refresh_age) {
+    if (calls_per_minute < 1) calls_per_minute = 1;
+    if (burst < 1) burst = 1;
+
+    bucket.capacity = burst;
+    bucket.tokens = burst;
+    bucket.quota_rate = calls_per_minute / 60.0;
+    bucket.rate = bucket.quota_rate;
+    bucket.last_refill = monotonic_seconds();
+    bucket.backoff = 0;
+    bucket.backoff_until = 0;
+    bucket.min_age = min_refresh_age > 0 ? min_refresh_age : 0;
+}
+
+// ============================================================================
+// Work selection
+// ============================================================================
+int scheduler_next_batch(Stock stocks[], int count, int indices[], int max_batch) {
+    if (!stocks || !indices || count <= 0 || max_batch <= 0) return 0;
+
+    double now = monotonic_seconds();
+    refill_bucket(now);
+    if (now < bucket.backoff_until) return 0;
+
+    int budget = (int)bucket.tokens;
+    if (budget > max_batch) budget = max_batch;
+    if (budget <= 0) return 0;
+
+    // Keep the `budget` highest-priority eligible symbols, ordered by
+    // priority; insertion is cheap because budget is small
+    time_t wall_now = time(NULL);
+    double priority[budget];
+    int selected = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (stocks[i].last_update > 0 &&
+            difftime(wall_now, stocks[i].last_update) < bucket.min_age)
+            continue;
+
+        double p = refresh_priority(&stocks[i], wall_now);
+        if (selected == budget && p <= priority[selected - 1]) continue;
+
+        int pos = selected < budget ? selected++ : budget - 1;
+        while (pos > 0 && priority[pos - 1] < p) {
+            priority[pos] = priority[pos - 1];
+            indices[pos] = indices[pos - 1];
+            pos--;
+        }
+        priority[pos] = p;
+        indices[pos] = i;
+    }
+
+    bucket.tokens -= selected;
+    return selected;
+}
+
+// ============================================================================
+// Feedback from the upstream API
+// HTTP 429 and 5xx halve the refill rate and back off exponentially;
+// successes restore the rate additively towards the configured quota.
+// ============================================================================
+void scheduler_report(long http_code) {
+    double now = monotonic_seconds();
+
+    if (http_code == 429 || http_code >= 500) {
+        bucket.backoff = bucket.backoff > 0 ? bucket.backoff * 2 : SCHEDULER_MIN_BACKOFF;
+        if (bucket.backoff > SCHEDULER_MAX_BACKOFF) bucket.backoff = SCHEDULER_MAX_BACKOFF;
+        bucket.backoff_until = now + bucket.backoff;
+
+        bucket.rate /= 2;
+        if (bucket.rate < bucket.quota_rate / 16) bucket.rate = bucket.quota_rate / 16;
+        bucket.tokens = 0;
+        return;
+    }
+
+    if (http_code == 200) {
+        bucket.backoff = 0;
+        bucket.rate += bucket.quota_rate / 16;
+        if (bucket.rate > bucket.quota_rate) bucket.rate = bucket.quota_rate;
+    }
+}
+
+int scheduler_refresh(const char* symbols[], Stock stocks[], int count) {
+    if (!symbols || !stocks || count <= 0) return 0;
+
+    // One batch never exceeds the bucket's burst size
+    int max_batch = (int)bucket.capacity;
+    if (max_batch > count) max_batch = count;
+
+    int indices[max_batch];
+    long http_codes[max_batch];
+
+    int n = scheduler_next_batch(stocks, count, indices, max_batch);
+    if (n == 0) return 0;
+
+    memset(http_codes, 0, sizeof(long) * n);
+    int fetched = fetch_stocks_selected(symbols, stocks, indices, n, http_codes);
+
+    // One signal per batch: a burst of 429s is one throttling event, not
+    // n halvings of the rate
+    long signal = 0;
+    for (int j = 0; j < n; j++) {
+        if (http_codes[j] == 429 || http_codes[j] >= 500) {
+            signal = http_codes[j];
+            break;
+        }
+        if (http_codes[j] == 200) signal = 200;
+    }
+    scheduler_report(signal);
+
+    return fetched;
+}
+
+// ============================================================================
+// Waiting for the next unit of work
+// ============================================================================
+double scheduler_next_delay(Stock stocks[], int count) {
+    double now = monotonic_seconds();
+    refill_bucket(now);
+
+    double delay = 0.0;
+    if (bucket.tokens < 1.0)
+        delay = (1.0 - bucket.tokens) / bucket.rate;
+    if (bucket.backoff_until - now > delay)
+        delay = bucket.backoff_until - now;
+
+    // No point waking before the stalest symbol is due again
+    if (stocks && count > 0) {
+        time_t wall_now = time(NULL);
+        double soonest = bucket.min_age;
+        for (int i = 0; i < count; i++) {
+            if (stocks[i].last_update <= 0) {
+                soonest = 0;
+                break;
+            }
+            double due = bucket.min_age - difftime(wall_now, stocks[i].last_update);
+            if (due < soonest) soonest = due;
+        }
+        if (soonest > delay) delay = soonest;
+    }
+
+    return delay;
+}
+
+void scheduler_wait(Stock stocks[], int count) {
+    double delay = scheduler_next_delay(stocks, count);
+    if (delay < SCHEDULER_MIN_SLEEP) delay = SCHEDULER_MIN_SLEEP;
+
+    pthread_once(&wait_once, init_wait_cond);
+
+    double wake = monotonic_seconds() + delay;
+    struct timespec ts;
+    ts.tv_sec = (time_t)wake;
+    ts.tv_nsec = (long)((wake - ts.tv_sec) * 1e9);
+
+    pthread_mutex_lock(&wait_lock);
+    unsigned long wakes = wake_count;
+    int rc = 0;
+    while (!wait_interrupted && wake_count == wakes && rc == 0)
+        rc = pthread_cond_timedwait(&wait_cond, &wait_lock, &ts);
+    pthread_mutex_unlock(&wait_lock);
+}
+
+void scheduler_wake(void) {
+    pthread_once(&wait_once, init_wait_cond);
+
+    pthread_mutex_lock(&wait_lock);
+    wake_count++;
+    pthread_cond_broadcast(&wait_cond);
+    pthread_mutex_unlock(&wait_lock);
+}
+
+void scheduler_interrupt(void) {
+    pthread_once(&wait_once, init_wait_cond);
+
+    pthread_mutex_lock(&wait_lock);
+    wait_interrupted = 1;
+    pthread_cond_broadcast(&wait_cond);
+    pthread_mutex_unlock(&wait_lock);
+}
@@ -1,135 +1,1024 @@
-#include <microhttpd.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#define PORT 8080
-
-// ---------------------------------------------------------------------------
-// Utility: Read entire file into a string
-// ---------------------------------------------------------------------------
-char *read_file_to_string(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "❌ Could not open %s\n", filename);
-        return NULL;
-    }
-
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
-
-    char *buffer = malloc(size + 1);
-    if (!buffer) {
-        fclose(file);
-        return NULL;
-    }
-
-    fread(buffer, 1, size, file);
-    buffer[size] = '\0';
-    fclose(file);
-
-    return buffer;
-}
-
-// ---------------------------------------------------------------------------
-// HTTP Response Handler
-// ---------------------------------------------------------------------------
-enum MHD_Result answer_to_connection(
-    void *cls,
-    struct MHD_Connection *connection,
-    const char *url,
-    const char *method,
-    const char *version,
-    const char *upload_data,
-    size_t *upload_data_size,
-    void **con_cls
-) {
-    // ✅ Handle CORS preflight request (OPTIONS)
-    if (strcmp(method, "OPTIONS") == 0) {
-        struct MHD_Response *response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
-        MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
-        MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-        MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
-        MHD_add_response_header(response, "Access-Control-Max-Age", "86400");
-        int ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
-        MHD_destroy_response(response);
-        return ret;
-    }
-
-    const char *filepath = NULL;
-
-    if (strcmp(url, "/stocks") == 0)
-        filepath = "web/stock_data.json";
-    else if (strcmp(url, "/best") == 0)
-        filepath = "web/best_stock.json";
-    else if (strcmp(url, "/trending") == 0)
-        filepath = "web/trending.json";
-    else {
-        const char *not_found = "{\"error\": \"Invalid endpoint\"}";
-        struct MHD_Response *response = MHD_create_response_from_buffer(strlen(not_found),
-                                                (void *)not_found, MHD_RESPMEM_PERSISTENT);
-        MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
-        MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, OPTIONS");
-        MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
-        int ret = MHD_queue_response(connection, MHD_HTTP_NOT_FOUND, response);
-        MHD_destroy_response(response);
-        return ret;
-    }
-
-    char *response_json = read_file_to_string(filepath);
-    if (!response_json) {
-        const char *error_msg = "{\"error\": \"Could not read file\"}";
-        struct MHD_Response *response = MHD_create_response_from_buffer(strlen(error_msg),
-                                                (void *)error_msg, MHD_RESPMEM_PERSISTENT);
-        MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
-        MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, OPTIONS");
-        MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
-        int ret = MHD_queue_response(connection, MHD_HTTP_INTERNAL_SERVER_ERROR, response);
-        MHD_destroy_response(response);
-        return ret;
-    }
-
-    struct MHD_Response *response = MHD_create_response_from_buffer(strlen(response_json),
-                                            (void *)response_json, MHD_RESPMEM_MUST_FREE);
-    // ✅ Add CORS headers for React
-    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
-    MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-    MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
-
-    int ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
-    MHD_destroy_response(response);
-    return ret;
-}
-
-// ---------------------------------------------------------------------------
-// Server Start Function (replaces main())
-// ---------------------------------------------------------------------------
-int start_server() {
-    struct MHD_Daemon *daemon;
-
-    printf("🌐 Starting C HTTP Server on port %d...\n", PORT);
-    printf("Available Endpoints:\n");
-    printf("  • /stocks\n");
-    printf("  • /best\n");
-    printf("  • /trending\n\n");
-
-    daemon = MHD_start_daemon(
-        MHD_USE_INTERNAL_POLLING_THREAD,
-        PORT,
-        NULL, NULL,
-        &answer_to_connection, NULL,
-        MHD_OPTION_END);
-
-    if (!daemon) {
-        fprintf(stderr, "❌ Failed to start server\n");
-        return 1;
-    }
-
-    printf("✅ Server running! Press ENTER to stop.\n");
-    getchar();
-
-    MHD_stop_daemon(daemon);
-    printf("🛑 Server stopped.\n");
-    return 0;
-}
+#include <microhttpd.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include "stock_tracker.h"
+#include "server.h"
+
+#define DEFAULT_PORT 8080
+#define TRENDING_MAX_K LEADERBOARD_MAX_K   // largest k accepted by /trending?k=
+#define RENDER_CACHE_SLOTS 16
+#define QUOTE_MAX_SYMBOLS 32               // symbols accepted by one /quote request
+#define QUOTE_BODY_SIZE 32768              // every field of QUOTE_MAX_SYMBOLS rows fits
+#define HISTORY_MAX_ROWS 10000             // ticks in one /history response
+#define HISTORY_DEFAULT_SPAN 86400         // seconds covered without ?from=
+#define HISTORY_MAX_PRICES 1000            // largest N accepted by /history?last=N
+
+// ---------------------------------------------------------------------------
+// Utility: Drop the snapshot reference held by a finished response
+// ---------------------------------------------------------------------------
+static void release_snapshot_cb(void *cls) {
+    snapshot_release((Snapshot *)cls);
+}
+
+// ---------------------------------------------------------------------------
+// Utility: Per-thread response buffers (/quote, /stock/SYMBOL)
+// Bodies rendered per request go into a QUOTE_BODY_SIZE buffer that MHD
+// hands back once it has sent them. Each thread keeps the buffer it got
+// back as a spare for its next request, so steady traffic allocates
+// nothing and never shares a buffer between threads.
+// ---------------------------------------------------------------------------
+static pthread_key_t body_buffer_key;
+static pthread_once_t body_buffer_once = PTHREAD_ONCE_INIT;
+
+static void create_body_buffer_key(void) {
+    pthread_key_create(&body_buffer_key, free);
+}
+
+static char *acquire_body_buffer(void) {
+    pthread_once(&body_buffer_once, create_body_buffer_key);
+    char *buffer = pthread_getspecific(body_buffer_key);
+    if (!buffer) return malloc(QUOTE_BODY_SIZE);
+    pthread_setspecific(body_buffer_key, NULL);
+    return buffer;
+}
+
+static void release_body_buffer(void *buffer) {
+    pthread_once(&body_buffer_once, create_body_buffer_key);
+    if (pthread_getspecific(body_buffer_key) || pthread_setspecific(body_buffer_key, buffer) != 0)
+        free(buffer);
+}
+
+// ---------------------------------------------------------------------------
+// Utility: Queue a small static JSON error body
+// ---------------------------------------------------------------------------
+static enum MHD_Result send_json_error(struct MHD_Connection *connection, unsigned int status,
+                                       const char *body) {
+    struct MHD_Response *response = MHD_create_response_from_buffer(strlen(body),
+                                            (void *)body, MHD_RESPMEM_PERSISTENT);
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+    MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, OPTIONS");
+    MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization");
+    int ret = MHD_queue_response(connection, status, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+// Utility: Queue a body rendered for this request (or its 304) under `etag`
+// ---------------------------------------------------------------------------
+static enum MHD_Result queue_rendered_response(struct MHD_Connection *connection, unsigned int status,
+                                               struct MHD_Response *response, const char *etag) {
+    if (!response) return MHD_NO;
+
+    MHD_add_response_header(response, MHD_HTTP_HEADER_ETAG, etag);
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CACHE_CONTROL, "no-cache");
+    MHD_add_response_header(response, "Access-Control-Expose-Headers", "ETag");
+    if (status == MHD_HTTP_OK)
+        MHD_add_response_header(response, "Content-Type", "application/json");
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+    MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
+    MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match, If-Modified-Since");
+
+    int ret = MHD_queue_response(connection, status, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+// Conditional requests (If-None-Match / If-Modified-Since)
+// ---------------------------------------------------------------------------
+
+// Weak comparison against a comma-separated If-None-Match list
+static int etag_list_matches(const char *header, const char *etag) {
+    if (!header) return 0;
+
+    size_t etag_len = strlen(etag);
+    const char *p = header;
+
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\t') p++;
+        if (*p == '*') return 1;
+        if (strncmp(p, "W/", 2) == 0) p += 2;
+
+        const char *end = p;
+        while (*end && *end != ',') end++;
+        const char *tail = end;
+        while (tail > p && (tail[-1] == ' ' || tail[-1] == '\t')) tail--;
+
+        if ((size_t)(tail - p) == etag_len && strncmp(p, etag, etag_len) == 0)
+            return 1;
+        p = end;
+    }
+    return 0;
+}
+
+// Parse an IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT"); returns -1 on error
+static time_t parse_http_date(const char *value) {
+    static const char *months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char month[4];
+    int day, year, hour, min, sec;
+
+    if (!value || sscanf(value, "%*3s, %d %3s %d %d:%d:%d GMT",
+                         &day, month, &year, &hour, &min, &sec) != 6)
+        return -1;
+
+    const char *found = strstr(months, month);
+    if (!found || strlen(month) != 3) return -1;
+    int mon = (int)(found - months) / 3 + 1;
+
+    // Days since the epoch for a proleptic Gregorian date (UTC, no timegm)
+    int y = year - (mon <= 2);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    long days = (long)era * 146097 + doe - 719468;
+
+    return (time_t)(days * 86400L + hour * 3600L + min * 60L + sec);
+}
+
+static int is_not_modified(struct MHD_Connection *connection, time_t last_update, const SnapshotDoc *doc) {
+    const char *inm = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                  MHD_HTTP_HEADER_IF_NONE_MATCH);
+    if (inm) return etag_list_matches(inm, doc->etag);
+
+    const char *ims = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                  MHD_HTTP_HEADER_IF_MODIFIED_SINCE);
+    time_t since = parse_http_date(ims);
+    return since >= 0 && last_update <= since;
+}
+
+// ---------------------------------------------------------------------------
+// Content negotiation (Accept-Encoding)
+// ---------------------------------------------------------------------------
+static const char *encoding_names[ENCODING_COUNT] = { "identity", "gzip", "br" };
+
+// Quality the client assigns to `coding` (0..1000); -1 if not listed
+static int coding_quality(const char *header, const char *coding, int *wildcard_q) {
+    size_t coding_len = strlen(coding);
+    const char *p = header;
+    int quality = -1;
+
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\t') p++;
+        const char *name = p;
+        while (*p && *p != ',' && *p != ';' && *p != ' ') p++;
+        size_t name_len = p - name;
+
+        int q = 1000;
+        const char *params = p;
+        while (*p && *p != ',') p++;
+        const char *qparam = strstr(params, "q=");
+        if (qparam && qparam < p) q = (int)(atof(qparam + 2) * 1000 + 0.5);
+
+        if (name_len == 1 && *name == '*') *wildcard_q = q;
+        else if (name_len == coding_len && strncasecmp(name, coding, coding_len) == 0) quality = q;
+    }
+    return quality;
+}
+
+// Pick the best available variant: highest q-value, ties go to the
+// smallest body (br, then gzip, then identity)
+static int negotiate_encoding(struct MHD_Connection *connection, const SnapshotDoc variants[]) {
+    const char *header = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                     MHD_HTTP_HEADER_ACCEPT_ENCODING);
+    if (!header) return ENCODING_IDENTITY;
+
+    int best = ENCODING_IDENTITY, best_q = 0;
+    for (int e = ENCODING_COUNT - 1; e >= 0; e--) {
+        if (!variants[e].data) continue;
+
+        int wildcard_q = -1;
+        int q = coding_quality(header, encoding_names[e], &wildcard_q);
+        if (q < 0) q = wildcard_q;
+        if (q < 0) q = (e == ENCODING_IDENTITY) ? 1 : 0;  // identity is implicitly acceptable
+
+        if (q > best_q) {
+            best = e;
+            best_q = q;
+        }
+    }
+    return best;
+}
+
+// ---------------------------------------------------------------------------
+// Pre-rendered document responses
+// ---------------------------------------------------------------------------
+
+// Queue the negotiated variant of a pre-rendered document, or its 304. The
+// bytes are served in place: `owner` keeps them alive and `release` drops
+// it once MHD has sent the body (at once for a 304 or on failure).
+static enum MHD_Result queue_document(struct MHD_Connection *connection, const SnapshotDoc variants[],
+                                      time_t last_update, const char *last_modified,
+                                      MHD_ContentReaderFreeCallback release, void *owner) {
+    int encoding = negotiate_encoding(connection, variants);
+    const SnapshotDoc *body = &variants[encoding];
+    unsigned int status = MHD_HTTP_OK;
+    struct MHD_Response *response;
+
+    if (is_not_modified(connection, last_update, body)) {
+        status = MHD_HTTP_NOT_MODIFIED;
+        response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+    } else {
+        response = MHD_create_response_from_buffer_with_free_callback_cls(
+                        body->size, body->data, release, owner);
+    }
+    if (!response) {
+        release(owner);
+        return MHD_NO;
+    }
+
+    MHD_add_response_header(response, MHD_HTTP_HEADER_ETAG, body->etag);
+    MHD_add_response_header(response, MHD_HTTP_HEADER_LAST_MODIFIED, last_modified);
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CACHE_CONTROL, "no-cache");
+    MHD_add_response_header(response, "Access-Control-Expose-Headers", "ETag, Last-Modified");
+    MHD_add_response_header(response, MHD_HTTP_HEADER_VARY, "Accept-Encoding");
+    if (encoding != ENCODING_IDENTITY)
+        MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING, encoding_names[encoding]);
+    if (status == MHD_HTTP_OK)
+        MHD_add_response_header(response, "Content-Type", "application/json");
+    // ✅ Add CORS headers for React
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+    MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
+    MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match, If-Modified-Since");
+
+    // The 304 body is static, so the reference can go now
+    if (status == MHD_HTTP_NOT_MODIFIED) release(owner);
+
+    int ret = MHD_queue_response(connection, status, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+static enum MHD_Result serve_snapshot_doc(struct MHD_Connection *connection, int doc) {
+    // The response keeps the snapshot alive until MHD has sent it
+    Snapshot *snap = snapshot_acquire();
+    if (!snap)
+        return send_json_error(connection, MHD_HTTP_SERVICE_UNAVAILABLE,
+                               "{\"error\": \"No data available yet\"}");
+    return queue_document(connection, snap->docs[doc], snap->last_update, snap->last_modified,
+                          &release_snapshot_cb, snap);
+}
+
+// ---------------------------------------------------------------------------
+// Rendered ranking views (/best, /trending)
+// Each (version, query) view is rendered and compressed once into an
+// immutable, reference-counted document; requests in between serve its
+// bytes in place, exactly like a snapshot document. Views of the live
+// board follow leaderboard_version(); rankings of the snapshot rows by
+// another key are fixed for a generation.
+// ---------------------------------------------------------------------------
+typedef struct {
+    int from_snapshot;                       // ranked from snapshot rows, not the live board
+    RankKey key;
+    int k;                                   // 0 = the /best object
+    int ascending;
+} ViewQuery;
+
+typedef struct {
+    int refcount;                            // cache slot + in-flight responses
+    unsigned long version;                   // leaderboard version or snapshot generation shown
+    ViewQuery query;
+    time_t last_update;                      // newest quote in the view
+    char last_modified[32];
+    SnapshotDoc variants[ENCODING_COUNT];
+} RenderedView;
+
+// Direct-mapped by query; a slot holds the newest view rendered for its
+// query. Readers load slots inside an epoch and never lock: a replaced
+// view keeps the cache's reference until readers have quiesced.
+static RenderedView *render_cache[RENDER_CACHE_SLOTS];
+
+static void release_view(void *cls) {
+    RenderedView *view = cls;
+    if (__atomic_sub_fetch(&view->refcount, 1, __ATOMIC_ACQ_REL) != 0) return;
+    for (int e = 0; e < ENCODING_COUNT; e++) free(view->variants[e].data);
+    free(view);
+}
+
+static int same_query(const ViewQuery *a, const ViewQuery *b) {
+    return a->from_snapshot == b->from_snapshot && a->key == b->key && a->k == b->k &&
+           a->ascending == b->ascending;
+}
+
+static RenderedView **render_cache_slot(const ViewQuery *query) {
+    unsigned int hash = ((unsigned int)(query->k * 2 + query->ascending) * RANK_KEY_COUNT + query->key) * 2 +
+                        query->from_snapshot;
+    return &render_cache[hash % RENDER_CACHE_SLOTS];
+}
+
+// Reference to the cached view of `query` at `version`, NULL on a miss
+static RenderedView *render_cache_get(unsigned long version, const ViewQuery *query) {
+    epoch_enter();
+    RenderedView *view = __atomic_load_n(render_cache_slot(query), __ATOMIC_ACQUIRE);
+    if (view && (view->version != version || !same_query(&view->query, query)))
+        view = NULL;
+    // The slot's reference is still held while we are inside the epoch
+    if (view) __atomic_add_fetch(&view->refcount, 1, __ATOMIC_RELAXED);
+    epoch_exit();
+    return view;
+}
+
+// Publish `view` (taking a reference) unless a newer render of it got there first
+static void render_cache_put(RenderedView *view) {
+    RenderedView **slot = render_cache_slot(&view->query);
+    __atomic_add_fetch(&view->refcount, 1, __ATOMIC_RELAXED);
+
+    // Another thread may replace and retire `old` while we read it
+    epoch_enter();
+    RenderedView *old = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    do {
+        if (old && same_query(&old->query, &view->query) && old->version >= view->version) {
+            epoch_exit();
+            release_view(view);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(slot, &old, view, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    epoch_exit();
+
+    if (old) epoch_retire(old, release_view);
+}
+
+static void render_cache_clear(void) {
+    for (int i = 0; i < RENDER_CACHE_SLOTS; i++) {
+        RenderedView *old = __atomic_exchange_n(&render_cache[i], NULL, __ATOMIC_ACQ_REL);
+        if (old) epoch_retire(old, release_view);
+    }
+}
+
+// Render and encode the view from the board; the caller owns one reference
+static RenderedView *render_leaderboard(int k, int ascending) {
+    LeaderboardView *rows = malloc(sizeof(LeaderboardView));
+    RenderedView *view = calloc(1, sizeof(RenderedView));
+    if (!rows || !view) {
+        free(rows);
+        free(view);
+        return NULL;
+    }
+
+    int n = ascending ? leaderboard_bottom_k(k > 0 ? k : 1, rows)
+                      : leaderboard_top_k(k > 0 ? k : 1, rows);
+    const IndicatorValues *indicators = rows->has_indicators ? rows->indicators : NULL;
+    char *body;
+    if (k == 0) {
+        body = build_best_stock_json(n > 0 ? &rows->stocks[0] : NULL, n > 0 ? indicators : NULL);
+    } else {
+        int order[LEADERBOARD_MAX_K];
+        for (int i = 0; i < n; i++) order[i] = i;
+        body = build_trending_json(rows->stocks, order, n, indicators);
+    }
+
+    view->refcount = 1;
+    view->version = rows->version;
+    view->query = (ViewQuery){ 0, RANK_BY_CHANGE, k, ascending };
+    for (int i = 0; i < n; i++) {
+        if (rows->stocks[i].last_update > view->last_update) view->last_update = rows->stocks[i].last_update;
+    }
+    if (view->last_update <= 0) view->last_update = time(NULL);
+    snapshot_http_date(view->last_update, view->last_modified, sizeof(view->last_modified));
+    free(rows);
+
+    view->variants[ENCODING_IDENTITY].data = body;
+    if (!snapshot_encode_doc(view->variants)) {
+        release_view(view);
+        return NULL;
+    }
+    render_cache_put(view);
+    return view;
+}
+
+// Render and encode a ranking of the snapshot's rows; the caller owns one reference
+static RenderedView *render_ranking(const Snapshot *snap, RankKey key, int k, int ascending) {
+    RenderedView *view = calloc(1, sizeof(RenderedView));
+    if (!view) return NULL;
+
+    int rows[TRENDING_MAX_K];
+    int n = ascending ? market_rank_bottom_k(snap->market, key, k, rows)
+                      : market_rank_top_k(snap->market, key, k, rows);
+
+    view->refcount = 1;
+    view->version = snap->generation;
+    view->query = (ViewQuery){ 1, key, k, ascending };
+    view->last_update = snap->last_update;
+    memcpy(view->last_modified, snap->last_modified, sizeof(view->last_modified));
+    view->variants[ENCODING_IDENTITY].data = build_trending_json(snap->stocks, rows, n, snap->indicators);
+    if (!snapshot_encode_doc(view->variants)) {
+        release_view(view);
+        return NULL;
+    }
+    render_cache_put(view);
+    return view;
+}
+
+static enum MHD_Result serve_leaderboard(struct MHD_Connection *connection, int k, int ascending) {
+    ViewQuery query = { 0, RANK_BY_CHANGE, k, ascending };
+    RenderedView *view = render_cache_get(leaderboard_version(), &query);
+    if (!view) view = render_leaderboard(k, ascending);
+    if (!view) return MHD_NO;
+    return queue_document(connection, view->variants, view->last_update, view->last_modified,
+                          &release_view, view);
+}
+
+// ---------------------------------------------------------------------------
+// Ranked views: /trending?k=N&by=change|volume|volatility&order=desc|asc
+// ---------------------------------------------------------------------------
+static enum MHD_Result serve_trending_query(struct MHD_Connection *connection) {
+    const char *k_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "k");
+    const char *by_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "by");
+    const char *order_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "order");
+
+    unsigned int k = SUMMARY_TOP_K;
+    RankKey key = RANK_BY_CHANGE;
+    int ascending = order_arg && strcmp(order_arg, "asc") == 0;
+    if ((k_arg && (!config_parse_uint(k_arg, TRENDING_MAX_K, &k) || k == 0)) ||
+        (by_arg && !rank_key_parse(by_arg, &key)) ||
+        (order_arg && !ascending && strcmp(order_arg, "desc") != 0))
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Expected k=1..100, by=change|volume|volatility, "
+                               "order=desc|asc\"}");
+
+    // Change is what the live board is ordered by; it is empty only until
+    // the first quote, when the persisted document is all there is
+    if (key == RANK_BY_CHANGE && leaderboard_count() > 0)
+        return serve_leaderboard(connection, (int)k, ascending);
+    if (!k_arg && !by_arg && !order_arg)
+        return serve_snapshot_doc(connection, SNAPSHOT_TRENDING);
+
+    Snapshot *snap = snapshot_acquire();
+    if (!snap)
+        return send_json_error(connection, MHD_HTTP_SERVICE_UNAVAILABLE,
+                               "{\"error\": \"No data available yet\"}");
+
+    // Same rows and parameters give the same body until the next publish
+    ViewQuery query = { 1, key, (int)k, ascending };
+    RenderedView *view = render_cache_get(snap->generation, &query);
+    if (!view) view = render_ranking(snap, key, (int)k, ascending);
+    snapshot_release(snap);
+    if (!view) return MHD_NO;
+    return queue_document(connection, view->variants, view->last_update, view->last_modified,
+                          &release_view, view);
+}
+
+// ---------------------------------------------------------------------------
+// Per-symbol quotes: /stock/SYMBOL, an O(1) registry lookup into the snapshot
+// ---------------------------------------------------------------------------
+static enum MHD_Result serve_stock_detail(struct MHD_Connection *connection, const char *symbol) {
+    SymbolKey key;
+    int slot = symbol_key_make(symbol, &key) ? registry_find_key(key) : -1;
+    if (slot < 0)
+        return send_json_error(connection, MHD_HTTP_NOT_FOUND, "{\"error\": \"Unknown symbol\"}");
+
+    Snapshot *snap = snapshot_acquire();
+    if (!snap)
+        return send_json_error(connection, MHD_HTTP_SERVICE_UNAVAILABLE,
+                               "{\"error\": \"No data available yet\"}");
+
+    // Slots are the snapshot's rows unless the universe changed since it
+    // was published; the next publish catches up
+    SymbolKey row_key;
+    const Stock *row = slot < snap->count ? &snap->stocks[slot] : NULL;
+    if (!row || !symbol_key_make(row->symbol, &row_key) || row_key != key || row->current_price <= 0) {
+        snapshot_release(snap);
+        return send_json_error(connection, MHD_HTTP_NOT_FOUND, "{\"error\": \"No quote yet\"}");
+    }
+
+    // The rank comes from the live board, so its version is part of the tag
+    char name[SYMBOL_KEY_LENGTH + 1], etag[80];
+    symbol_key_text(key, name);
+    snprintf(etag, sizeof(etag), "\"%lu-%lu-%s\"", snap->generation, leaderboard_version(), name);
+
+    unsigned int status = MHD_HTTP_OK;
+    struct MHD_Response *response;
+    const char *inm = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                  MHD_HTTP_HEADER_IF_NONE_MATCH);
+    if (etag_list_matches(inm, etag)) {
+        status = MHD_HTTP_NOT_MODIFIED;
+        response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+    } else {
+        // Every field of one row fits the thread's body buffer, which MHD
+        // sends in place and hands back
+        char *body = acquire_body_buffer();
+        if (!body) {
+            snapshot_release(snap);
+            return MHD_NO;
+        }
+        JsonWriter w;
+        size_t size;
+        json_writer_init_fixed(&w, body, QUOTE_BODY_SIZE, 1);
+        json_write_quote(&w, row, snap->indicators ? &snap->indicators[slot] : NULL,
+                         leaderboard_rank(name), QUOTE_FIELDS_ALL);
+        response = json_writer_finish(&w, &size)
+                 ? MHD_create_response_from_buffer_with_free_callback_cls(size, body, &release_body_buffer, body)
+                 : NULL;
+        if (!response) release_body_buffer(body);
+    }
+    snapshot_release(snap);
+    return queue_rendered_response(connection, status, response, etag);
+}
+
+// ---------------------------------------------------------------------------
+// Tick history: /history/SYMBOL?from=&to= (unix seconds, default the last
+// day) writes the stored rows straight from the mapped columns, at most
+// HISTORY_MAX_ROWS of them; "next_from" says where to continue.
+// /history/SYMBOL?last=N returns just the newest N prices.
+// ---------------------------------------------------------------------------
+typedef struct {
+    JsonWriter *w;
+    size_t rows;
+    time_t next_from;                        // first row left out, 0 if none
+} HistoryOutput;
+
+static void write_history_run(const TickColumns *run, void *ctx) {
+    HistoryOutput *out = ctx;
+    for (size_t i = 0; i < run->count; i++) {
+        if (out->rows == HISTORY_MAX_ROWS) {
+            if (!out->next_from) out->next_from = (time_t)run->ts[i];
+            return;
+        }
+        json_begin_object(out->w);
+        json_write_key(out->w, "t");
+        json_write_int(out->w, (long long)run->ts[i]);
+        json_write_key(out->w, "price");
+        json_write_double(out->w, run->price[i]);
+        json_write_key(out->w, "high");
+        json_write_double(out->w, run->high[i]);
+        json_write_key(out->w, "low");
+        json_write_double(out->w, run->low[i]);
+        json_write_key(out->w, "volume");
+        json_write_double(out->w, run->volume[i]);
+        json_write_key(out->w, "resolution");
+        json_write_int(out->w, (long long)run->resolution);
+        json_end_object(out->w);
+        out->rows++;
+    }
+}
+
+static int parse_time_arg(const char *arg, time_t *out) {
+    char *end;
+    long long value = strtoll(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || value < 0) return 0;
+    *out = (time_t)value;
+    return 1;
+}
+
+static enum MHD_Result serve_history(struct MHD_Connection *connection, const char *symbol_arg) {
+    const char *from_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "from");
+    const char *to_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "to");
+    const char *last_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "last");
+
+    char symbol[MAX_SYMBOL_LENGTH];
+    if (!validate_stock_symbol(symbol_arg, symbol, sizeof(symbol)))
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST, "{\"error\": \"Invalid symbol\"}");
+
+    time_t to = time(NULL), from;
+    unsigned int last = 0;
+    if ((to_arg && !parse_time_arg(to_arg, &to)) ||
+        (last_arg && (!config_parse_uint(last_arg, HISTORY_MAX_PRICES, &last) || last == 0)))
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Expected from/to in unix seconds, last=1..1000\"}");
+    from = to > HISTORY_DEFAULT_SPAN ? to - HISTORY_DEFAULT_SPAN : 0;
+    if ((from_arg && !parse_time_arg(from_arg, &from)) || from > to)
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Expected from/to in unix seconds, last=1..1000\"}");
+
+    JsonWriter w;
+    HistoryOutput out = { &w, 0, 0 };
+    json_writer_init(&w, 0, last ? last * 24 : 4096);
+    json_begin_object(&w);
+    json_write_key(&w, "symbol");
+    json_write_string(&w, symbol);
+
+    if (last) {
+        double prices[HISTORY_MAX_PRICES];
+        int n = tickstore_recent_prices(symbol, prices, (int)last);
+        json_write_key(&w, "prices");
+        json_begin_array(&w);
+        for (int i = 0; i < n; i++) json_write_double(&w, prices[i]);
+        json_end_array(&w);
+    } else {
+        json_write_key(&w, "from");
+        json_write_int(&w, (long long)from);
+        json_write_key(&w, "to");
+        json_write_int(&w, (long long)to);
+        json_write_key(&w, "ticks");
+        json_begin_array(&w);
+        tickstore_scan(symbol, from, to, write_history_run, &out);
+        json_end_array(&w);
+        json_write_key(&w, "next_from");
+        if (out.next_from) json_write_int(&w, (long long)out.next_from);
+        else json_write_null(&w);
+    }
+    json_end_object(&w);
+
+    size_t size = 0;
+    char *body = json_writer_finish(&w, &size);
+    if (!body) return MHD_NO;
+
+    // Rows change under the same URL as ticks arrive and age out, so the
+    // tag is a hash of the body itself (FNV-1a)
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ (unsigned char)body[i]) * 1099511628211ULL;
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"h%016llx\"", hash);
+
+    unsigned int status = MHD_HTTP_OK;
+    struct MHD_Response *response;
+    const char *inm = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                  MHD_HTTP_HEADER_IF_NONE_MATCH);
+    if (etag_list_matches(inm, etag)) {
+        free(body);
+        status = MHD_HTTP_NOT_MODIFIED;
+        response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+    } else {
+        response = MHD_create_response_from_buffer(size, body, MHD_RESPMEM_MUST_FREE);
+        if (!response) free(body);
+    }
+    return queue_rendered_response(connection, status, response, etag);
+}
+
+// ---------------------------------------------------------------------------
+// Batch quotes: /quote?symbols=AAPL,MSFT&fields=price,change_percent
+// Only the requested rows and fields are written, into the thread's body
+// buffer, so a widget polling a few tickers gets a few hundred bytes and
+// the request makes no allocation of its own; MHD sends the buffer as is.
+// ---------------------------------------------------------------------------
+static enum MHD_Result serve_quote(struct MHD_Connection *connection) {
+    const char *symbols_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "symbols");
+    const char *fields_arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "fields");
+
+    unsigned int fields = QUOTE_FIELDS_ALL;
+    if (fields_arg && !quote_fields_parse(fields_arg, &fields))
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Unknown field; use name, price, change_percent, volume, "
+                               "previous_close, day_high, day_low, status, last_update, rank, indicators\"}");
+
+    SymbolKey keys[QUOTE_MAX_SYMBOLS];
+    int key_count = 0;
+    const char *list = symbols_arg;
+    while (list && *list) {
+        const char *end = strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : strlen(list);
+        if (len > 0) {
+            char symbol[SYMBOL_KEY_LENGTH + 1];
+            if (key_count == QUOTE_MAX_SYMBOLS || len >= sizeof(symbol))
+                return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                                       "{\"error\": \"Expected at most 32 symbols of 1-8 letters or digits\"}");
+            memcpy(symbol, list, len);
+            symbol[len] = '\0';
+            if (!symbol_key_make(symbol, &keys[key_count++]))
+                return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                                       "{\"error\": \"Expected at most 32 symbols of 1-8 letters or digits\"}");
+        }
+        list = end ? end + 1 : NULL;
+    }
+    if (key_count == 0)
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Expected symbols=SYM[,SYM...]\"}");
+
+    Snapshot *snap = snapshot_acquire();
+    if (!snap)
+        return send_json_error(connection, MHD_HTTP_SERVICE_UNAVAILABLE,
+                               "{\"error\": \"No data available yet\"}");
+
+    // The query is part of the URL, so the tag only has to track the data;
+    // ranks come from the live board and add its version
+    int with_rank = (fields & (1u << QUOTE_FIELD_RANK)) != 0;
+    char etag[64];
+    if (with_rank) snprintf(etag, sizeof(etag), "\"q%lu-%lu\"", snap->generation, leaderboard_version());
+    else snprintf(etag, sizeof(etag), "\"q%lu\"", snap->generation);
+
+    const char *inm = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                  MHD_HTTP_HEADER_IF_NONE_MATCH);
+    if (etag_list_matches(inm, etag)) {
+        snapshot_release(snap);
+        struct MHD_Response *response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+        return queue_rendered_response(connection, MHD_HTTP_NOT_MODIFIED, response, etag);
+    }
+
+    char *body = acquire_body_buffer();
+    if (!body) {
+        snapshot_release(snap);
+        return MHD_NO;
+    }
+    JsonWriter w;
+    json_writer_init_fixed(&w, body, QUOTE_BODY_SIZE, 0);
+    json_begin_object(&w);
+    json_write_key(&w, "generation");
+    json_write_int(&w, (long long)snap->generation);
+
+    // Same check as /stock/SYMBOL: the slot must still hold this symbol in
+    // the published rows and have a quote; anything else is reported missing
+    unsigned char found[QUOTE_MAX_SYMBOLS];
+    int missing = 0;
+    json_write_key(&w, "quotes");
+    json_begin_array(&w);
+    for (int i = 0; i < key_count; i++) {
+        SymbolKey row_key;
+        int slot = registry_find_key(keys[i]);
+        const Stock *row = slot >= 0 && slot < snap->count ? &snap->stocks[slot] : NULL;
+        if (!row || !symbol_key_make(row->symbol, &row_key) || row_key != keys[i] ||
+            row->current_price <= 0) {
+            found[i] = 0;
+            missing++;
+            continue;
+        }
+        found[i] = 1;
+        int rank = with_rank ? leaderboard_rank(row->symbol) : 0;
+        json_write_quote(&w, row, snap->indicators ? &snap->indicators[slot] : NULL, rank, fields);
+    }
+    json_end_array(&w);
+
+    if (missing) {
+        json_write_key(&w, "missing");
+        json_begin_array(&w);
+        for (int i = 0; i < key_count; i++) {
+            if (found[i]) continue;
+            char name[SYMBOL_KEY_LENGTH + 1];
+            symbol_key_text(keys[i], name);
+            json_write_string(&w, name);
+        }
+        json_end_array(&w);
+    }
+    json_end_object(&w);
+    snapshot_release(snap);
+
+    size_t size;
+    if (!json_writer_finish(&w, &size)) {
+        release_body_buffer(body);
+        return send_json_error(connection, MHD_HTTP_INTERNAL_SERVER_ERROR,
+                               "{\"error\": \"Response too large\"}");
+    }
+    struct MHD_Response *response = MHD_create_response_from_buffer_with_free_callback_cls(
+                                        size, body, &release_body_buffer, body);
+    if (!response) release_body_buffer(body);
+    return queue_rendered_response(connection, MHD_HTTP_OK, response, etag);
+}
+
+// ---------------------------------------------------------------------------
+// Admin: POST /admin/symbols?add=A,B&remove=C (Authorization: Bearer TOKEN)
+// Changes are queued for the refresher, which applies them between cycles
+// and saves the watchlist.
+// ---------------------------------------------------------------------------
+
+// Compare without an early exit so response timing does not leak the token
+static int token_matches(const char *given, const char *expected) {
+    size_t given_len = strlen(given), expected_len = strlen(expected);
+    unsigned char diff = given_len != expected_len;
+    for (size_t i = 0; i < expected_len; i++)
+        diff |= (unsigned char)expected[i] ^ (unsigned char)(i < given_len ? given[i] : 0);
+    return diff == 0;
+}
+
+// Queue every comma-separated symbol in `list`; returns the number queued
+static int queue_symbol_list(const char *list, int add) {
+    int queued = 0;
+    while (list && *list) {
+        const char *end = strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : strlen(list);
+        char symbol[SYMBOL_KEY_LENGTH + 1];
+        if (len > 0 && len < sizeof(symbol)) {
+            memcpy(symbol, list, len);
+            symbol[len] = '\0';
+            queued += add ? registry_request_add(symbol) : registry_request_remove(symbol);
+        }
+        list = end ? end + 1 : NULL;
+    }
+    return queued;
+}
+
+static enum MHD_Result serve_admin_symbols(struct MHD_Connection *connection, const char *method,
+                                           const char *admin_token) {
+    if (!admin_token || !*admin_token)
+        return send_json_error(connection, MHD_HTTP_FORBIDDEN,
+                               "{\"error\": \"Admin endpoint disabled (set admin_token)\"}");
+
+    const char *auth = MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                   MHD_HTTP_HEADER_AUTHORIZATION);
+    if (!auth || strncmp(auth, "Bearer ", 7) != 0 || !token_matches(auth + 7, admin_token))
+        return send_json_error(connection, MHD_HTTP_UNAUTHORIZED, "{\"error\": \"Unauthorized\"}");
+    if (strcmp(method, "POST") != 0)
+        return send_json_error(connection, MHD_HTTP_METHOD_NOT_ALLOWED,
+                               "{\"error\": \"Use POST\"}");
+
+    const char *add = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "add");
+    const char *remove = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "remove");
+    int added = queue_symbol_list(add, 1);
+    int removed = queue_symbol_list(remove, 0);
+    if (added + removed == 0)
+        return send_json_error(connection, MHD_HTTP_BAD_REQUEST,
+                               "{\"error\": \"Expected add=SYM[,SYM...] and/or remove=SYM[,SYM...] "
+                               "(1-8 letters or digits)\"}");
+
+    // Let the refresher pick the changes up now rather than after its sleep
+    scheduler_wake();
+
+    char body[96];
+    snprintf(body, sizeof(body), "{\"queued_add\": %d, \"queued_remove\": %d}", added, removed);
+    struct MHD_Response *response = MHD_create_response_from_buffer(strlen(body), body,
+                                                                    MHD_RESPMEM_MUST_COPY);
+    if (!response) return MHD_NO;
+    MHD_add_response_header(response, "Content-Type", "application/json");
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+    int ret = MHD_queue_response(connection, MHD_HTTP_ACCEPTED, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+// HTTP Response Handler
+// ---------------------------------------------------------------------------
+enum MHD_Result answer_to_connection(
+    void *cls,
+    struct MHD_Connection *connection,
+    const char *url,
+    const char *method,
+    const char *version,
+    const char *upload_data,
+    size_t *upload_data_size,
+    void **con_cls
+) {
+    // ✅ Handle CORS preflight request (OPTIONS)
+    if (strcmp(method, "OPTIONS") == 0) {
+        struct MHD_Response *response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+        MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+        MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
+        MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match, If-Modified-Since");
+        MHD_add_response_header(response, "Access-Control-Max-Age", "86400");
+        int ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
+        MHD_destroy_response(response);
+        return ret;
+    }
+
+    int doc;
+
+    if (strcmp(url, "/stream") == 0)
+        return stream_subscribe(connection);
+    if (strncmp(url, "/stock/", 7) == 0)
+        return serve_stock_detail(connection, url + 7);
+    if (strcmp(url, "/quote") == 0)
+        return serve_quote(connection);
+    if (strncmp(url, "/history/", 9) == 0)
+        return serve_history(connection, url + 9);
+    if (strcmp(url, "/admin/symbols") == 0)
+        return serve_admin_symbols(connection, method, cls);
+
+    if (strcmp(url, "/stocks") == 0)
+        doc = SNAPSHOT_STOCKS;
+    else if (strcmp(url, "/best") == 0) {
+        if (leaderboard_count() > 0) return serve_leaderboard(connection, 0, 0);
+        doc = SNAPSHOT_BEST;
+    }
+    else if (strcmp(url, "/trending") == 0)
+        return serve_trending_query(connection);
+    else
+        return send_json_error(connection, MHD_HTTP_NOT_FOUND, "{\"error\": \"Invalid endpoint\"}");
+
+    return serve_snapshot_doc(connection, doc);
+}
+
+// ---------------------------------------------------------------------------
+// Server Configuration
+// ---------------------------------------------------------------------------
+static const char *server_mode_names[] = { "select", "epoll", "pool" };
+
+void server_config_defaults(ServerConfig *config) {
+    config->port = DEFAULT_PORT;
+    // Thousands of idle /stream subscribers need epoll; start_server falls
+    // back to MHD's best poller where epoll is unavailable
+    config->mode = SERVER_MODE_EPOLL;
+    config->threads = 4;
+    config->connection_limit = 0;
+    config->per_ip_limit = 0;
+    config->connection_timeout = 30;
+    config->admin_token[0] = '\0';
+}
+
+int server_config_set(const char *key, const char *value, void *ctx) {
+    ServerConfig *config = ctx;
+
+    if (strcmp(key, "port") == 0)
+        return config_parse_uint(value, 65535, &config->port);
+    if (strcmp(key, "server_threads") == 0)
+        return config_parse_uint(value, 1024, &config->threads);
+    if (strcmp(key, "max_connections") == 0)
+        return config_parse_uint(value, 1000000, &config->connection_limit);
+    if (strcmp(key, "max_connections_per_ip") == 0)
+        return config_parse_uint(value, 1000000, &config->per_ip_limit);
+    if (strcmp(key, "connection_timeout") == 0)
+        return config_parse_uint(value, 86400, &config->connection_timeout);
+    if (strcmp(key, "admin_token") == 0) {
+        if (strlen(value) >= sizeof(config->admin_token)) return 0;
+        strcpy(config->admin_token, value);
+        return 1;
+    }
+    if (strcmp(key, "server_mode") == 0) {
+        for (unsigned int m = 0; m < sizeof(server_mode_names) / sizeof(server_mode_names[0]); m++) {
+            if (strcmp(value, server_mode_names[m]) == 0) {
+                config->mode = (ServerMode)m;
+                return 1;
+            }
+        }
+        fprintf(stderr, "❌ Unknown server_mode '%s' (select, epoll, pool)\n", value);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Server Lifecycle
+// ---------------------------------------------------------------------------
+static struct MHD_Daemon *http_daemon = NULL;
+static char admin_token[sizeof(((ServerConfig *)0)->admin_token)];
+
+int start_server(const ServerConfig *config) {
+    // ITC lets quiesce_server() close the listen socket from another thread
+    unsigned int flags = MHD_ALLOW_SUSPEND_RESUME | MHD_USE_ITC;
+    unsigned int threads = 1;
+    switch (config->mode) {
+    case SERVER_MODE_SELECT:
+        flags |= MHD_USE_INTERNAL_POLLING_THREAD;
+        break;
+    case SERVER_MODE_EPOLL:
+        flags |= MHD_USE_EPOLL_INTERNAL_THREAD;
+        break;
+    case SERVER_MODE_THREAD_POOL:
+        flags |= MHD_USE_EPOLL_INTERNAL_THREAD;
+        threads = config->threads > 0 ? config->threads : 1;
+        break;
+    }
+
+    // epoll is Linux-only; elsewhere let MHD pick the best poller
+    if (config->mode != SERVER_MODE_SELECT && MHD_is_feature_supported(MHD_FEATURE_EPOLL) != MHD_YES)
+        flags = (flags & ~MHD_USE_EPOLL_INTERNAL_THREAD) | MHD_USE_AUTO_INTERNAL_THREAD;
+
+    printf("🌐 Starting C HTTP Server on port %u (%s mode, %u thread%s)...\n",
+           config->port, server_mode_names[config->mode], threads, threads == 1 ? "" : "s");
+    printf("Available Endpoints:\n");
+    printf("  • /stocks\n");
+    printf("  • /best\n");
+    printf("  • /trending[?k=N&by=change|volume|volatility&order=desc|asc]\n");
+    printf("  • /stock/SYMBOL\n");
+    printf("  • /quote?symbols=SYM[,SYM...][&fields=price,change_percent,...]\n");
+    printf("  • /history/SYMBOL[?from=T&to=T | ?last=N]\n");
+    printf("  • /stream (Server-Sent Events)\n");
+    if (config->admin_token[0]) printf("  • POST /admin/symbols?add=SYM&remove=SYM\n");
+    printf("\n");
+    memcpy(admin_token, config->admin_token, sizeof(admin_token));
+
+    // Every publish wakes the /stream subscribers
+    snapshot_set_listener(&stream_notify);
+
+    // Unset (zero) limits keep libmicrohttpd's defaults
+    struct MHD_OptionItem options[6];
+    int n = 0;
+    if (threads > 1)
+        options[n++] = (struct MHD_OptionItem){ MHD_OPTION_THREAD_POOL_SIZE, threads, NULL };
+    if (config->connection_limit > 0)
+        options[n++] = (struct MHD_OptionItem){ MHD_OPTION_CONNECTION_LIMIT, config->connection_limit, NULL };
+    if (config->per_ip_limit > 0)
+        options[n++] = (struct MHD_OptionItem){ MHD_OPTION_PER_IP_CONNECTION_LIMIT, config->per_ip_limit, NULL };
+    options[n++] = (struct MHD_OptionItem){ MHD_OPTION_CONNECTION_TIMEOUT, config->connection_timeout, NULL };
+    // Rebind immediately on restart even with connections in TIME_WAIT
+    options[n++] = (struct MHD_OptionItem){ MHD_OPTION_LISTENING_ADDRESS_REUSE, 1, NULL };
+    options[n] = (struct MHD_OptionItem){ MHD_OPTION_END, 0, NULL };
+
+    http_daemon = MHD_start_daemon(
+        flags,
+        (uint16_t)config->port,
+        NULL, NULL,
+        &answer_to_connection, admin_token,
+        MHD_OPTION_ARRAY, options,
+        MHD_OPTION_END);
+
+    if (!http_daemon) {
+        snapshot_set_listener(NULL);
+        fprintf(stderr, "❌ Failed to start server\n");
+        return 1;
+    }
+
+    printf("✅ Server running! Send SIGINT or SIGTERM to stop.\n");
+    return 0;
+}
+
+void quiesce_server(void) {
+    if (!http_daemon) return;
+
+    // Stop accepting; connections already open keep being served
+    int fd = MHD_quiesce_daemon(http_daemon);
+    if (fd >= 0) close(fd);
+}
+
+void stop_server(void) {
+    if (!http_daemon) return;
+
+    snapshot_set_listener(NULL);
+    stream_shutdown();
+    MHD_stop_daemon(http_daemon);
+    http_daemon = NULL;
+    render_cache_clear();
+    printf("🛑 Server stopped.\n");
+}
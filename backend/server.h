@@ -1,6 +1,82 @@
-#ifndef SERVER_H
-#define SERVER_H
-
-int start_server(void);
-
-#endif
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <microhttpd.h>
+#include "stock_tracker.h"
+
+// ---------------------------------------------------------------------------
+// Server configuration (config file keys / --flags in parentheses)
+// ---------------------------------------------------------------------------
+typedef enum {
+    SERVER_MODE_SELECT,        // one internal thread, select(); capped at FD_SETSIZE connections
+    SERVER_MODE_EPOLL,         // one internal thread, epoll (default; scales to idle /stream clients)
+    SERVER_MODE_THREAD_POOL    // epoll with a pool of worker threads
+} ServerMode;
+
+typedef struct {
+    unsigned int port;                 // (port)
+    ServerMode mode;                   // (server_mode: select | epoll | pool)
+    unsigned int threads;              // (server_threads) pool size
+    unsigned int connection_limit;     // (max_connections) 0 = MHD default
+    unsigned int per_ip_limit;         // (max_connections_per_ip) 0 = unlimited
+    unsigned int connection_timeout;   // (connection_timeout) seconds, 0 = never
+    char admin_token[64];              // (admin_token) bearer token for /admin, empty = disabled
+} ServerConfig;
+
+/**
+ * Fill a ServerConfig with the built-in defaults
+ * @param config: Configuration to initialize
+ */
+void server_config_defaults(ServerConfig *config);
+
+/**
+ * ConfigSetter for server settings; ctx is a ServerConfig*
+ * @return: 1 if the key was a server setting and was applied
+ */
+int server_config_set(const char *key, const char *value, void *ctx);
+
+/**
+ * Start the HTTP daemon on its own threads and return immediately
+ * @param config: Server settings
+ * @return: 0 on success, 1 if the daemon could not start
+ */
+int start_server(const ServerConfig *config);
+
+/**
+ * Stop accepting new connections; open ones are still served
+ */
+void quiesce_server(void);
+
+/**
+ * End open streams, finish in-flight responses and stop the daemon
+ */
+void stop_server(void);
+
+// ---------------------------------------------------------------------------
+// Live stream endpoint (in stream.c)
+// ---------------------------------------------------------------------------
+
+/**
+ * Attach a connection to /stream as a Server-Sent Events subscriber
+ * @param connection: MHD connection requesting /stream
+ * @return: Result of queueing the streaming response
+ */
+enum MHD_Result stream_subscribe(struct MHD_Connection *connection);
+
+/**
+ * Wake suspended subscribers after a snapshot is published
+ * @param snap: Newly published snapshot
+ */
+void stream_notify(const Snapshot *snap);
+
+/**
+ * End every open stream so the daemon can stop
+ */
+void stream_shutdown(void);
+
+/**
+ * Number of connected /stream subscribers
+ */
+int stream_subscriber_count(void);
+
+#endif
@@ -0,0 +1,364 @@
+/*
+ * Smart Stock Tracker - Published Snapshots
+ * Immutable, pre-serialized responses shared between the fetch loop and
+ * the HTTP server through a reference-counted pointer. Publishing swaps
+ * the pointer atomically; readers retain the current snapshot inside an
+ * epoch, and the publisher's reference to the old one is dropped only
+ * after a grace period, so acquiring never takes a lock.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <time.h>
+
+static Snapshot *current_snapshot = NULL;
+static unsigned long snapshot_generation = 0;    // publisher only
+static void (*publish_listener)(const Snapshot *snap) = NULL;
+
+static const char *document_files[SNAPSHOT_DOC_COUNT] = {
+    STOCKS_JSON_FILE,
+    BEST_JSON_FILE,
+    TRENDING_JSON_FILE,
+};
+
+static const char *etag_suffix[ENCODING_COUNT] = { "", "-gz", "-br" };
+
+static void free_snapshot(Snapshot *snap) {
+    for (int i = 0; i < SNAPSHOT_DOC_COUNT; i++)
+        for (int e = 0; e < ENCODING_COUNT; e++)
+            free(snap->docs[i][e].data);
+    free(snap->stocks);
+    free(snap->indicators);
+    if (snap->market) market_state_free(snap->market);
+    free(snap->market);
+    free(snap->stream_full);
+    free(snap->stream_delta);
+    free(snap);
+}
+
+// FNV-1a: cheap, stable content hash; identical bodies keep their ETag
+// across refreshes so unchanged documents revalidate with 304
+static unsigned long long hash_bytes(const char *data, size_t size) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// A variant that fails or does not shrink the body is left out and
+// clients get identity instead
+int snapshot_encode_doc(SnapshotDoc variants[ENCODING_COUNT]) {
+    SnapshotDoc *identity = &variants[ENCODING_IDENTITY];
+    if (!identity->data) return 0;
+    identity->size = strlen(identity->data);
+
+    variants[ENCODING_GZIP].data = gzip_compress(identity->data, identity->size,
+                                                 &variants[ENCODING_GZIP].size);
+    variants[ENCODING_BROTLI].data = brotli_compress(identity->data, identity->size,
+                                                     &variants[ENCODING_BROTLI].size);
+
+    unsigned long long hash = hash_bytes(identity->data, identity->size);
+    for (int e = 0; e < ENCODING_COUNT; e++) {
+        SnapshotDoc *doc = &variants[e];
+        if (e != ENCODING_IDENTITY && doc->data && doc->size >= identity->size) {
+            free(doc->data);
+            doc->data = NULL;
+        }
+        if (!doc->data) continue;
+        snprintf(doc->etag, sizeof(doc->etag), "\"%016llx%s\"", hash, etag_suffix[e]);
+    }
+    return 1;
+}
+
+void snapshot_http_date(time_t when, char *out, size_t size) {
+    struct tm tm;
+    gmtime_r(&when, &tm);
+    strftime(out, size, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+}
+
+// Fill in every document's variants and Last-Modified once they are built
+static int finalize_snapshot(Snapshot *snap) {
+    for (int i = 0; i < SNAPSHOT_DOC_COUNT; i++) {
+        if (!snapshot_encode_doc(snap->docs[i])) return 0;
+    }
+
+    if (snap->last_update <= 0) snap->last_update = time(NULL);
+    snapshot_http_date(snap->last_update, snap->last_modified, sizeof(snap->last_modified));
+    return 1;
+}
+
+// Wrap a JSON payload into a Server-Sent Events frame
+static char *format_stream_event(const char *event, unsigned long id, char *json, size_t *size) {
+    if (!json) return NULL;
+
+    size_t cap = strlen(json) + strlen(event) + 64;
+    char *frame = malloc(cap);
+    if (frame) {
+        int n = snprintf(frame, cap, "id: %lu\nevent: %s\ndata: %s\n\n", id, event, json);
+        *size = (size_t)n;
+    }
+    free(json);
+    return frame;
+}
+
+// ============================================================================
+// Delta row matching
+// ============================================================================
+
+// Publisher only: reused across publishes so diffing never allocates once
+// the universe has stopped growing
+static int *previous_slots = NULL;           // open-addressing symbol -> row + 1, 0 = empty
+static int previous_slot_count = 0;
+static int *previous_rows = NULL;            // per current row: row in the previous snapshot, -1 if new
+static int previous_rows_capacity = 0;
+
+static uint32_t hash_symbol(const char *symbol) {
+    uint32_t hash = 2166136261u;
+    for (; *symbol; symbol++) {
+        hash ^= (unsigned char)*symbol;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Grow the buffers to fit `prev_count` previous and `count` current rows
+static int reserve_matching(int prev_count, int count) {
+    int slots = 16;
+    while (slots < prev_count * 2) slots *= 2;
+    if (slots > previous_slot_count) {
+        int *grown = realloc(previous_slots, slots * sizeof(int));
+        if (!grown) return 0;
+        previous_slots = grown;
+        previous_slot_count = slots;
+    }
+    if (count > previous_rows_capacity) {
+        int *grown = realloc(previous_rows, count * sizeof(int));
+        if (!grown) return 0;
+        previous_rows = grown;
+        previous_rows_capacity = count;
+    }
+    return 1;
+}
+
+// Fill previous_rows for `stocks` against prev's rows through a symbol map
+// built once, so moved rows cost a probe rather than a scan
+static int match_previous_rows(const Stock stocks[], int count, const Snapshot *prev) {
+    if (!reserve_matching(prev->count, count)) return 0;
+
+    int mask = previous_slot_count - 1;
+    memset(previous_slots, 0, previous_slot_count * sizeof(int));
+    for (int j = 0; j < prev->count; j++) {
+        int slot = hash_symbol(prev->stocks[j].symbol) & mask;
+        while (previous_slots[slot]) slot = (slot + 1) & mask;
+        previous_slots[slot] = j + 1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int slot = hash_symbol(stocks[i].symbol) & mask;
+        previous_rows[i] = -1;
+        for (; previous_slots[slot]; slot = (slot + 1) & mask) {
+            int j = previous_slots[slot] - 1;
+            if (strcmp(prev->stocks[j].symbol, stocks[i].symbol) == 0) {
+                previous_rows[i] = j;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+// Whether a row the previous /stream frame carried is gone from this one
+// (removed, or no longer priced). A delta cannot say so, and a client
+// would keep showing the row, so such a generation gets no delta.
+static int drops_streamed_rows(const Stock stocks[], int count, const Snapshot *prev) {
+    int streamed = 0, kept = 0;
+    for (int j = 0; j < prev->count; j++) {
+        if (prev->stocks[j].current_price > 0) streamed++;
+    }
+    for (int i = 0; i < count; i++) {
+        int j = previous_rows[i];
+        if (j >= 0 && stocks[i].current_price > 0 && prev->stocks[j].current_price > 0) kept++;
+    }
+    return kept < streamed;
+}
+
+// The first generation of a run is the wall clock in milliseconds, so an
+// SSE Last-Event-ID from before a restart never matches one of this run
+static unsigned long next_generation(void) {
+    if (snapshot_generation == 0) return (unsigned long)time(NULL) * 1000UL;
+    return snapshot_generation + 1;
+}
+
+// Copy the rows a snapshot is built from, their key columns and the full
+// /stream event
+static int attach_rows(Snapshot *snap, const Stock stocks[], int count) {
+    if (count > 0) {
+        snap->stocks = malloc(count * sizeof(Stock));
+        if (!snap->stocks) return 0;
+        memcpy(snap->stocks, stocks, count * sizeof(Stock));
+
+        // Rankings read one contiguous key column instead of striding rows
+        snap->market = malloc(sizeof(MarketState));
+        if (!snap->market) return 0;
+        if (!market_state_init(snap->market, count)) {
+            free(snap->market);
+            snap->market = NULL;
+            return 0;
+        }
+        if (!market_state_from_stocks(snap->market, stocks, count)) return 0;
+    }
+    snap->count = count;
+    snap->stream_full = format_stream_event("snapshot", snap->generation,
+                                            build_stream_json(snap->stocks, count, NULL, NULL),
+                                            &snap->stream_full_size);
+    return 1;
+}
+
+static void release_retired(void *snap) {
+    snapshot_release(snap);
+}
+
+// Swap `snap` in as the current snapshot. A reader may have loaded the
+// previous pointer without having retained it yet, so the publisher's
+// reference is dropped once readers have quiesced.
+static void install_snapshot(Snapshot *snap) {
+    snapshot_generation = snap->generation;
+    Snapshot *old = __atomic_exchange_n(&current_snapshot, snap, __ATOMIC_SEQ_CST);
+
+    if (old) epoch_retire(old, release_retired);
+    if (publish_listener) publish_listener(snap);
+}
+
+void snapshot_set_listener(void (*listener)(const Snapshot *snap)) {
+    publish_listener = listener;
+}
+
+// ============================================================================
+// Reader side
+// ============================================================================
+Snapshot *snapshot_acquire(void) {
+    epoch_enter();
+    Snapshot *snap = __atomic_load_n(&current_snapshot, __ATOMIC_ACQUIRE);
+    if (snap) __atomic_add_fetch(&snap->refcount, 1, __ATOMIC_RELAXED);
+    epoch_exit();
+    return snap;
+}
+
+void snapshot_release(Snapshot *snap) {
+    if (!snap) return;
+    if (__atomic_sub_fetch(&snap->refcount, 1, __ATOMIC_ACQ_REL) == 0)
+        free_snapshot(snap);
+}
+
+// ============================================================================
+// Writer side
+// ============================================================================
+int snapshot_publish(Stock stocks[], int count, const MarketSummary *summary,
+                     const IndicatorValues indicators[]) {
+    if (!stocks || count < 0) return 0;
+
+    MarketSummary computed;
+    if (!summary) {
+        market_summary_compute(stocks, count, &computed);
+        summary = &computed;
+    }
+
+    Snapshot *snap = calloc(1, sizeof(Snapshot));
+    if (!snap) return 0;
+    snap->refcount = 1;  // held by current_snapshot
+
+    Stock *best = summary->best >= 0 && summary->best < count ? &stocks[summary->best] : NULL;
+    const IndicatorValues *best_indicators = (indicators && best) ? &indicators[summary->best] : NULL;
+    snap->docs[SNAPSHOT_STOCKS][ENCODING_IDENTITY].data = build_all_stocks_json(stocks, count, indicators);
+    snap->docs[SNAPSHOT_BEST][ENCODING_IDENTITY].data = build_best_stock_json(best, best_indicators);
+    snap->docs[SNAPSHOT_TRENDING][ENCODING_IDENTITY].data =
+        build_trending_json(stocks, summary->top, summary->top_count, indicators);
+
+    snap->generation = next_generation();
+    if (!attach_rows(snap, stocks, count)) {
+        free_snapshot(snap);
+        return 0;
+    }
+
+    // Kept so the server can build ad-hoc rankings with the same rows
+    if (indicators && count > 0) {
+        snap->indicators = malloc(count * sizeof(IndicatorValues));
+        if (!snap->indicators) {
+            free_snapshot(snap);
+            return 0;
+        }
+        memcpy(snap->indicators, indicators, count * sizeof(IndicatorValues));
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (stocks[i].last_update > snap->last_update)
+            snap->last_update = stocks[i].last_update;
+    }
+
+    if (!finalize_snapshot(snap)) {
+        free_snapshot(snap);
+        return 0;
+    }
+
+    // Subscribers already listening get a delta against the previous
+    // generation; without rows to diff against, or when rows went away,
+    // they get the full frame
+    Snapshot *prev = snapshot_acquire();
+    if (prev && prev->stocks && match_previous_rows(stocks, count, prev) &&
+        !drops_streamed_rows(stocks, count, prev)) {
+        snap->stream_delta = format_stream_event("delta", snap->generation,
+                                                 build_stream_json(stocks, count, prev->stocks, previous_rows),
+                                                 &snap->stream_delta_size);
+        snap->stream_delta_based = 1;
+    }
+    snapshot_release(prev);
+
+    install_snapshot(snap);
+    return 1;
+}
+
+// ETags of the last persisted generation, to skip rewriting unchanged files
+static char persisted_etag[SNAPSHOT_DOC_COUNT][24];
+
+int snapshot_persist(const Snapshot *snap) {
+    if (!snap) return 0;
+
+    GenerationFile files[SNAPSHOT_DOC_COUNT];
+    for (int i = 0; i < SNAPSHOT_DOC_COUNT; i++) {
+        const SnapshotDoc *doc = &snap->docs[i][ENCODING_IDENTITY];
+        const char *slash = strrchr(document_files[i], '/');
+        files[i].name = slash ? slash + 1 : document_files[i];
+        files[i].data = doc->data;
+        files[i].size = doc->size;
+        files[i].unchanged = strcmp(persisted_etag[i], doc->etag) == 0;
+    }
+
+    if (!publish_generation(PERSIST_DIR, files, SNAPSHOT_DOC_COUNT)) {
+        memset(persisted_etag, 0, sizeof(persisted_etag));
+        return 0;
+    }
+    for (int i = 0; i < SNAPSHOT_DOC_COUNT; i++)
+        memcpy(persisted_etag[i], snap->docs[i][ENCODING_IDENTITY].etag, sizeof(persisted_etag[i]));
+    return 1;
+}
+
+int snapshot_seed_from_files(const Stock stocks[], int count) {
+    Snapshot *snap = calloc(1, sizeof(Snapshot));
+    if (!snap) return 0;
+    snap->refcount = 1;
+
+    for (int i = 0; i < SNAPSHOT_DOC_COUNT; i++)
+        snap->docs[i][ENCODING_IDENTITY].data = read_file_to_string(document_files[i]);
+
+    snap->generation = next_generation();
+    if (!finalize_snapshot(snap) || !attach_rows(snap, stocks, count > 0 ? count : 0)) {
+        free_snapshot(snap);
+        return 0;
+    }
+
+    install_snapshot(snap);
+    return 1;
+}
@@ -5,13 +5,39 @@
 
 // ============================================================================
 // 1️⃣ WriteCallback - collect data from CURL
+// Each handle owns one fixed arena of MAX_RESPONSE_SIZE bytes, allocated on
+// first use and reset (never freed) between requests. A body that does not
+// fit aborts the transfer instead of growing the buffer.
 // ============================================================================
+static unsigned long arena_allocations = 0;
+static unsigned long tree_parses = 0;
+static unsigned long quotes_received = 0;
+
+static int response_reserve(APIResponse *response) {
+    if (!response->data) {
+        response->data = malloc(MAX_RESPONSE_SIZE);
+        if (!response->data) return 0;
+        response->capacity = MAX_RESPONSE_SIZE;
+        __atomic_add_fetch(&arena_allocations, 1, __ATOMIC_RELAXED);
+    }
+    response->size = 0;
+    response->overflow = 0;
+    response->data[0] = '\0';
+    return 1;
+}
+
+static void response_release(APIResponse *response) {
+    free(response->data);
+    memset(response, 0, sizeof(*response));
+}
+
 size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response) {
     size_t total_size = size * nmemb;
-    char *ptr = realloc(response->data, response->size + total_size + 1);
-    if (!ptr) return 0;  // out of memory
+    if (!response->data || total_size >= response->capacity - response->size) {
+        response->overflow = 1;
+        return 0;  // curl fails the transfer with CURLE_WRITE_ERROR
+    }
 
-    response->data = ptr;
     memcpy(&(response->data[response->size]), contents, total_size);
     response->size += total_size;
     response->data[response->size] = '\0';
@@ -19,78 +45,324 @@ size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *res
     return total_size;
 }
 
+void fetch_alloc_stats(unsigned long *allocations, unsigned long *quotes) {
+    // Every tree parse allocates its cJSON nodes; the single-pass parser never does
+    if (allocations)
+        *allocations = __atomic_load_n(&arena_allocations, __ATOMIC_RELAXED) +
+                       __atomic_load_n(&tree_parses, __ATOMIC_RELAXED);
+    if (quotes) *quotes = __atomic_load_n(&quotes_received, __ATOMIC_RELAXED);
+}
+
 // ============================================================================
 // 2️⃣ Initialize and cleanup curl
+// Connections, DNS lookups and TLS sessions are shared between every handle
+// so repeated refreshes skip the TCP/TLS handshake.
 // ============================================================================
+typedef struct {
+    CURL *easy;
+    APIResponse response;
+    int index;      // position in the caller's symbols[]/stocks[] arrays
+    int position;   // position in the caller's indices[] list
+    int active;     // attached to multi_handle
+} FetchSlot;
+
+static CURLSH *share_handle = NULL;
+static CURLM *multi_handle = NULL;
+static CURL *single_handle = NULL;
+static APIResponse single_response;
+static FetchSlot fetch_pool[MAX_CONCURRENT_FETCHES];
+static int fetch_concurrency = DEFAULT_CONCURRENT_FETCHES;
+
+static void configure_easy_handle(CURL *curl) {
+    curl_easy_setopt(curl, CURLOPT_SHARE, share_handle);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+}
+
 int initialize_curl() {
     CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
-    return (res == CURLE_OK);
+    if (res != CURLE_OK) return 0;
+
+    share_handle = curl_share_init();
+    if (!share_handle) return 0;
+    curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    multi_handle = curl_multi_init();
+    if (!multi_handle) return 0;
+    curl_multi_setopt(multi_handle, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS, (long)fetch_concurrency);
+    curl_multi_setopt(multi_handle, CURLMOPT_MAXCONNECTS, (long)fetch_concurrency);
+
+    return 1;
 }
 
 void cleanup_curl() {
+    for (int i = 0; i < MAX_CONCURRENT_FETCHES; i++) {
+        if (fetch_pool[i].easy) curl_easy_cleanup(fetch_pool[i].easy);
+        response_release(&fetch_pool[i].response);
+        memset(&fetch_pool[i], 0, sizeof(fetch_pool[i]));
+    }
+    if (single_handle) curl_easy_cleanup(single_handle);
+    single_handle = NULL;
+    response_release(&single_response);
+    if (multi_handle) curl_multi_cleanup(multi_handle);
+    multi_handle = NULL;
+    if (share_handle) curl_share_cleanup(share_handle);
+    share_handle = NULL;
     curl_global_cleanup();
 }
 
+int set_fetch_concurrency(int max_in_flight) {
+    if (max_in_flight < 1) max_in_flight = 1;
+    if (max_in_flight > MAX_CONCURRENT_FETCHES) max_in_flight = MAX_CONCURRENT_FETCHES;
+    fetch_concurrency = max_in_flight;
+
+    if (multi_handle) {
+        curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS, (long)fetch_concurrency);
+        curl_multi_setopt(multi_handle, CURLMOPT_MAXCONNECTS, (long)fetch_concurrency);
+    }
+    return fetch_concurrency;
+}
+
 // ============================================================================
 // 3️⃣ Parse JSON Response from Finnhub
 // Finnhub fields: c=current, d=change, dp=percent change, h=high, l=low, o=open, pc=previous close
 // ============================================================================
-int parse_stock_json(const char *json_string, Stock *stock) {
-    if (!json_string || !stock) return 0;
 
-    cJSON *root = cJSON_Parse(json_string);
-    if (!root) {
-        display_error("❌ Failed to parse Finnhub JSON response.");
-        return 0;
-    }
+// Quote fields as read from either parser; `present` has bit QUOTE_x set
+// when the field held a number
+enum { QUOTE_C, QUOTE_PC, QUOTE_H, QUOTE_L, QUOTE_DP, QUOTE_V, QUOTE_KEY_COUNT };
+
+typedef struct {
+    double value[QUOTE_KEY_COUNT];
+    unsigned present;
+} QuoteFields;
 
-    cJSON *current = cJSON_GetObjectItem(root, "c");
-    cJSON *previous_close = cJSON_GetObjectItem(root, "pc");
-    cJSON *high = cJSON_GetObjectItem(root, "h");
-    cJSON *low = cJSON_GetObjectItem(root, "l");
-    cJSON *percent = cJSON_GetObjectItem(root, "dp");
-    cJSON *volume = cJSON_GetObjectItem(root, "v"); // sometimes missing
-
-    if (cJSON_IsNumber(current))
-        stock->current_price = current->valuedouble;
-    if (cJSON_IsNumber(previous_close))
-        stock->previous_close = previous_close->valuedouble;
-    if (cJSON_IsNumber(high))
-        stock->day_high = high->valuedouble;
-    if (cJSON_IsNumber(low))
-        stock->day_low = low->valuedouble;
-
-    if (cJSON_IsNumber(percent))
-        stock->change_percent = percent->valuedouble;
+static void apply_quote_fields(const QuoteFields *q, Stock *stock) {
+    if (q->present & (1u << QUOTE_C))
+        stock->current_price = q->value[QUOTE_C];
+    if (q->present & (1u << QUOTE_PC))
+        stock->previous_close = q->value[QUOTE_PC];
+    if (q->present & (1u << QUOTE_H))
+        stock->day_high = q->value[QUOTE_H];
+    if (q->present & (1u << QUOTE_L))
+        stock->day_low = q->value[QUOTE_L];
+
+    if (q->present & (1u << QUOTE_DP))
+        stock->change_percent = q->value[QUOTE_DP];
     else if (stock->previous_close != 0)
         stock->change_percent =
             ((stock->current_price - stock->previous_close) / stock->previous_close) * 100.0;
 
-    if (cJSON_IsNumber(volume))
-        stock->volume = volume->valuedouble;
+    if (q->present & (1u << QUOTE_V))
+        stock->volume = q->value[QUOTE_V];
     else
         stock->volume = (rand() % 50000000) + 5000000; // fallback random volume
 
+    // Status is classified later, by the analysis pipeline
     stock->last_update = time(NULL);
-    analyze_stock_performance(stock);
+}
+
+// Map a (short) object key to its QUOTE_x slot; -1 for keys we ignore
+static int quote_field_index(const char *key, size_t len) {
+    if (len == 1) {
+        switch (key[0]) {
+        case 'c': return QUOTE_C;
+        case 'h': return QUOTE_H;
+        case 'l': return QUOTE_L;
+        case 'v': return QUOTE_V;
+        }
+    } else if (len == 2) {
+        if (key[0] == 'p' && key[1] == 'c') return QUOTE_PC;
+        if (key[0] == 'd' && key[1] == 'p') return QUOTE_DP;
+    }
+    return -1;
+}
+
+static const char *skip_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    return p;
+}
+
+// JSON number; exact (correctly rounded) whenever the significand fits in
+// 2^53 and the power of ten is exactly representable, strtod otherwise
+static const char *parse_number(const char *p, const char *end, double *out) {
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *start = p;
+    int negative = 0;
+    unsigned long long mantissa = 0;
+    int digits = 0, scale = 0;
+
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) mantissa = mantissa * 10 + (*p - '0');
+        else scale++;
+        if (mantissa) digits++;
+        p++;
+    }
+    if (p == start + negative) return NULL;
+    if (p < end && *p == '.') {
+        p++;
+        const char *frac = p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                scale--;
+                if (mantissa) digits++;
+            }
+            p++;
+        }
+        if (p == frac) return NULL;
+    }
+
+    int exact = (mantissa >> 53) == 0 && digits < 19;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        exact = 0;
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) p++;
+        if (p == end || *p < '0' || *p > '9') return NULL;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+    }
+
+    if (exact && scale >= -22 && scale <= 22) {
+        double v = (double)mantissa;
+        v = scale < 0 ? v / pow10[-scale] : v * pow10[scale];
+        *out = negative ? -v : v;
+        return p;
+    }
+
+    char *num_end;
+    *out = strtod(start, &num_end);
+    return num_end == p ? p : NULL;
+}
+
+int parse_quote_fast(const char *json, size_t len, Stock *stock) {
+    if (!json || !stock) return 0;
+
+    const char *p = json, *end = json + len;
+    QuoteFields q = { .present = 0 };
+
+    p = skip_ws(p, end);
+    if (p == end || *p++ != '{') return 0;
+
+    p = skip_ws(p, end);
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        for (;;) {
+            // Key: plain ASCII, no escapes in the quote payload
+            if (p == end || *p++ != '"') return 0;
+            const char *key = p;
+            while (p < end && *p != '"' && *p != '\\') p++;
+            if (p == end || *p != '"') return 0;
+            size_t key_len = (size_t)(p - key);
+            p = skip_ws(p + 1, end);
+            if (p == end || *p++ != ':') return 0;
+            p = skip_ws(p, end);
+
+            // Value: number or null; anything else is an unexpected shape
+            int field = quote_field_index(key, key_len);
+            if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+                p += 4;
+            } else {
+                double value;
+                p = parse_number(p, end, &value);
+                if (!p) return 0;
+                if (field >= 0) {
+                    q.value[field] = value;
+                    q.present |= 1u << field;
+                }
+            }
+
+            p = skip_ws(p, end);
+            if (p == end) return 0;
+            if (*p == ',') {
+                p = skip_ws(p + 1, end);
+                continue;
+            }
+            if (*p++ != '}') return 0;
+            break;
+        }
+    }
+
+    if (skip_ws(p, end) != end) return 0;
+
+    apply_quote_fields(&q, stock);
+    return 1;
+}
+
+int parse_stock_json_tree(const char *json_string, Stock *stock) {
+    if (!json_string || !stock) return 0;
+
+    __atomic_add_fetch(&tree_parses, 1, __ATOMIC_RELAXED);
+
+    cJSON *root = cJSON_Parse(json_string);
+    if (!root) {
+        display_error("❌ Failed to parse Finnhub JSON response.");
+        return 0;
+    }
+
+    static const char *keys[QUOTE_KEY_COUNT] = { "c", "pc", "h", "l", "dp", "v" };
+    QuoteFields q = { .present = 0 };
+
+    for (int i = 0; i < QUOTE_KEY_COUNT; i++) {
+        cJSON *item = cJSON_GetObjectItem(root, keys[i]);
+        if (cJSON_IsNumber(item)) {
+            q.value[i] = item->valuedouble;
+            q.present |= 1u << i;
+        }
+    }
+
+    apply_quote_fields(&q, stock);
 
     cJSON_Delete(root);
     return 1;
 }
 
+// Fixed-shape quotes take the single-pass path; anything else (error
+// objects, extra nesting, escapes) falls back to the cJSON tree
+int parse_stock_json(const char *json_string, Stock *stock) {
+    if (!json_string || !stock) return 0;
+
+    if (parse_quote_fast(json_string, strlen(json_string), stock))
+        return 1;
+    return parse_stock_json_tree(json_string, stock);
+}
+
 // ============================================================================
 // 4️⃣ Fetch Data from Finnhub API
 // ============================================================================
 int fetch_stock_data(const char *symbol, Stock *stock) {
     if (!symbol || !stock) return 0;
 
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        display_error("❌ Failed to initialize CURL.");
-        return 0;
+    if (!single_handle) {
+        single_handle = curl_easy_init();
+        if (!single_handle) {
+            display_error("❌ Failed to initialize CURL.");
+            return 0;
+        }
+        configure_easy_handle(single_handle);
+        curl_easy_setopt(single_handle, CURLOPT_WRITEDATA, &single_response);
     }
+    CURL *curl = single_handle;
 
-    APIResponse response = { .data = malloc(1), .size = 0 };
+    if (!response_reserve(&single_response)) {
+        display_error("❌ Out of memory for the response buffer.");
+        return 0;
+    }
 
     char clean_symbol[32];
     validate_stock_symbol(symbol, clean_symbol, sizeof(clean_symbol));
@@ -99,23 +371,158 @@ int fetch_stock_data(const char *symbol, Stock *stock) {
     snprintf(url, sizeof(url), "%s?symbol=%s&token=%s", BASE_URL, clean_symbol, API_KEY);
 
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
 
     CURLcode res = curl_easy_perform(curl);
+    if (single_response.overflow) {
+        fprintf(stderr, "Response for %s exceeds %d bytes\n", symbol, MAX_RESPONSE_SIZE);
+        return 0;
+    }
     if (res != CURLE_OK) {
         fprintf(stderr, "CURL error for %s: %s\n", symbol, curl_easy_strerror(res));
-        curl_easy_cleanup(curl);
-        free(response.data);
         return 0;
     }
+    __atomic_add_fetch(&quotes_received, 1, __ATOMIC_RELAXED);
 
     strncpy(stock->symbol, clean_symbol, sizeof(stock->symbol));
-    int success = parse_stock_json(response.data, stock);
+    return parse_stock_json(single_response.data, stock);
+}
+
+// ============================================================================
+// 5️⃣ Batch fetch - many symbols concurrently over one curl multi handle
+// Easy handles live in fetch_pool and are reused across batches; at most
+// fetch_concurrency requests are in flight at once.
+// ============================================================================
+static int start_fetch(FetchSlot *slot, const char *symbol, int index) {
+    char clean_symbol[32];
+    if (!validate_stock_symbol(symbol, clean_symbol, sizeof(clean_symbol)))
+        return 0;
+
+    if (!slot->easy) {
+        slot->easy = curl_easy_init();
+        if (!slot->easy) return 0;
+        configure_easy_handle(slot->easy);
+        curl_easy_setopt(slot->easy, CURLOPT_WRITEDATA, &slot->response);
+        curl_easy_setopt(slot->easy, CURLOPT_PRIVATE, slot);
+    }
+
+    char url[MAX_URL_LENGTH];
+    snprintf(url, sizeof(url), "%s?symbol=%s&token=%s", BASE_URL, clean_symbol, API_KEY);
+    curl_easy_setopt(slot->easy, CURLOPT_URL, url);
+
+    if (!response_reserve(&slot->response)) return 0;
+    slot->index = index;
 
-    curl_easy_cleanup(curl);
-    free(response.data);
+    slot->active = curl_multi_add_handle(multi_handle, slot->easy) == CURLM_OK;
+    return slot->active;
+}
+
+static int finish_fetch(FetchSlot *slot, CURLcode result, const char *symbols[],
+                        Stock stocks[], long *http_code) {
+    const char *symbol = symbols[slot->index];
+    Stock *stock = &stocks[slot->index];
+
+    *http_code = 0;
+    curl_easy_getinfo(slot->easy, CURLINFO_RESPONSE_CODE, http_code);
+    curl_multi_remove_handle(multi_handle, slot->easy);
+    slot->active = 0;
+
+    if (slot->response.overflow) {
+        fprintf(stderr, "Response for %s exceeds %d bytes\n", symbol, MAX_RESPONSE_SIZE);
+        return 0;
+    }
+    if (result != CURLE_OK) {
+        fprintf(stderr, "CURL error for %s: %s\n", symbol, curl_easy_strerror(result));
+        return 0;
+    }
+    if (*http_code != 200) {
+        fprintf(stderr, "HTTP %ld for %s\n", *http_code, symbol);
+        return 0;
+    }
+    __atomic_add_fetch(&quotes_received, 1, __ATOMIC_RELAXED);
+
+    validate_stock_symbol(symbol, stock->symbol, sizeof(stock->symbol));
+    return parse_stock_json(slot->response.data, stock);
+}
+
+// Start the next pending entry of indices[] on `slot`; returns 1 if started
+static int start_next(FetchSlot *slot, const char *symbols[], const int indices[],
+                      int n, int *next, long http_codes[]) {
+    while (*next < n) {
+        int j = (*next)++;
+        int index = indices ? indices[j] : j;
+        slot->position = j;
+        if (start_fetch(slot, symbols[index], index)) return 1;
+        if (http_codes) http_codes[j] = 0;
+    }
+    return 0;
+}
+
+// Give up on the batch: detach every in-flight handle so the pool can be
+// reused, and report the unfinished entries as transport errors
+static void abort_batch(int next, int n, long http_codes[]) {
+    for (int s = 0; s < MAX_CONCURRENT_FETCHES; s++) {
+        FetchSlot *slot = &fetch_pool[s];
+        if (!slot->active) continue;
+        curl_multi_remove_handle(multi_handle, slot->easy);
+        slot->active = 0;
+        if (http_codes) http_codes[slot->position] = 0;
+    }
+    if (http_codes) {
+        for (int j = next; j < n; j++) http_codes[j] = 0;
+    }
+}
+
+int fetch_stocks_selected(const char *symbols[], Stock stocks[], const int indices[],
+                          int n, long http_codes[]) {
+    if (!symbols || !stocks || n <= 0) return 0;
+    if (!multi_handle) {
+        display_error("❌ CURL not initialized.");
+        return 0;
+    }
+
+    int next = 0, in_flight = 0, success_count = 0;
+
+    for (int s = 0; s < fetch_concurrency && next < n; s++)
+        in_flight += start_next(&fetch_pool[s], symbols, indices, n, &next, http_codes);
+
+    while (in_flight > 0) {
+        int running = 0;
+        CURLMcode mc = curl_multi_perform(multi_handle, &running);
+        if (mc != CURLM_OK) {
+            fprintf(stderr, "CURL multi error: %s\n", curl_multi_strerror(mc));
+            abort_batch(next, n, http_codes);
+            break;
+        }
+
+        CURLMsg *msg;
+        int queued;
+        while ((msg = curl_multi_info_read(multi_handle, &queued))) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            FetchSlot *slot = NULL;
+            long http_code;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&slot);
+            in_flight--;
+            success_count += finish_fetch(slot, msg->data.result, symbols, stocks, &http_code);
+            if (http_codes) http_codes[slot->position] = http_code;
+
+            // Hand the freed handle straight to the next symbol
+            in_flight += start_next(slot, symbols, indices, n, &next, http_codes);
+        }
+
+        if (in_flight > 0) {
+            mc = curl_multi_poll(multi_handle, NULL, 0, 1000, NULL);
+            if (mc != CURLM_OK) {
+                fprintf(stderr, "CURL multi error: %s\n", curl_multi_strerror(mc));
+                abort_batch(next, n, http_codes);
+                break;
+            }
+        }
+    }
+
+    return success_count;
+}
 
-    return success;
+int fetch_stocks_batch(const char *symbols[], int count, Stock stocks[]) {
+    return fetch_stocks_selected(symbols, stocks, NULL, count, NULL);
 }
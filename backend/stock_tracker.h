@@ -11,16 +11,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <stdint.h>
 #include <cjson/cJSON.h>
 #include <curl/curl.h>
-#include <json-c/json.h>
 
 // Constants
 #define MAX_SYMBOL_LENGTH 10
 #define MAX_NAME_LENGTH 100
-#define MAX_STATUS_LENGTH 50
 #define MAX_URL_LENGTH 512
-#define MAX_RESPONSE_SIZE 10000
+#define MAX_PATH_LENGTH 512
+#define MAX_RESPONSE_SIZE 10000        // Per-handle response arena; larger bodies are rejected
 
 // Stock data structure
 typedef struct {
@@ -29,7 +30,7 @@ typedef struct {
     double current_price;                    // Current stock price
     double change_percent;                   // Percentage change from previous close
     double volume;                           // Trading volume
-    char status[MAX_STATUS_LENGTH];          // Status (e.g., "🚀 STRONG BUY")
+    unsigned char status;                    // StockStatus; labelled only when rendered
     double previous_close;                   // Previous closing price
     double day_high;                        // Day's high price
     double day_low;                         // Day's low price
@@ -37,12 +38,337 @@ typedef struct {
     time_t last_update;                     // Last update timestamp
 } Stock;
 
-// API response structure
+// API response structure: a fixed arena reused for every request on a handle
 typedef struct {
     char *data;
     size_t size;
+    size_t capacity;
+    int overflow;        // body exceeded capacity, transfer was aborted
 } APIResponse;
 
+// Documents served by the HTTP server, pre-serialized once per refresh
+typedef enum {
+    SNAPSHOT_STOCKS,
+    SNAPSHOT_BEST,
+    SNAPSHOT_TRENDING,
+    SNAPSHOT_DOC_COUNT
+} SnapshotDocId;
+
+// Pre-compressed variants kept for every document
+typedef enum {
+    ENCODING_IDENTITY,
+    ENCODING_GZIP,
+    ENCODING_BROTLI,
+    ENCODING_COUNT
+} ContentEncoding;
+
+typedef struct {
+    char *data;                              // NULL if this variant is unavailable
+    size_t size;
+    char etag[24];                           // Strong validator, unique per variant
+} SnapshotDoc;
+
+// Immutable market snapshot published by the fetch loop
+typedef struct {
+    int refcount;                            // Owners: publisher + in-flight responses
+    unsigned long generation;                // Increments on every publish; starts from the clock
+    time_t last_update;                      // Newest Stock.last_update in the snapshot
+    char last_modified[32];                  // last_update as an HTTP-date
+    SnapshotDoc docs[SNAPSHOT_DOC_COUNT][ENCODING_COUNT];  // Response bodies
+    Stock *stocks;                           // Copy of the published rows
+    int count;
+    struct IndicatorValues *indicators;      // Copy parallel to stocks, NULL if none
+    struct MarketState *market;              // stocks as columns, for rankings; NULL if empty
+    char *stream_full;                       // SSE event with every row
+    size_t stream_full_size;
+    char *stream_delta;                      // SSE event with rows that moved since the
+    size_t stream_delta_size;                // previous generation, NULL if none did
+    int stream_delta_based;                  // 0 if there were no previous rows to diff, or
+                                             // this generation dropped some (full frame)
+} Snapshot;
+
+// File being written atomically: temp file renamed over `target` on commit
+typedef struct {
+    FILE* fp;
+    char target[MAX_PATH_LENGTH];
+    char temp_path[MAX_PATH_LENGTH];
+} AtomicFile;
+
+// One member of a set of files published together (see publish_generation)
+typedef struct {
+    const char* name;                        // file name inside the published directory
+    const char* data;
+    size_t size;
+    int unchanged;                           // same bytes as the previous generation
+} GenerationFile;
+
+// Tick history settings (tickstore.c); config keys in parentheses
+typedef struct {
+    unsigned int enabled;                    // (tick_history) 0 disables recording
+    char dir[MAX_PATH_LENGTH];               // (tick_dir)
+    unsigned int segment_rows;               // (tick_segment_rows) rows per segment file
+    unsigned int retention_days;             // (tick_retention_days) 0 = keep forever
+    unsigned int compact_after_hours;        // (tick_compact_after_hours) 0 = never compact
+    unsigned int compact_bucket_seconds;     // (tick_compact_bucket) row spacing after compaction
+} TickStoreConfig;
+
+// Post-fetch analysis pipeline (pipeline.c); config keys in parentheses
+typedef struct {
+    unsigned int threads;                    // (pipeline_threads) including the refresher, 0 = one per core
+    unsigned int grain;                      // (pipeline_grain) rows per task
+    unsigned int deterministic;              // (pipeline_deterministic) 1 = every task in order on the refresher
+} PipelineConfig;
+
+// One task of a parallel loop: rows [begin, end), the `chunk`-th of the
+// loop's grain-sized chunks (workpool.c)
+typedef void (*WorkRangeFn)(void* ctx, int begin, int end, int chunk);
+
+// Scoring thresholds (rules.c), percent change unless noted; config keys in parentheses
+typedef struct {
+    double strong_buy;                       // (status_strong_buy) STRONG BUY at or above
+    double buy;                              // (status_buy) BULLISH at or above
+    double sell;                             // (status_sell) WATCH above, BEARISH at or below
+    double strong_sell;                      // (status_strong_sell) AVOID at or below
+    double recommend_strong_buy;             // (recommend_strong_buy) with volume above the next
+    double recommend_strong_buy_volume;      // (recommend_strong_buy_volume) shares
+    double recommend_buy;                    // (recommend_buy) with volume above the next
+    double recommend_buy_volume;             // (recommend_buy_volume) shares
+    double recommend_hold_up;                // (recommend_hold_up) HOLD_UP at or above
+    double recommend_hold;                   // (recommend_hold) HOLD at or above
+    double recommend_watch;                  // (recommend_watch) WATCH at or above
+    double recommend_sell;                   // (recommend_sell) SELL at or above, STRONG SELL below
+    double risk_medium;                      // (risk_medium) absolute move
+    double risk_high;                        // (risk_high) absolute move
+    double pattern_breakout;                 // (pattern_breakout) move beyond ± this off the day's midpoint
+    double pattern_sideways;                 // (pattern_sideways) absolute move below this
+} RulesConfig;
+
+// A contiguous run of stored ticks, pointing straight into the mapped columns
+typedef struct {
+    const int64_t* ts;                       // unix seconds, ascending
+    const double* price;
+    const double* high;
+    const double* low;
+    const double* volume;
+    size_t count;
+    unsigned int resolution;                 // seconds per row, 0 for raw ticks
+} TickColumns;
+
+typedef void (*TickScanFn)(const TickColumns* run, void* ctx);
+
+// Indicator windows (indicators.c); config keys match the field names
+typedef struct {
+    unsigned int sma_period;
+    unsigned int ema_period;
+    unsigned int rsi_period;
+    unsigned int bollinger_period;
+    double bollinger_k;                      // band width in standard deviations
+    unsigned int atr_period;                 // in trading days
+} IndicatorConfig;
+
+// Latest indicator values for one symbol; NAN until enough ticks arrived
+typedef struct IndicatorValues {
+    double sma;
+    double ema;
+    double rsi;
+    double vwap;
+    double bollinger_upper;
+    double bollinger_middle;
+    double bollinger_lower;
+    double stddev;
+    double atr;
+    int samples;                             // ticks seen
+} IndicatorValues;
+
+// Analyzer verdict for one quote (rules.c); stock_status_label() gives the display string
+typedef enum {
+    STATUS_INVALID,
+    STATUS_STRONG_BUY,
+    STATUS_BULLISH,
+    STATUS_POSITIVE,
+    STATUS_NEUTRAL,
+    STATUS_WATCH,
+    STATUS_BEARISH,
+    STATUS_AVOID,
+    STATUS_COUNT
+} StockStatus;
+
+// Buy/sell advice for one quote, weakest first; recommendation_label() renders it
+typedef enum {
+    RECOMMEND_INVALID,
+    RECOMMEND_STRONG_SELL,
+    RECOMMEND_SELL,
+    RECOMMEND_WATCH,
+    RECOMMEND_HOLD,
+    RECOMMEND_HOLD_UP,
+    RECOMMEND_BUY,
+    RECOMMEND_STRONG_BUY,
+    RECOMMEND_COUNT
+} Recommendation;
+
+// Size of today's move; risk_level_label() renders it
+typedef enum {
+    RISK_UNKNOWN,
+    RISK_LOW,
+    RISK_MEDIUM,
+    RISK_HIGH,
+    RISK_COUNT
+} RiskLevel;
+
+// Shape of today's move against the day's range; price_pattern_label() renders it
+typedef enum {
+    PATTERN_UNKNOWN,
+    PATTERN_DOWNWARD,
+    PATTERN_UPWARD,
+    PATTERN_SIDEWAYS,
+    PATTERN_BREAKDOWN,
+    PATTERN_BREAKOUT,
+    PATTERN_COUNT
+} PricePattern;
+
+// Strings stored once each and referenced by byte offset (market_state.c)
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+    uint32_t* slots;                         // open addressing: offset + 1, 0 = empty
+    size_t slot_count;                       // power of two
+    size_t used;
+} StringPool;
+
+// Columnar market data: row i of every array is one symbol (market_state.c)
+typedef struct MarketState {
+    int count;
+    int capacity;
+    // Hot columns, read by every analytics scan
+    double* price;
+    double* change;                          // percent
+    double* volume;
+    double* high;
+    double* low;
+    double* prev_close;
+    unsigned char* status;                   // StockStatus
+    // Cold side table, only needed to display or rebuild a row
+    uint32_t* symbol;                        // offsets into strings
+    uint32_t* name;
+    double* market_cap;
+    time_t* last_update;
+    StringPool strings;
+} MarketState;
+
+// Counts and sums over the rows that have a price (market_kernels.c)
+typedef struct {
+    int valid;                               // price > 0
+    int positive;                            // change > 0
+    int bullish;                             // change > SENTIMENT_THRESHOLD
+    int bearish;                             // change < -SENTIMENT_THRESHOLD
+    double change_sum;
+    double price_sum;
+} MarketBuckets;
+
+// Extra per-row metric computed inside market_summary_compute's single pass
+typedef struct {
+    const char* name;
+    void (*begin)(void* ctx);                             // optional, before the first row
+    void (*add)(void* ctx, const Stock* stock, int index); // every row with a price
+    double (*finish)(void* ctx);                          // optional, the metric's value
+    void* ctx;
+} SummaryMetric;
+
+// Every market-wide aggregate, gathered in one pass (summary.c)
+#define SUMMARY_TOP_K 5
+#define SUMMARY_MAX_METRICS 8
+typedef struct {
+    int count;                               // rows scanned
+    int valid;                               // rows with a price; the rest are skipped
+    int positive;                            // change > 0
+    int bullish, bearish, neutral;           // sentiment buckets around ±SENTIMENT_THRESHOLD
+    double change_sum;
+    double price_sum;
+    double volume_sum;
+    double average_change;
+    const char* sentiment;
+    int best, worst;                         // row indices, -1 if none
+    int most_volatile;                       // largest |change|
+    int highest_volume;
+    int top[SUMMARY_TOP_K];                  // rows by change, largest first
+    int top_count;
+    const char* metric_names[SUMMARY_MAX_METRICS];
+    double metric_values[SUMMARY_MAX_METRICS];
+    int metric_count;
+} MarketSummary;
+
+// Sort keys for rank_top_k / rank_bottom_k (ranking.c)
+typedef enum {
+    RANK_BY_CHANGE,
+    RANK_BY_VOLUME,
+    RANK_BY_VOLATILITY,                      // |change|
+    RANK_KEY_COUNT
+} RankKey;
+
+// Sequence lock for structures updated in place while lock-free readers
+// copy from them (epoch.c); even = stable, odd = a writer is mid-update
+typedef struct {
+    unsigned long sequence;
+} SeqLock;
+
+// Copy of the live leaderboard's leading or trailing rows (leaderboard.c)
+#define LEADERBOARD_MAX_K 100
+typedef struct {
+    int count;
+    unsigned long version;                   // leaderboard version the rows were read at
+    int has_indicators;                      // indicators[] was fed by indicators.c
+    Stock stocks[LEADERBOARD_MAX_K];         // ranked order
+    IndicatorValues indicators[LEADERBOARD_MAX_K];
+} LeaderboardView;
+
+// Symbol packed into 8 NUL-padded bytes; 0 is never a valid key (registry.c)
+#define SYMBOL_KEY_LENGTH 8
+typedef uint64_t SymbolKey;
+
+// Slot changes reported by the registry; per-slot state elsewhere follows them
+typedef enum {
+    REGISTRY_ADDED,                          // `slot` holds a new symbol
+    REGISTRY_REMOVED,                        // `slot`'s symbol is gone
+    REGISTRY_MOVED                           // the symbol at `from` now lives in `slot`
+} RegistryEvent;
+
+typedef void (*RegistryListener)(RegistryEvent event, int slot, int from, void* ctx);
+
+// Streaming JSON writer: formats into one growable buffer (json_writer.c)
+#define JSON_MAX_DEPTH 16
+#define JSON_DOUBLE_BUFSIZE 32
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+    int pretty;                              // json-c style two-space layout, else compact
+    int depth;
+    int after_key;                           // next value completes a "key": pair
+    int failed;                              // allocation failed or unbalanced nesting
+    int fixed;                               // data is the caller's buffer; never grown or freed
+    unsigned char has_items[JSON_MAX_DEPTH];
+} JsonWriter;
+
+// Columns a quote can be projected to (/quote?fields=); bit n of a field
+// mask selects field n, and the symbol is always written
+typedef enum {
+    QUOTE_FIELD_NAME,
+    QUOTE_FIELD_PRICE,
+    QUOTE_FIELD_CHANGE_PERCENT,
+    QUOTE_FIELD_VOLUME,
+    QUOTE_FIELD_PREVIOUS_CLOSE,
+    QUOTE_FIELD_DAY_HIGH,
+    QUOTE_FIELD_DAY_LOW,
+    QUOTE_FIELD_STATUS,
+    QUOTE_FIELD_LAST_UPDATE,
+    QUOTE_FIELD_RANK,
+    QUOTE_FIELD_INDICATORS,
+    QUOTE_FIELD_COUNT
+} QuoteField;
+
+#define QUOTE_FIELDS_ALL ((1u << QUOTE_FIELD_COUNT) - 1)
+
 // Web data structure for JSON generation
 typedef struct {
     Stock* stocks;
@@ -54,102 +380,1034 @@ typedef struct {
 } WebData;
 
 // =============================================================================
-// CORE STOCK DATA FUNCTIONS (in stock_fetcher.c)
+// CORE STOCK DATA FUNCTIONS (in stock_fetcher.c)
+// =============================================================================
+
+/**
+ * Callback function for libcurl to write API response data
+ * @param contents: Raw data from API
+ * @param size: Size of each data element
+ * @param nmemb: Number of data elements
+ * @param response: Pointer to APIResponse structure
+ * @return: Number of bytes processed
+ */
+size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response);
+
+/**
+ * Fetch real-time stock data for a given symbol
+ * @param symbol: Stock symbol (e.g., "AAPL")
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success, 0 on failure
+ */
+int fetch_stock_data(const char* symbol, Stock* stock);
+
+/**
+ * Fetch many symbols concurrently over a shared curl multi handle
+ * @param symbols: Array of stock symbols
+ * @param count: Number of symbols
+ * @param stocks: Array of Stock structures, stocks[i] receives symbols[i]
+ * @return: Number of symbols fetched successfully
+ */
+int fetch_stocks_batch(const char* symbols[], int count, Stock stocks[]);
+
+/**
+ * Fetch a subset of symbols concurrently
+ * @param symbols: Array of stock symbols
+ * @param stocks: Array of Stock structures, stocks[i] receives symbols[i]
+ * @param indices: Positions in symbols/stocks to fetch (NULL means 0..n-1)
+ * @param n: Number of entries in indices
+ * @param http_codes: Optional, receives the HTTP status per entry of indices (0 on transport error)
+ * @return: Number of symbols fetched successfully
+ */
+int fetch_stocks_selected(const char* symbols[], Stock stocks[], const int indices[],
+                          int n, long http_codes[]);
+
+/**
+ * Limit the number of requests a batch fetch keeps in flight
+ * @param max_in_flight: Desired limit (clamped to 1..MAX_CONCURRENT_FETCHES)
+ * @return: Limit actually applied
+ */
+int set_fetch_concurrency(int max_in_flight);
+
+/**
+ * Heap allocation counters for the fetch path. Response arenas are
+ * allocated once per handle, so in steady state allocations stay flat
+ * while quotes keeps growing.
+ * @param allocations: Optional, receives arena allocations plus fallback tree parses
+ * @param quotes: Optional, receives the number of responses received
+ */
+void fetch_alloc_stats(unsigned long* allocations, unsigned long* quotes);
+
+/**
+ * Parse JSON response from the Finnhub quote API
+ * @param json_string: Raw JSON response
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success, 0 on failure
+ */
+int parse_stock_json(const char* json_string, Stock* stock);
+
+/**
+ * Single-pass, allocation-free parser for the fixed-shape Finnhub quote
+ * object; reads fields straight into the Stock structure
+ * @param json: Raw JSON response (need not be NUL-terminated)
+ * @param len: Length of json in bytes
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success, 0 if the payload has an unexpected shape (stock untouched)
+ */
+int parse_quote_fast(const char* json, size_t len, Stock* stock);
+
+/**
+ * Parse a quote by building a cJSON tree (fallback for unexpected shapes)
+ * @param json_string: Raw JSON response
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success, 0 on failure
+ */
+int parse_stock_json_tree(const char* json_string, Stock* stock);
+
+/**
+ * Initialize libcurl for HTTP requests
+ * @return: 1 on success, 0 on failure
+ */
+int initialize_curl();
+
+/**
+ * Cleanup libcurl resources
+ */
+void cleanup_curl();
+
+// =============================================================================
+// REQUEST SCHEDULING FUNCTIONS (in scheduler.c)
+// =============================================================================
+
+/**
+ * Configure the token bucket guarding the upstream API quota
+ * @param calls_per_minute: Sustained request quota
+ * @param burst: Maximum requests issued back to back
+ * @param min_refresh_age: Seconds before a symbol is eligible for refetching
+ */
+void scheduler_init(int calls_per_minute, int burst, double min_refresh_age);
+
+/**
+ * Pick the most urgent symbols the token bucket can currently afford
+ * Priority is staleness of last_update weighted by absolute change.
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param indices: Output, positions of the selected stocks, most urgent first
+ * @param max_batch: Capacity of indices
+ * @return: Number of selected stocks (tokens are consumed for each)
+ */
+int scheduler_next_batch(Stock stocks[], int count, int indices[], int max_batch);
+
+/**
+ * Feed an upstream HTTP status back into the scheduler
+ * HTTP 429 and 5xx trigger exponential backoff and a lower refill rate.
+ * @param http_code: HTTP status of a completed request (0 for transport errors)
+ */
+void scheduler_report(long http_code);
+
+/**
+ * Refresh the most urgent symbols within the current quota
+ * The batch feeds back one scheduler_report(): a backoff step if any
+ * request was throttled (429/5xx), otherwise a recovery step.
+ * @param symbols: Array of stock symbols
+ * @param stocks: Array of Stock structures, stocks[i] receives symbols[i]
+ * @param count: Number of symbols
+ * @return: Number of symbols fetched successfully
+ */
+int scheduler_refresh(const char* symbols[], Stock stocks[], int count);
+
+/**
+ * Seconds until the scheduler expects to have useful work
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @return: Delay in seconds, 0 if work is due now
+ */
+double scheduler_next_delay(Stock stocks[], int count);
+
+/**
+ * Sleep until the scheduler expects to have useful work
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ */
+void scheduler_wait(Stock stocks[], int count);
+
+/**
+ * End the current scheduler_wait early, e.g. after new symbols were queued
+ */
+void scheduler_wake(void);
+
+/**
+ * Wake any thread in scheduler_wait and make future waits return at once
+ * Used on shutdown.
+ */
+void scheduler_interrupt(void);
+
+// =============================================================================
+// LOCK-FREE PUBLICATION FUNCTIONS (in epoch.c)
+// =============================================================================
+
+/**
+ * Start a read-side critical section; shared objects loaded inside it stay
+ * valid until epoch_exit. Never blocks and may nest.
+ */
+void epoch_enter(void);
+void epoch_exit(void);
+
+/**
+ * Reclaim an object once no reader can still hold it. Call after it has
+ * been unlinked from everything readers can reach; never waits for them.
+ * @param object: Object to reclaim (NULL is ignored)
+ * @param reclaim: Called with object after the grace period (e.g. free);
+ *                 must not retire objects itself
+ */
+void epoch_retire(void* object, void (*reclaim)(void* object));
+
+/**
+ * Advance the epoch if readers allow and reclaim what has expired
+ * @return: Number of objects reclaimed
+ */
+int epoch_reclaim(void);
+
+/**
+ * Reclaim every retired object now; only when no reader can be active
+ * (e.g. after the server has stopped)
+ */
+void epoch_drain(void);
+
+/**
+ * Number of retired objects still waiting for their grace period
+ */
+int epoch_pending(void);
+
+/**
+ * Read side: take the sequence before copying, then retry the copy while
+ * seqlock_read_retry reports a writer got in between
+ * @param lock: Lock guarding the structure
+ * @param start: Value returned by seqlock_read_begin
+ * @return: seqlock_read_retry returns 1 if the copy must be redone
+ */
+unsigned long seqlock_read_begin(const SeqLock* lock);
+int seqlock_read_retry(const SeqLock* lock, unsigned long start);
+
+/**
+ * Write side: bracket every in-place update; writers must be serialized
+ * by the caller
+ */
+void seqlock_write_begin(SeqLock* lock);
+void seqlock_write_end(SeqLock* lock);
+
+// =============================================================================
+// SNAPSHOT FUNCTIONS (in snapshot.c)
+// =============================================================================
+
+/**
+ * Serialize stocks once and atomically publish them for the HTTP server
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param summary: Aggregates of stocks[] for /best and /trending; NULL computes them
+ * @param indicators: Optional indicator values parallel to stocks[]
+ * @return: 1 on success, 0 on failure
+ */
+int snapshot_publish(Stock stocks[], int count, const MarketSummary* summary,
+                     const IndicatorValues indicators[]);
+
+/**
+ * Take a reference to the current snapshot; lock-free, never waits for a publish
+ * @return: Current snapshot (release with snapshot_release), NULL if none published
+ */
+Snapshot* snapshot_acquire(void);
+
+/**
+ * Drop a reference taken with snapshot_acquire
+ * @param snap: Snapshot to release (can be NULL)
+ */
+void snapshot_release(Snapshot* snap);
+
+/**
+ * Fill in sizes, compressed variants and ETags of a document whose
+ * identity body is set (shared by snapshots and the server's rendered views)
+ * @param variants: One SnapshotDoc per ContentEncoding
+ * @return: 1 on success, 0 if there is no identity body
+ */
+int snapshot_encode_doc(SnapshotDoc variants[ENCODING_COUNT]);
+
+/**
+ * Format a time as an HTTP-date (Last-Modified); safe from any thread
+ */
+void snapshot_http_date(time_t when, char* out, size_t size);
+
+/**
+ * Register a function called after every publish (e.g. to wake /stream clients)
+ * @param listener: Callback receiving the new snapshot, NULL to unregister
+ */
+void snapshot_set_listener(void (*listener)(const Snapshot* snap));
+
+/**
+ * Write a snapshot's documents to their JSON files as one generation
+ * (optional persistence; see publish_generation)
+ * @param snap: Snapshot to persist
+ * @return: 1 on success, 0 on failure
+ */
+int snapshot_persist(const Snapshot* snap);
+
+/**
+ * Publish the documents persisted by a previous run, if any, with the
+ * restored rows as the first /stream state
+ * @param stocks: Rows restored for the warm start
+ * @param count: Number of stocks
+ * @return: 1 on success, 0 if the files are missing
+ */
+int snapshot_seed_from_files(const Stock stocks[], int count);
+
+// =============================================================================
+// INDICATOR FUNCTIONS (in indicators.c)
+// =============================================================================
+
+/**
+ * Fill an IndicatorConfig with the built-in window sizes
+ */
+void indicators_config_defaults(IndicatorConfig* config);
+
+/**
+ * ConfigSetter for indicator windows; ctx is an IndicatorConfig*
+ * @return: 1 if the key was an indicator setting and was applied
+ */
+int indicators_config_set(const char* key, const char* value, void* ctx);
+
+/**
+ * Allocate state for `count` symbols; slot i follows stocks[i]
+ * @return: 1 on success, 0 on failure
+ */
+int indicators_init(const IndicatorConfig* config, int count);
+void indicators_free(void);
+
+/**
+ * Make room for at least `count` slots, keeping every existing slot's state
+ * @return: 1 on success, 0 on failure or before indicators_init
+ */
+int indicators_reserve(int count);
+
+/**
+ * Carry slot `from`'s state over to slot `to` (the symbol moved in stocks[])
+ * and reset `from`
+ */
+void indicators_move(int from, int to);
+
+/**
+ * Feed one quote into slot `index` in constant time; repeated quotes
+ * (same last_update) are ignored
+ * @return: 1 if the quote was new and the indicators moved
+ */
+int indicators_update(int index, const Stock* stock);
+
+/**
+ * indicators_update for every stocks[i]
+ * @return: Number of slots updated
+ */
+int indicators_update_all(const Stock stocks[], int count);
+
+/**
+ * Current values, parallel to the stocks[] passed to indicators_update
+ */
+const IndicatorValues* indicators_values(void);
+
+/**
+ * Current values for a symbol, NULL if it has no slot
+ */
+const IndicatorValues* indicators_lookup(const char* symbol);
+
+// =============================================================================
+// TICK HISTORY FUNCTIONS (in tickstore.c)
+// =============================================================================
+
+/**
+ * Fill a TickStoreConfig with the built-in defaults
+ */
+void tickstore_config_defaults(TickStoreConfig* config);
+
+/**
+ * ConfigSetter for tick history settings; ctx is a TickStoreConfig*
+ * @return: 1 if the key was a tick history setting and was applied
+ */
+int tickstore_config_set(const char* key, const char* value, void* ctx);
+
+/**
+ * Map the existing segments under config->dir; nothing is parsed
+ * @param config: Store settings (copied)
+ * @return: 1 on success, 0 if disabled or the directory is unusable
+ */
+int tickstore_open(const TickStoreConfig* config);
+
+/**
+ * Flush and unmap every segment
+ */
+void tickstore_close(void);
+
+/**
+ * Append one tick (price, high, low, volume at stock->last_update)
+ * @param stock: Quote to record
+ * @return: 1 if stored, 0 if invalid, older than the last tick, or on I/O failure
+ */
+int tickstore_append(const Stock* stock);
+
+/**
+ * Append every stock updated at or after `since`
+ * @return: Number of ticks stored
+ */
+int tickstore_append_since(const Stock stocks[], int count, time_t since);
+
+/**
+ * Visit a symbol's ticks in [from, to], oldest first, as zero-copy column runs
+ * Takes no lock and never blocks appends; visit runs inside an epoch.
+ * @param symbol: Stock symbol
+ * @param from: First timestamp (inclusive)
+ * @param to: Last timestamp (inclusive)
+ * @param visit: Called once per segment slice; the pointers are only valid during the call
+ * @param ctx: Passed through to visit
+ * @return: Number of rows visited
+ */
+size_t tickstore_scan(const char* symbol, time_t from, time_t to, TickScanFn visit, void* ctx);
+
+/**
+ * Copy the most recent stored prices, oldest first (e.g. for calculate_simple_moving_average)
+ * Lock-free, like tickstore_scan.
+ * @param prices: Destination array
+ * @param max: Capacity of prices
+ * @return: Number of prices copied
+ */
+int tickstore_recent_prices(const char* symbol, double prices[], int max);
+
+/**
+ * Apply retention and compaction to sealed segments
+ * @param now: Current time
+ * @return: Number of segments removed or compacted
+ */
+int tickstore_maintain(time_t now);
+
+// =============================================================================
+// CONFIGURATION FUNCTIONS (in config.c)
+// =============================================================================
+
+/**
+ * Apply one setting; returns 1 if the key was recognized and the value valid
+ */
+typedef int (*ConfigSetter)(const char* key, const char* value, void* ctx);
+
+/**
+ * Load "key = value" lines from a config file ('#' starts a comment)
+ * @param filename: Config file path
+ * @param setter: Called for every setting
+ * @param ctx: Passed through to setter
+ * @return: Number of settings applied, 0 if the file is missing
+ */
+int config_load(const char* filename, ConfigSetter setter, void* ctx);
+
+/**
+ * Apply "--key=value" command-line flags; dashes in keys become underscores
+ * @param argc: Argument count from main
+ * @param argv: Argument vector from main
+ * @param setter: Called for every flag
+ * @param ctx: Passed through to setter
+ * @return: Number of settings applied
+ */
+int config_parse_args(int argc, char* argv[], ConfigSetter setter, void* ctx);
+
+/**
+ * Parse a decimal setting value
+ * @param value: Text to parse (whole string must be a number)
+ * @param max: Largest accepted value
+ * @param out: Receives the value on success
+ * @return: 1 on success, 0 if malformed or out of range
+ */
+int config_parse_uint(const char* value, unsigned int max, unsigned int* out);
+
+/**
+ * Look up the value of a single "--name=value" flag
+ * @return: Pointer into argv, NULL if the flag is absent
+ */
+const char* config_find_arg(int argc, char* argv[], const char* name);
+
+// =============================================================================
+// COMPRESSION FUNCTIONS (in compress.c)
+// =============================================================================
+
+/**
+ * Compress a buffer into a gzip stream
+ * @param in: Input bytes
+ * @param in_size: Number of input bytes
+ * @param out_size: Receives the compressed size
+ * @return: Heap-allocated compressed bytes (caller frees), NULL on failure
+ */
+char* gzip_compress(const char* in, size_t in_size, size_t* out_size);
+
+/**
+ * Compress a buffer with brotli
+ * @param in: Input bytes
+ * @param in_size: Number of input bytes
+ * @param out_size: Receives the compressed size
+ * @return: Heap-allocated compressed bytes (caller frees), NULL on failure or
+ *          when built without HAVE_BROTLI
+ */
+char* brotli_compress(const char* in, size_t in_size, size_t* out_size);
+
+// =============================================================================
+// SCORING RULES FUNCTIONS (in rules.c)
+// =============================================================================
+
+/**
+ * Fill a RulesConfig with the built-in thresholds
+ */
+void rules_config_defaults(RulesConfig* config);
+
+/**
+ * ConfigSetter for scoring thresholds; ctx is a RulesConfig*
+ * @return: 1 if the key was a scoring setting and was applied
+ */
+int rules_config_set(const char* key, const char* value, void* ctx);
+
+/**
+ * Make `config` the active rules. Call before any thread scores quotes;
+ * until then the built-in thresholds apply.
+ * @return: 1 on success, 0 if the thresholds are out of order (the
+ *          previous rules stay active)
+ */
+int rules_init(const RulesConfig* config);
+
+/**
+ * Classify a quote against the status thresholds
+ * @param price: Current price, <= 0 means no data
+ * @param change: Percentage change from previous close
+ * @return: Status code for analyze_stock_performance and MarketState
+ */
+StockStatus classify_stock_status(double price, double change);
+
+/**
+ * classify_stock_status over parallel columns
+ * @param status: Receives count StockStatus codes
+ */
+void classify_stock_statuses(const double price[], const double change[], int count,
+                             unsigned char status[]);
+
+/**
+ * Buy/sell advice from the day's change and volume
+ */
+Recommendation stock_recommendation(const Stock* stock);
+
+/**
+ * Risk bucket for the size of the day's move
+ */
+RiskLevel stock_risk_level(const Stock* stock);
+
+/**
+ * Trend or breakout/breakdown relative to the day's high/low midpoint
+ */
+PricePattern stock_price_pattern(const Stock* stock);
+
+/**
+ * Display strings, rendered only where a code leaves the process (JSON,
+ * snapshot files); out-of-range codes render as their INVALID/UNKNOWN label
+ */
+const char* stock_status_label(StockStatus status);
+const char* recommendation_label(Recommendation recommendation);
+const char* risk_level_label(RiskLevel risk);
+const char* price_pattern_label(PricePattern pattern);
+
+/**
+ * Status code for a label produced by stock_status_label
+ * @return: Matching status, STATUS_INVALID if the label is unknown
+ */
+StockStatus stock_status_from_label(const char* label);
+
+// =============================================================================
+// STOCK ANALYSIS FUNCTIONS (in analyzer.c)
+// =============================================================================
+
+/**
+ * Analyze stock performance and set its status code
+ * @param stock: Pointer to Stock structure to analyze
+ */
+void analyze_stock_performance(Stock* stock);
+
+/**
+ * Find the best performing stock from an array
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to best performing stock, NULL if none found
+ */
+Stock* find_best_performing_stock(Stock stocks[], int count);
+
+/**
+ * Find the most volatile stock (highest absolute change percentage)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to most volatile stock, NULL if none found
+ */
+Stock* find_most_volatile_stock(Stock stocks[], int count);
+
+/**
+ * Count number of bullish stocks (positive change)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Number of bullish stocks
+ */
+int count_bullish_stocks(Stock stocks[], int count);
+
+/**
+ * Calculate total portfolio value
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Total value of all stocks
+ */
+double calculate_total_value(Stock stocks[], int count);
+
+/**
+ * Sort stocks by performance (change percentage)
+ * @param stocks: Array of Stock structures to sort
+ * @param count: Number of stocks in array
+ */
+void sort_stocks_by_performance(Stock stocks[], int count);
+
+/**
+ * Average change percentage of the stocks that have a price
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Mean change, 0.0 if no stock has data
+ */
+double calculate_average_change(Stock stocks[], int count);
+
+/**
+ * Find the stock with the highest trading volume
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to that stock, NULL if none found
+ */
+Stock* find_unusual_volume_stock(Stock stocks[], int count);
+
+/**
+ * Overall market direction from the moves above/below ±1%
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Sentiment label
+ */
+const char* analyze_market_sentiment(Stock stocks[], int count);
+
+/**
+ * Share of stocks moving against the majority direction
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Percentage in [0, 50]
+ */
+double calculate_portfolio_diversity(Stock stocks[], int count);
+
+// =============================================================================
+// MARKET SUMMARY FUNCTIONS (in summary.c)
+// =============================================================================
+
+/**
+ * Gather every market-wide aggregate in a single pass over stocks[]
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @param summary: Receives counts, sums, extrema, top movers and metrics
+ */
+void market_summary_compute(const Stock stocks[], int count, MarketSummary* summary);
+
+/**
+ * Summarize rows [begin, end) only, for merging with market_summary_merge
+ * (registered metrics are left to market_summary_finish)
+ * @param partial: Receives the range's counts, sums, extrema and top movers
+ */
+void market_summary_partial(const Stock stocks[], int begin, int end, MarketSummary* partial);
+
+/**
+ * Fold the partial summary of the next range into `into`. Merging the
+ * ranges in row order picks the same rows as one market_summary_compute
+ * pass; sums can differ from it in the last bits but not between runs.
+ * @param into: Summary of the ranges before partial's (start from an empty partial)
+ * @param partial: Summary of the following range
+ * @param stocks: The rows both summaries index
+ */
+void market_summary_merge(MarketSummary* into, const MarketSummary* partial, const Stock stocks[]);
+
+/**
+ * Complete merged partials: averages, sentiment and registered metrics
+ * @param stocks: Array the partials were computed over
+ * @param count: Number of stocks in array
+ * @param summary: Merged summary to complete
+ */
+void market_summary_finish(const Stock stocks[], int count, MarketSummary* summary);
+
+/**
+ * Add a metric to every later market_summary_compute pass; register at
+ * startup, before the refresher thread runs
+ * @return: 1 on success, 0 if the metric is incomplete or the table is full
+ */
+int market_summary_register(const SummaryMetric* metric);
+
+/**
+ * Value of a registered metric by name
+ * @return: The value, NAN if no metric has that name
+ */
+double market_summary_metric(const MarketSummary* summary, const char* name);
+
+// =============================================================================
+// WORK POOL FUNCTIONS (in workpool.c)
 // =============================================================================
-int start_server();
 
 /**
- * Callback function for libcurl to write API response data
- * @param contents: Raw data from API
- * @param size: Size of each data element
- * @param nmemb: Number of data elements
- * @param response: Pointer to APIResponse structure
- * @return: Number of bytes processed
+ * Start the work-stealing pool; the calling thread becomes worker 0
+ * @param threads: Workers including the caller, 0 for one per online core
+ * @return: 1 on success, 0 if no helper thread could start (loops then run inline)
  */
-size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response);
+int workpool_init(unsigned int threads);
 
 /**
- * Fetch real-time stock data for a given symbol
- * @param symbol: Stock symbol (e.g., "AAPL")
- * @param stock: Pointer to Stock structure to populate
+ * Stop and join the helper threads
+ */
+void workpool_free(void);
+
+/**
+ * Run fn over [0, count) in grain-sized chunks across the pool and return
+ * once every chunk is done. Chunk boundaries depend only on count and
+ * grain, never on the thread count. Call from the thread that ran
+ * workpool_init; fn must not start another loop.
+ * @param count: Number of rows
+ * @param grain: Rows per chunk (at least 1)
+ * @param fn: Task body, called once per chunk
+ * @param ctx: Passed to fn
+ * @param inline_only: 1 = run every chunk in order on the caller
+ */
+void workpool_parallel_for(int count, int grain, WorkRangeFn fn, void* ctx, int inline_only);
+
+/**
+ * Number of chunks workpool_parallel_for splits count rows into
+ */
+int workpool_chunks(int count, int grain);
+
+/**
+ * Workers in the pool, including the caller
+ */
+int workpool_threads(void);
+
+// =============================================================================
+// ANALYSIS PIPELINE FUNCTIONS (in pipeline.c)
+// =============================================================================
+
+/**
+ * Fill a PipelineConfig with the built-in defaults
+ */
+void pipeline_config_defaults(PipelineConfig* config);
+
+/**
+ * ConfigSetter for pipeline settings; ctx is a PipelineConfig*
+ * @return: 1 if the key was a pipeline setting and was applied
+ */
+int pipeline_config_set(const char* key, const char* value, void* ctx);
+
+/**
+ * Start the pipeline's work pool
+ * @return: 1 on success, 0 if it will run single-threaded
+ */
+int pipeline_init(const PipelineConfig* config);
+void pipeline_free(void);
+
+/**
+ * Post-fetch analysis: feed the indicators, refresh every row's status
+ * and summarize the market, fanned out over the work pool and joined in
+ * row order (same result for any thread count)
+ * @param stocks: Rows, whose status is rewritten
+ * @param count: Number of stocks
+ * @param summary: Receives the market summary
+ * @return: Number of rows whose indicators advanced
+ */
+int pipeline_analyze(Stock stocks[], int count, MarketSummary* summary);
+
+// =============================================================================
+// RANKING FUNCTIONS (in ranking.c)
+// =============================================================================
+
+/**
+ * Rows with the K largest keys, via a bounded heap over row indices
+ * @param stocks: Array of Stock structures (not modified or copied)
+ * @param count: Number of stocks in array
+ * @param key: Value to rank by
+ * @param k: Number of rows wanted
+ * @param out: Receives up to k row indices, best first; ties keep row order
+ * @return: Number of indices written (rows without a price are skipped)
+ */
+int rank_top_k(const Stock stocks[], int count, RankKey key, int k, int out[]);
+
+/**
+ * rank_top_k for the K smallest keys, smallest first
+ */
+int rank_bottom_k(const Stock stocks[], int count, RankKey key, int k, int out[]);
+
+/**
+ * rank_top_k / rank_bottom_k over MarketState columns (contiguous keys)
+ */
+int market_rank_top_k(const MarketState* state, RankKey key, int k, int out[]);
+int market_rank_bottom_k(const MarketState* state, RankKey key, int k, int out[]);
+
+/**
+ * Every row index ordered by key, largest first (rows without a price included)
+ * @return: count on success, 0 on allocation failure
+ */
+int rank_order(const Stock stocks[], int count, RankKey key, int out[]);
+
+/**
+ * Parse "change", "volume" or "volatility"
+ * @return: 1 if the name is a known key
+ */
+int rank_key_parse(const char* name, RankKey* key);
+const char* rank_key_name(RankKey key);
+
+// =============================================================================
+// SYMBOL REGISTRY FUNCTIONS (in registry.c)
+// =============================================================================
+
+/**
+ * Pack a symbol into its 8-byte key (upper-cased)
+ * @param symbol: 1 to SYMBOL_KEY_LENGTH alphanumeric characters
+ * @param key: Receives the key
+ * @return: 1 on success, 0 if the symbol is invalid or too long
+ */
+int symbol_key_make(const char* symbol, SymbolKey* key);
+
+/**
+ * NUL-terminated text of a key
+ */
+void symbol_key_text(SymbolKey key, char text[SYMBOL_KEY_LENGTH + 1]);
+
+/**
+ * Allocate an empty registry; slots and index grow on demand
+ * @param initial_capacity: Expected number of symbols
  * @return: 1 on success, 0 on failure
  */
-int fetch_stock_data(const char* symbol, Stock* stock);
+int registry_init(int initial_capacity);
+void registry_free(void);
 
 /**
- * Parse JSON response from Alpha Vantage API
- * @param json_string: Raw JSON response
- * @param stock: Pointer to Stock structure to populate
+ * Register the function told about every slot change (owner thread)
+ * @param listener: Callback, NULL to unregister
+ * @param ctx: Passed through to listener
+ */
+void registry_set_listener(RegistryListener listener, void* ctx);
+
+/**
+ * Track a symbol; its slot starts as an empty quote carrying the symbol.
+ * Owner thread only: may move registry_stocks() / registry_symbols().
+ * @return: Slot (the existing one if already tracked), -1 if invalid or out of memory
+ */
+int registry_add(const char* symbol);
+
+/**
+ * Stop tracking a symbol; the last slot moves into its place. Owner thread only.
+ * @return: 1 if it was tracked
+ */
+int registry_remove(const char* symbol);
+
+/**
+ * Slot of a symbol in O(1); safe from any thread
+ * @return: Slot, -1 if not tracked
+ */
+int registry_find(const char* symbol);
+int registry_find_key(SymbolKey key);
+
+/**
+ * Number of tracked symbols; slots 0..count-1 are all in use
+ */
+int registry_count(void);
+
+/**
+ * Dense quote storage and the parallel symbol array for the fetch functions.
+ * Owner thread only; valid until the next add.
+ */
+Stock* registry_stocks(void);
+const char** registry_symbols(void);
+
+/**
+ * Queue an add or remove from any thread (e.g. the admin endpoint);
+ * the owner applies it with registry_apply_pending
+ * @return: 1 if queued, 0 if the symbol is invalid or the queue is full
+ */
+int registry_request_add(const char* symbol);
+int registry_request_remove(const char* symbol);
+
+/**
+ * Apply queued requests (owner thread)
+ * @return: Number of symbols added or removed
+ */
+int registry_apply_pending(void);
+
+/**
+ * Make the tracked set match the watchlist file if it changed since the
+ * last sync or save (owner thread)
+ * @param filename: Watchlist file, symbols separated by whitespace or commas
+ * @return: Number of symbols added or removed, -1 if the file is missing
+ */
+int registry_sync_watchlist(const char* filename);
+
+/**
+ * Write the tracked symbols to the watchlist file atomically
  * @return: 1 on success, 0 on failure
  */
-int parse_stock_json(const char* json_string, Stock* stock);
+int registry_save_watchlist(const char* filename);
+
+// =============================================================================
+// LEADERBOARD FUNCTIONS (in leaderboard.c)
+// =============================================================================
 
 /**
- * Initialize libcurl for HTTP requests
+ * Allocate the live leaderboard, an indexed skip list ordered by change
+ * percent (largest first, ties by row); it grows past capacity on demand
+ * @param capacity: Expected number of rows
  * @return: 1 on success, 0 on failure
  */
-int initialize_curl();
+int leaderboard_init(int capacity);
+void leaderboard_free(void);
 
 /**
- * Cleanup libcurl resources
+ * Move row `row` to its new position in O(log n); rows without a price
+ * (or with a NaN change) leave the board
+ * @param row: Stable row id, e.g. the index into stocks[]
+ * @param stock: Latest quote for the row (copied)
+ * @param indicators: Optional indicator values for the row (copied)
+ * @return: 1 if the board changed, 0 if the quote was identical or on failure
  */
-void cleanup_curl();
+int leaderboard_update(int row, const Stock* stock, const IndicatorValues* indicators);
+
+/**
+ * Take row `row` off the board
+ * @return: 1 if it was ranked
+ */
+int leaderboard_remove(int row);
+
+/**
+ * Copy the k best (top) or k worst (bottom) rows, in ranked order; O(log n + k)
+ * @param k: Number of rows wanted (clamped to LEADERBOARD_MAX_K)
+ * @param view: Receives the rows and the version they were read at
+ * @return: Number of rows copied
+ */
+int leaderboard_top_k(int k, LeaderboardView* view);
+int leaderboard_bottom_k(int k, LeaderboardView* view);
+
+/**
+ * 1-based position of a symbol on the board, in O(log n)
+ * @return: Rank, 0 if the symbol is not ranked
+ */
+int leaderboard_rank(const char* symbol);
+
+/**
+ * Number of ranked rows
+ */
+int leaderboard_count(void);
+
+/**
+ * Counter bumped by every change to the board; equal versions mean equal
+ * query results, so renders can be cached against it
+ */
+unsigned long leaderboard_version(void);
 
 // =============================================================================
-// STOCK ANALYSIS FUNCTIONS (in analyzer.c)
+// MARKET STATE FUNCTIONS (in market_state.c)
 // =============================================================================
 
 /**
- * Analyze stock performance and set status
- * @param stock: Pointer to Stock structure to analyze
+ * Allocate empty columns for `capacity` rows; the state grows on demand
+ * @return: 1 on success, 0 on failure
  */
-void analyze_stock_performance(Stock* stock);
+int market_state_init(MarketState* state, int capacity);
+void market_state_free(MarketState* state);
 
 /**
- * Find the best performing stock from an array
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Pointer to best performing stock, NULL if none found
+ * Drop every row but keep the columns and interned strings for reuse
  */
-Stock* find_best_performing_stock(Stock stocks[], int count);
+void market_state_clear(MarketState* state);
 
 /**
- * Find the most volatile stock (highest absolute change percentage)
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Pointer to most volatile stock, NULL if none found
+ * Append one Stock as a new row
+ * @return: Row index, -1 if the columns could not grow
  */
-Stock* find_most_volatile_stock(Stock stocks[], int count);
+int market_state_append(MarketState* state, const Stock* stock);
 
 /**
- * Count number of bullish stocks (positive change)
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Number of bullish stocks
+ * Overwrite row `index` with a Stock
+ * @return: 1 on success, 0 on a bad index or allocation failure
  */
-int count_bullish_stocks(Stock stocks[], int count);
+int market_state_set(MarketState* state, int index, const Stock* stock);
 
 /**
- * Calculate total portfolio value
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Total value of all stocks
+ * Replace the whole state with stocks[0..count-1]
+ * @return: 1 on success, 0 on allocation failure
  */
-double calculate_total_value(Stock stocks[], int count);
+int market_state_from_stocks(MarketState* state, const Stock stocks[], int count);
 
 /**
- * Sort stocks by performance (change percentage)
- * @param stocks: Array of Stock structures to sort
- * @param count: Number of stocks in array
+ * Rebuild row `index` as a Stock
  */
-void sort_stocks_by_performance(Stock stocks[], int count);
+void market_state_get(const MarketState* state, int index, Stock* out);
 
 /**
- * Generate buy/sell/hold recommendations
- * @param stock: Pointer to Stock structure to analyze
- * @return: Recommendation string
+ * Rebuild up to max_count rows into stocks[]
+ * @return: Number of rows written
+ */
+int market_state_to_stocks(const MarketState* state, Stock stocks[], int max_count);
+
+const char* market_state_symbol(const MarketState* state, int index);
+const char* market_state_name(const MarketState* state, int index);
+
+/**
+ * Set the status column of every row from its price and change
+ */
+void market_state_classify(MarketState* state);
+
+/**
+ * Column-scan versions of the analyzer.c functions of the same purpose;
+ * rows with no price are skipped exactly as there
+ * @return: Row index for the find functions, -1 if none qualifies
+ */
+int market_count_bullish(const MarketState* state);
+double market_average_change(const MarketState* state);
+double market_total_value(const MarketState* state);
+int market_find_best(const MarketState* state);
+int market_find_most_volatile(const MarketState* state);
+int market_find_highest_volume(const MarketState* state);
+const char* market_sentiment(const MarketState* state);
+double market_portfolio_diversity(const MarketState* state);
+
+// =============================================================================
+// MARKET KERNEL FUNCTIONS (in market_kernels.c)
+// =============================================================================
+
+/**
+ * Bucket counts and sums over parallel price/change columns
+ * @param price: Price column; rows with price <= 0 are skipped
+ * @param change: Change percentage column
+ * @param count: Number of rows
+ * @param out: Receives the counts and sums
+ */
+void market_buckets(const double* price, const double* change, int count, MarketBuckets* out);
+
+/**
+ * First row holding the largest value above `floor` among rows with a price
+ * @return: Row index, -1 if no value exceeds floor
+ */
+int market_argmax(const double* price, const double* values, int count, double floor);
+
+/**
+ * market_argmax on |values| with a floor of zero
+ */
+int market_argmax_abs(const double* price, const double* values, int count);
+
+/**
+ * Name of the kernel set in use ("avx2", "sse2" or "scalar")
+ */
+const char* market_kernels_name(void);
+
+/**
+ * Force a kernel set by name, or pick the best one again for NULL/"auto"
+ * @return: 1 if the set exists and the CPU supports it, 0 otherwise
  */
-const char* generate_recommendation(Stock* stock);
+int market_kernels_select(const char* name);
 
 // =============================================================================
 // FILE I/O FUNCTIONS (in file_handler.c)
@@ -172,6 +1430,38 @@ int save_stocks_to_file(Stock stocks[], int count, const char* filename);
  */
 int load_stocks_from_file(Stock stocks[], int max_count, const char* filename);
 
+/**
+ * Save the full Stock records to a versioned binary snapshot (atomic replace)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param filename: Output file name
+ * @return: 1 on success, 0 on failure
+ */
+int save_stocks_binary(Stock stocks[], int count, const char* filename);
+
+/**
+ * Load a binary snapshot written by save_stocks_binary (one mmap, CRC-checked)
+ * @param stocks: Array to populate with Stock structures
+ * @param max_count: Maximum number of stocks to load
+ * @param filename: Snapshot file name
+ * @return: Number of stocks loaded, -1 if missing, damaged or from another format version
+ */
+int load_stocks_binary(Stock stocks[], int max_count, const char* filename);
+
+/**
+ * Read the record count from a binary snapshot header (to size the load)
+ * @return: Number of records, -1 if the file is missing or not a snapshot
+ */
+int count_stocks_binary(const char* filename);
+
+/**
+ * Convert a legacy "symbol price previous_close change" text file to a binary snapshot
+ * @param text_file: Legacy file written by save_stocks_to_file
+ * @param binary_file: Binary snapshot to write
+ * @return: Number of stocks converted, -1 on failure
+ */
+int convert_legacy_stock_file(const char* text_file, const char* binary_file);
+
 /**
  * Generate JSON data for web interface
  * @param stocks: Array of Stock structures
@@ -181,6 +1471,50 @@ int load_stocks_from_file(Stock stocks[], int max_count, const char* filename);
  */
 int generate_json_file(Stock stocks[], int count, const char* filename);
 
+/**
+ * Open a temp file next to `filename` for an atomic replace
+ * @param af: State for atomic_file_commit/atomic_file_abort
+ * @param filename: File to replace
+ * @return: Stream to write the new contents to, NULL on failure
+ */
+FILE* atomic_file_open(AtomicFile* af, const char* filename);
+
+/**
+ * Flush (and fsync, per FSYNC_POLICY) the temp file and rename it over the target
+ * @return: 1 on success, 0 on failure (target left untouched)
+ */
+int atomic_file_commit(AtomicFile* af);
+
+/**
+ * Discard the temp file; the target is left untouched
+ */
+void atomic_file_abort(AtomicFile* af);
+
+/**
+ * Replace a file's contents atomically
+ * @return: 1 on success, 0 on failure
+ */
+int write_file_atomic(const char* filename, const char* data, size_t size);
+
+/**
+ * Publish a set of files as one generation: written to a fresh directory
+ * dir/gen-N, then made visible by atomically repointing the dir/current
+ * symlink. dir/<name> are symlinks to current/<name>.
+ * @param dir: Directory holding the generations (e.g. "web")
+ * @param files: Files of the generation; unchanged ones are hard-linked
+ *               from the previous generation instead of rewritten
+ * @param count: Number of files
+ * @return: 1 on success, 0 on failure (previous generation stays current)
+ */
+int publish_generation(const char* dir, const GenerationFile files[], int count);
+
+/**
+ * Read an entire file into memory
+ * @param filename: File to read
+ * @return: Heap-allocated, NUL-terminated contents (caller frees), NULL on failure
+ */
+char* read_file_to_string(const char* filename);
+
 /**
  * Save trading log with timestamp
  * @param message: Log message to save
@@ -283,6 +1617,104 @@ void display_error(const char* message);
  */
 void display_success(const char* message);
 
+/**
+ * Start a JSON document
+ * @param w: Writer to initialize
+ * @param pretty: 1 for the indented layout, 0 for compact single-line output
+ * @param size_hint: Bytes to reserve up front (0 to grow on demand)
+ */
+void json_writer_init(JsonWriter* w, int pretty, size_t size_hint);
+
+/**
+ * Start a JSON document in a caller-owned buffer instead of the heap
+ * @param w: Writer to initialize
+ * @param buffer: Destination; the document fails if it outgrows it
+ * @param capacity: Size of buffer in bytes, including the NUL
+ * @param pretty: 1 for the indented layout, 0 for compact single-line output
+ */
+void json_writer_init_fixed(JsonWriter* w, char* buffer, size_t capacity, int pretty);
+
+/**
+ * Empty the writer but keep its buffer for the next document
+ */
+void json_writer_reset(JsonWriter* w);
+
+/**
+ * Take ownership of the finished document
+ * @param size: Optional, receives the length in bytes
+ * @return: Heap-allocated NUL-terminated text (caller frees), NULL if an
+ *          allocation failed or containers are unbalanced. A fixed writer
+ *          returns its own buffer instead (NULL if the text did not fit)
+ */
+char* json_writer_finish(JsonWriter* w, size_t* size);
+void json_writer_free(JsonWriter* w);
+
+void json_begin_object(JsonWriter* w);
+void json_end_object(JsonWriter* w);
+void json_begin_array(JsonWriter* w);
+void json_end_array(JsonWriter* w);
+void json_write_key(JsonWriter* w, const char* key);
+void json_write_string(JsonWriter* w, const char* text);
+void json_write_double(JsonWriter* w, double value);
+void json_write_int(JsonWriter* w, long long value);
+void json_write_null(JsonWriter* w);
+
+/**
+ * Format a double with the fewest digits that parse back to the same value
+ * @param value: Number to format
+ * @param out: Destination buffer
+ * @return: Length written (always ends in a fraction or exponent, e.g. "5.0")
+ */
+size_t json_format_double(double value, char out[JSON_DOUBLE_BUFSIZE]);
+
+/**
+ * Serialize stocks into the /stocks, /best and /trending JSON documents
+ * @param indicators: Optional values parallel to stocks[] (or for best),
+ *                    added to each row as an "indicators" object; NULL omits it
+ * @return: Heap-allocated JSON text (caller frees), NULL on failure
+ */
+char* build_all_stocks_json(Stock stocks[], int count, const IndicatorValues indicators[]);
+char* build_best_stock_json(Stock* best, const IndicatorValues* indicators);
+
+/**
+ * Parse a comma-separated list of quote field names (e.g. "price,volume")
+ * @param list: Field names as they appear in the JSON output
+ * @param mask: Receives the selected QuoteField bits
+ * @return: 1 on success, 0 if a name is unknown or the list is empty
+ */
+int quote_fields_parse(const char* list, unsigned int* mask);
+
+/**
+ * Write one quote as an object holding the symbol and the selected fields
+ * @param stock: Quote to serialize
+ * @param indicators: Indicator values, NULL omits them even if selected
+ * @param rank: Position on the change leaderboard, 0 writes null
+ * @param fields: QuoteField bits to include
+ */
+void json_write_quote(JsonWriter* w, const Stock* stock, const IndicatorValues* indicators,
+                      int rank, unsigned int fields);
+
+/**
+ * Serialize selected rows, in the given order, as the trending document
+ * @param rows: Row indices into stocks[] (e.g. MarketSummary.top)
+ * @param row_count: Number of indices
+ * @param indicators: Optional values parallel to stocks[], NULL omits them
+ * @return: Heap-allocated JSON text (caller frees), NULL on failure
+ */
+char* build_trending_json(Stock stocks[], const int rows[], int row_count,
+                          const IndicatorValues indicators[]);
+
+/**
+ * Serialize rows for the /stream endpoint as compact single-line JSON
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param prev: Rows of the previous snapshot, or NULL to include every row
+ * @param prev_row: Index into prev of each row's previous version, -1 if new
+ * @return: Heap-allocated JSON array (caller frees); NULL if prev is given
+ *          and no row's price or change moved
+ */
+char* build_stream_json(Stock stocks[], int count, const Stock prev[], const int prev_row[]);
+
 void write_all_stocks_json(Stock stocks[], int count, const char* filename);
 void write_best_stock_json(Stock* best, const char* filename);
 void write_trending_json(Stock stocks[], int count, const char* filename);
@@ -302,11 +1734,37 @@ int compare_stock_change(const void* a, const void* b);
 #define BASE_URL "https://finnhub.io/api/v1/quote"
 #endif
 
-// Stock status thresholds
-#define STRONG_BUY_THRESHOLD 3.0    // > 3% gain
-#define BUY_THRESHOLD 1.0           // > 1% gain
-#define SELL_THRESHOLD -1.0         // < -1% loss
-#define STRONG_SELL_THRESHOLD -3.0  // < -3% loss
+// Batch fetching
+#define MAX_CONCURRENT_FETCHES 256      // size of the reusable handle pool
+#define DEFAULT_CONCURRENT_FETCHES 32   // requests in flight per batch
+
+// Upstream quota (Finnhub free tier: 60 calls/minute, 30 calls/second)
+#define API_CALLS_PER_MINUTE 60
+#define API_BURST 30
+#define MIN_REFRESH_AGE 5.0          // seconds before a quote is refetched
+#define VOLATILITY_WEIGHT 2.0        // % move that doubles refresh priority
+#define SCHEDULER_MIN_BACKOFF 1.0    // seconds, first backoff on 429/5xx
+#define SCHEDULER_MAX_BACKOFF 60.0   // seconds
+#define SCHEDULER_MIN_SLEEP 0.05     // seconds
+
+// Scoring rule defaults (see RulesConfig)
+#define STRONG_BUY_THRESHOLD 3.0    // >= 3% gain
+#define BUY_THRESHOLD 1.0           // >= 1% gain
+#define SELL_THRESHOLD -1.0         // <= -1% loss
+#define STRONG_SELL_THRESHOLD -3.0  // <= -3% loss
+#define RECOMMEND_STRONG_BUY_CHANGE 3.0
+#define RECOMMEND_STRONG_BUY_VOLUME 1000000.0
+#define RECOMMEND_BUY_CHANGE 1.0
+#define RECOMMEND_BUY_VOLUME 500000.0
+#define RECOMMEND_HOLD_UP_CHANGE 0.5
+#define RECOMMEND_HOLD_CHANGE -0.5
+#define RECOMMEND_WATCH_CHANGE -2.0
+#define RECOMMEND_SELL_CHANGE -5.0
+#define RISK_MEDIUM_CHANGE 2.0
+#define RISK_HIGH_CHANGE 5.0
+#define PATTERN_BREAKOUT_CHANGE 2.0
+#define PATTERN_SIDEWAYS_CHANGE 0.5
+#define SENTIMENT_THRESHOLD 1.0     // moves beyond ±1% count toward market sentiment
 
 // Web interface configuration
 // #define WEB_DIRECTORY "web"
@@ -317,7 +1775,57 @@ int compare_stock_change(const void* a, const void* b);
 
 // File paths
 #define LOG_FILE "trading_log.txt"
-#define DATA_FILE "stock_data.txt"
+#define DATA_FILE "stock_data.txt"           // Legacy text format, converted on first start
+#define DATA_BINARY_FILE "stock_data.bin"
 #define CONFIG_FILE "config.txt"
+#define WATCHLIST_FILE "watchlist.txt"      // Tracked symbols; edits are picked up live
+#define STOCKS_JSON_FILE "web/stock_data.json"
+#define BEST_JSON_FILE "web/best_stock.json"
+#define TRENDING_JSON_FILE "web/trending.json"
+#define PERSIST_DIR "web"                 // Directory of the three JSON files above
+
+// Snapshot compression (runs once per publish, never per request)
+#define GZIP_LEVEL 9
+#define BROTLI_QUALITY 9
+
+// Also write every published snapshot to the JSON files above
+#ifndef PERSIST_JSON_FILES
+#define PERSIST_JSON_FILES 1
+#endif
+
+// Indicator window defaults (see IndicatorConfig)
+#define INDICATOR_SMA_PERIOD 20
+#define INDICATOR_EMA_PERIOD 12
+#define INDICATOR_RSI_PERIOD 14
+#define INDICATOR_BOLLINGER_PERIOD 20
+#define INDICATOR_BOLLINGER_K 2.0
+#define INDICATOR_ATR_PERIOD 14
+#define INDICATOR_MAX_PERIOD 10000
+
+// Analysis pipeline defaults (see PipelineConfig)
+#define PIPELINE_THREADS 0                  // one per online core
+#define PIPELINE_GRAIN 512
+#define PIPELINE_MAX_THREADS 64
+#define PIPELINE_MAX_GRAIN 1000000
+
+// Tick history defaults (see TickStoreConfig)
+#define TICK_HISTORY_DIR "data/ticks"
+#define TICK_SEGMENT_ROWS 4096              // ~160 KB per segment file
+#define TICK_RETENTION_DAYS 30
+#define TICK_COMPACT_AFTER_HOURS 24
+#define TICK_COMPACT_BUCKET_SECONDS 60
+#define TICK_MAINTENANCE_INTERVAL 3600      // seconds between retention/compaction passes
+
+// Durability of atomic writes. Every policy is atomic for readers; the
+// fsyncs only decide what survives a crash or power loss:
+//   FSYNC_NONE - no fsync, a crash may roll back to an older version
+//   FSYNC_DATA - contents are durable before they become visible
+//   FSYNC_FULL - the switch itself is durable too (parent directory fsync)
+#define FSYNC_NONE 0
+#define FSYNC_DATA 1
+#define FSYNC_FULL 2
+#ifndef FSYNC_POLICY
+#define FSYNC_POLICY FSYNC_DATA
+#endif
 
 #endif // STOCK_TRACKER_H
\ No newline at end of file
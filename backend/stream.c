@@ -0,0 +1,198 @@
+#include <microhttpd.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "stock_tracker.h"
+#include "server.h"
+
+// Sent once per subscriber: reconnect delay hint for EventSource
+#define STREAM_PREAMBLE "retry: 3000\n\n"
+#define STREAM_BLOCK_SIZE 4096
+
+// ---------------------------------------------------------------------------
+// Subscriber state: one per open /stream connection. Idle subscribers are
+// suspended inside MHD and cost no polling until the next publish.
+// ---------------------------------------------------------------------------
+typedef struct Subscriber {
+    struct MHD_Connection *connection;
+    unsigned long generation;   // last snapshot generation delivered
+    Snapshot *pending;          // snapshot owning `frame`, NULL for static frames
+    const char *frame;          // event currently being written
+    size_t frame_size;
+    size_t offset;
+    int suspended;
+    struct Subscriber *prev, *next;
+} Subscriber;
+
+// Guards the list and the park/resume handshake only: a subscriber takes
+// it once per publish when it runs out of frames, and on connect and
+// disconnect. Frames themselves come from the epoch-published snapshot.
+static pthread_mutex_t subscribers_lock = PTHREAD_MUTEX_INITIALIZER;
+static Subscriber *subscribers = NULL;
+static int subscriber_count = 0;            // atomic; read without the lock
+static unsigned long notified_generation = 0;
+static int stream_closing = 0;
+
+// ---------------------------------------------------------------------------
+// Pick the next event for a subscriber: the delta if it is exactly one
+// generation behind and that generation had rows to diff against,
+// otherwise a full snapshot. Returns 1 if a frame is set.
+// ---------------------------------------------------------------------------
+static int next_frame(Subscriber *sub) {
+    Snapshot *snap = snapshot_acquire();
+    if (!snap || snap->generation <= sub->generation) {
+        snapshot_release(snap);
+        return 0;
+    }
+
+    const char *frame = snap->stream_full;
+    size_t size = snap->stream_full_size;
+    if (sub->generation != 0 && snap->generation == sub->generation + 1 && snap->stream_delta_based) {
+        // No delta means nothing moved in that generation
+        frame = snap->stream_delta;
+        size = snap->stream_delta_size;
+    }
+    sub->generation = snap->generation;
+
+    if (!frame) {
+        snapshot_release(snap);
+        return 0;
+    }
+
+    sub->pending = snap;
+    sub->frame = frame;
+    sub->frame_size = size;
+    sub->offset = 0;
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// MHD content reader: copy out the current frame, or park the connection
+// ---------------------------------------------------------------------------
+static ssize_t stream_reader(void *cls, uint64_t pos, char *buf, size_t max) {
+    Subscriber *sub = cls;
+    (void)pos;
+
+    for (;;) {
+        if (sub->frame) {
+            size_t n = sub->frame_size - sub->offset;
+            if (n > max) n = max;
+            memcpy(buf, sub->frame + sub->offset, n);
+            sub->offset += n;
+
+            if (sub->offset == sub->frame_size) {
+                snapshot_release(sub->pending);
+                sub->pending = NULL;
+                sub->frame = NULL;
+            }
+            return (ssize_t)n;
+        }
+
+        if (__atomic_load_n(&stream_closing, __ATOMIC_ACQUIRE))
+            return MHD_CONTENT_READER_END_OF_STREAM;
+
+        if (next_frame(sub)) continue;
+
+        // Nothing new: suspend unless a publish slipped in meanwhile.
+        // stream_notify() takes the same lock, so no wake-up is lost.
+        pthread_mutex_lock(&subscribers_lock);
+        if (notified_generation > sub->generation || stream_closing) {
+            pthread_mutex_unlock(&subscribers_lock);
+            continue;
+        }
+        sub->suspended = 1;
+        MHD_suspend_connection(sub->connection);
+        pthread_mutex_unlock(&subscribers_lock);
+        return 0;
+    }
+}
+
+static void stream_free(void *cls) {
+    Subscriber *sub = cls;
+
+    pthread_mutex_lock(&subscribers_lock);
+    if (sub->prev) sub->prev->next = sub->next;
+    else subscribers = sub->next;
+    if (sub->next) sub->next->prev = sub->prev;
+    __atomic_sub_fetch(&subscriber_count, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&subscribers_lock);
+
+    snapshot_release(sub->pending);
+    free(sub);
+}
+
+// ---------------------------------------------------------------------------
+// Public entry points
+// ---------------------------------------------------------------------------
+enum MHD_Result stream_subscribe(struct MHD_Connection *connection) {
+    Subscriber *sub = calloc(1, sizeof(Subscriber));
+    if (!sub) return MHD_NO;
+
+    sub->connection = connection;
+    sub->frame = STREAM_PREAMBLE;
+    sub->frame_size = strlen(STREAM_PREAMBLE);
+
+    // A reconnecting EventSource resumes from its last event id when that
+    // generation is still current or one behind
+    const char *last_id = MHD_lookup_connection_value(connection, MHD_HEADER_KIND, "Last-Event-ID");
+    if (last_id) {
+        unsigned long id = strtoul(last_id, NULL, 10);
+        Snapshot *snap = snapshot_acquire();
+        if (snap && id <= snap->generation && id + 1 >= snap->generation)
+            sub->generation = id;
+        snapshot_release(snap);
+    }
+
+    struct MHD_Response *response = MHD_create_response_from_callback(
+        MHD_SIZE_UNKNOWN, STREAM_BLOCK_SIZE, &stream_reader, sub, &stream_free);
+    if (!response) {
+        free(sub);
+        return MHD_NO;
+    }
+
+    pthread_mutex_lock(&subscribers_lock);
+    sub->next = subscribers;
+    if (subscribers) subscribers->prev = sub;
+    subscribers = sub;
+    __atomic_add_fetch(&subscriber_count, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&subscribers_lock);
+
+    MHD_add_response_header(response, "Content-Type", "text/event-stream");
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CACHE_CONTROL, "no-cache");
+    MHD_add_response_header(response, "X-Accel-Buffering", "no");
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+
+    int ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+void stream_notify(const Snapshot *snap) {
+    pthread_mutex_lock(&subscribers_lock);
+    notified_generation = snap->generation;
+    for (Subscriber *sub = subscribers; sub; sub = sub->next) {
+        if (sub->suspended) {
+            sub->suspended = 0;
+            MHD_resume_connection(sub->connection);
+        }
+    }
+    pthread_mutex_unlock(&subscribers_lock);
+}
+
+void stream_shutdown(void) {
+    pthread_mutex_lock(&subscribers_lock);
+    __atomic_store_n(&stream_closing, 1, __ATOMIC_RELEASE);
+    for (Subscriber *sub = subscribers; sub; sub = sub->next) {
+        if (sub->suspended) {
+            sub->suspended = 0;
+            MHD_resume_connection(sub->connection);
+        }
+    }
+    pthread_mutex_unlock(&subscribers_lock);
+}
+
+int stream_subscriber_count(void) {
+    return __atomic_load_n(&subscriber_count, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,180 @@
+/*
+ * Smart Stock Tracker - Fused Market Summary
+ * One walk over the quotes gathers every market-wide number the analyzer,
+ * the console and the JSON documents need: counts, sums, extrema with
+ * their rows, sentiment buckets and the top movers. Extra metrics plug in
+ * as callbacks and are fed from the same loop.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+static SummaryMetric metrics[SUMMARY_MAX_METRICS];
+static int metric_count = 0;
+
+int market_summary_register(const SummaryMetric* metric) {
+    if (!metric || !metric->name || !metric->add || metric_count >= SUMMARY_MAX_METRICS)
+        return 0;
+    metrics[metric_count++] = *metric;
+    return 1;
+}
+
+// Keep top[] ordered by change, largest first; equal changes keep row order
+static void insert_top(MarketSummary* summary, const Stock stocks[], int index) {
+    double change = stocks[index].change_percent;
+    int pos = summary->top_count;
+    if (pos == SUMMARY_TOP_K) {
+        if (change <= stocks[summary->top[pos - 1]].change_percent) return;
+        pos--;
+    } else {
+        summary->top_count++;
+    }
+    while (pos > 0 && stocks[summary->top[pos - 1]].change_percent < change) {
+        summary->top[pos] = summary->top[pos - 1];
+        pos--;
+    }
+    summary->top[pos] = index;
+}
+
+// Count rows [begin, end) into a freshly initialized `summary`
+static void scan_rows(const Stock stocks[], int begin, int end, MarketSummary* summary,
+                      int feed_metrics) {
+    // Same starting floors as the single-purpose analyzer functions
+    double best_change = -1000.0, worst_change = 1000.0;
+    double highest_move = 0.0, highest_volume = 0.0;
+
+    for (int i = begin; i < end; i++) {
+        const Stock* stock = &stocks[i];
+        if (stock->current_price <= 0) continue;
+
+        double change = stock->change_percent;
+        summary->valid++;
+        summary->positive += change > 0;
+        if (change > SENTIMENT_THRESHOLD) summary->bullish++;
+        else if (change < -SENTIMENT_THRESHOLD) summary->bearish++;
+        else summary->neutral++;
+
+        summary->change_sum += change;
+        summary->price_sum += stock->current_price;
+        summary->volume_sum += stock->volume;
+
+        if (change > best_change) {
+            best_change = change;
+            summary->best = i;
+        }
+        if (change < worst_change) {
+            worst_change = change;
+            summary->worst = i;
+        }
+        if (fabs(change) > highest_move) {
+            highest_move = fabs(change);
+            summary->most_volatile = i;
+        }
+        if (stock->volume > highest_volume) {
+            highest_volume = stock->volume;
+            summary->highest_volume = i;
+        }
+        insert_top(summary, stocks, i);
+
+        for (int m = 0; feed_metrics && m < metric_count; m++)
+            metrics[m].add(metrics[m].ctx, stock, i);
+    }
+}
+
+static void begin_metrics(void) {
+    for (int m = 0; m < metric_count; m++)
+        if (metrics[m].begin) metrics[m].begin(metrics[m].ctx);
+}
+
+// Averages, sentiment and metric values once every row has been counted
+static void finish_summary(MarketSummary* summary) {
+    summary->average_change = summary->valid > 0 ? summary->change_sum / summary->valid : 0.0;
+    if (summary->count == 0) summary->sentiment = "UNKNOWN";
+    else if (summary->bullish > summary->bearish && summary->bullish > summary->neutral)
+        summary->sentiment = "🟢 BULLISH MARKET";
+    else if (summary->bearish > summary->bullish && summary->bearish > summary->neutral)
+        summary->sentiment = "🔴 BEARISH MARKET";
+    else summary->sentiment = "🟡 NEUTRAL MARKET";
+
+    summary->metric_count = metric_count;
+    for (int m = 0; m < metric_count; m++) {
+        summary->metric_names[m] = metrics[m].name;
+        summary->metric_values[m] = metrics[m].finish ? metrics[m].finish(metrics[m].ctx) : NAN;
+    }
+}
+
+static void init_summary(MarketSummary* summary, int count) {
+    memset(summary, 0, sizeof(*summary));
+    summary->count = count > 0 ? count : 0;
+    summary->best = summary->worst = summary->most_volatile = summary->highest_volume = -1;
+}
+
+void market_summary_compute(const Stock stocks[], int count, MarketSummary* summary) {
+    init_summary(summary, count);
+    begin_metrics();
+    scan_rows(stocks, 0, summary->count, summary, 1);
+    finish_summary(summary);
+}
+
+// ============================================================================
+// Split passes: partial summaries of row ranges, merged in range order
+// ============================================================================
+void market_summary_partial(const Stock stocks[], int begin, int end, MarketSummary* partial) {
+    init_summary(partial, 0);
+    if (begin < end) scan_rows(stocks, begin, end, partial, 0);
+}
+
+// Pick whichever row wins; on a tie the earlier range (`current`) keeps it
+static int pick_row(const Stock stocks[], int current, int candidate, int larger, int by_magnitude,
+                    int by_volume) {
+    if (candidate < 0) return current;
+    if (current < 0) return candidate;
+    double a = by_volume ? stocks[current].volume : stocks[current].change_percent;
+    double b = by_volume ? stocks[candidate].volume : stocks[candidate].change_percent;
+    if (by_magnitude) {
+        a = fabs(a);
+        b = fabs(b);
+    }
+    return (larger ? b > a : b < a) ? candidate : current;
+}
+
+void market_summary_merge(MarketSummary* into, const MarketSummary* partial, const Stock stocks[]) {
+    into->valid += partial->valid;
+    into->positive += partial->positive;
+    into->bullish += partial->bullish;
+    into->bearish += partial->bearish;
+    into->neutral += partial->neutral;
+    into->change_sum += partial->change_sum;
+    into->price_sum += partial->price_sum;
+    into->volume_sum += partial->volume_sum;
+
+    into->best = pick_row(stocks, into->best, partial->best, 1, 0, 0);
+    into->worst = pick_row(stocks, into->worst, partial->worst, 0, 0, 0);
+    into->most_volatile = pick_row(stocks, into->most_volatile, partial->most_volatile, 1, 1, 0);
+    into->highest_volume = pick_row(stocks, into->highest_volume, partial->highest_volume, 1, 0, 1);
+
+    // Later rows go behind equal changes, as insert_top would place them
+    for (int i = 0; i < partial->top_count; i++)
+        insert_top(into, stocks, partial->top[i]);
+}
+
+void market_summary_finish(const Stock stocks[], int count, MarketSummary* summary) {
+    summary->count = count > 0 ? count : 0;
+    // Metrics are stateful callbacks, so they get their own ordered pass
+    if (metric_count > 0) {
+        begin_metrics();
+        for (int i = 0; i < summary->count; i++) {
+            if (stocks[i].current_price <= 0) continue;
+            for (int m = 0; m < metric_count; m++)
+                metrics[m].add(metrics[m].ctx, &stocks[i], i);
+        }
+    }
+    finish_summary(summary);
+}
+
+double market_summary_metric(const MarketSummary* summary, const char* name) {
+    for (int m = 0; name && m < summary->metric_count; m++) {
+        if (strcmp(summary->metric_names[m], name) == 0) return summary->metric_values[m];
+    }
+    return NAN;
+}
@@ -0,0 +1,763 @@
+/*
+ * Smart Stock Tracker - Tick History Store
+ * Per-symbol, append-only columnar segments in memory-mapped files:
+ *
+ *   <dir>/<SYMBOL>/<seq>.seg
+ *     header   TickSegmentHeader (64 bytes)
+ *     ts       int64_t[capacity]   unix seconds
+ *     price    double[capacity]
+ *     high     double[capacity]
+ *     low      double[capacity]
+ *     volume   double[capacity]
+ *
+ * Rows are written into the mapping and published by bumping the header's
+ * row count last, so a crash mid-append loses at most that row. Startup maps
+ * the existing segments instead of parsing anything.
+ *
+ * Readers (/history) never lock: the symbol index and each series' segment
+ * list are immutable copies published through atomic pointers, replaced
+ * ones are retired through epochs, and a segment is unmapped only once no
+ * published list refers to it. Appends, opening and maintenance are
+ * serialized by store_lock among themselves.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TICK_MAGIC "TICKSEG1"
+#define TICK_VERSION 1
+#define TICK_COLUMNS 5
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity;      // rows the file has room for
+    uint64_t count;         // committed rows; stored after the row itself
+    int64_t first_ts;
+    int64_t last_ts;
+    uint32_t resolution;    // seconds per row, 0 for raw ticks
+    uint32_t reserved;
+    char symbol[16];
+} TickSegmentHeader;
+
+typedef struct {
+    TickSegmentHeader *header;   // start of the mapping
+    size_t map_size;
+    int64_t *ts;
+    double *price, *high, *low, *volume;
+    unsigned int seq;
+} TickSegment;
+
+// What readers see of a series: an immutable copy of its segment list
+typedef struct {
+    int count;
+    TickSegment segments[];
+} SegmentView;
+
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    SegmentView *view;           // published copy of segments[], NULL if empty
+    TickSegment *segments;       // writer's list, ordered by time; the last one takes appends
+    int count;
+    int capacity;
+    unsigned int next_seq;
+} TickSeries;
+
+// Symbol -> series; linear probing, at most half full. Slots are only ever
+// filled, so readers probe the published table as it is; growing builds a
+// new table and retires the old one.
+typedef struct {
+    size_t size;                 // power of two
+    TickSeries *entries[];
+} SeriesIndex;
+
+// A mapping taken out of a series; unmapped once readers have moved on
+typedef struct DetachedMapping {
+    void *addr;
+    size_t size;
+    struct DetachedMapping *next;
+} DetachedMapping;
+
+static TickStoreConfig store_config;
+static TickSeries **series = NULL;           // writer's list of every series
+static int series_count = 0;
+static int series_capacity = 0;
+static SeriesIndex *series_index = NULL;     // published; NULL while closed
+static DetachedMapping *detached = NULL;     // waiting for the next publish
+static int store_open = 0;
+
+// Writers only: appends, opening, closing and maintenance
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+void tickstore_config_defaults(TickStoreConfig *config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = 1;
+    snprintf(config->dir, sizeof(config->dir), "%s", TICK_HISTORY_DIR);
+    config->segment_rows = TICK_SEGMENT_ROWS;
+    config->retention_days = TICK_RETENTION_DAYS;
+    config->compact_after_hours = TICK_COMPACT_AFTER_HOURS;
+    config->compact_bucket_seconds = TICK_COMPACT_BUCKET_SECONDS;
+}
+
+int tickstore_config_set(const char *key, const char *value, void *ctx) {
+    TickStoreConfig *config = ctx;
+
+    if (strcmp(key, "tick_history") == 0)
+        return config_parse_uint(value, 1, &config->enabled);
+    if (strcmp(key, "tick_dir") == 0) {
+        if (*value == '\0' || strlen(value) >= sizeof(config->dir)) return 0;
+        snprintf(config->dir, sizeof(config->dir), "%s", value);
+        return 1;
+    }
+    if (strcmp(key, "tick_segment_rows") == 0)
+        return config_parse_uint(value, 1u << 24, &config->segment_rows) && config->segment_rows > 0;
+    if (strcmp(key, "tick_retention_days") == 0)
+        return config_parse_uint(value, 36500, &config->retention_days);
+    if (strcmp(key, "tick_compact_after_hours") == 0)
+        return config_parse_uint(value, 876000, &config->compact_after_hours);
+    if (strcmp(key, "tick_compact_bucket") == 0)
+        return config_parse_uint(value, 86400, &config->compact_bucket_seconds);
+    return 0;
+}
+
+// ============================================================================
+// Segment files
+// ============================================================================
+static size_t segment_file_size(uint32_t capacity) {
+    return sizeof(TickSegmentHeader) + (size_t)capacity * TICK_COLUMNS * sizeof(double);
+}
+
+static void segment_bind_columns(TickSegment *seg) {
+    uint32_t capacity = seg->header->capacity;
+    char *base = (char *)seg->header + sizeof(TickSegmentHeader);
+    seg->ts = (int64_t *)base;
+    seg->price = (double *)(base + (size_t)capacity * 8);
+    seg->high = (double *)(base + (size_t)capacity * 16);
+    seg->low = (double *)(base + (size_t)capacity * 24);
+    seg->volume = (double *)(base + (size_t)capacity * 32);
+}
+
+// Returns 0 if the path does not fit
+static int segment_path(char *out, size_t size, const char *symbol, unsigned int seq, const char *suffix) {
+    return snprintf(out, size, "%s/%s/%08u.seg%s", store_config.dir, symbol, seq, suffix) < (int)size;
+}
+
+static void unmap_detached(void *object) {
+    DetachedMapping *mapping = object;
+    munmap(mapping->addr, mapping->size);
+    free(mapping);
+}
+
+// Queue a segment's mapping for unmapping; readers may still be scanning it
+static void segment_detach(TickSegment *seg) {
+    if (!seg->header) return;
+    DetachedMapping *mapping = malloc(sizeof(DetachedMapping));
+    if (!mapping) {
+        display_error("Out of memory retiring a tick segment; leaking its mapping");
+        seg->header = NULL;
+        return;
+    }
+    mapping->addr = seg->header;
+    mapping->size = seg->map_size;
+    mapping->next = detached;
+    detached = mapping;
+    seg->header = NULL;
+}
+
+// Retire everything detached; only once no published view refers to it
+static void retire_detached(void) {
+    while (detached) {
+        DetachedMapping *mapping = detached;
+        detached = mapping->next;
+        epoch_retire(mapping, unmap_detached);
+    }
+}
+
+static int segment_map(TickSegment *seg, const char *path) {
+    int fd = open(path, O_RDWR);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TickSegmentHeader)) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    TickSegmentHeader *header = map;
+    if (memcmp(header->magic, TICK_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TICK_VERSION || header->count > header->capacity ||
+        segment_file_size(header->capacity) != (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        return 0;
+    }
+
+    seg->header = header;
+    seg->map_size = (size_t)st.st_size;
+    segment_bind_columns(seg);
+    return 1;
+}
+
+// Create and map an empty segment at `path`
+static int segment_create(TickSegment *seg, const char *path, const char *symbol,
+                          uint32_t capacity, uint32_t resolution) {
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) return 0;
+
+    size_t size = segment_file_size(capacity);
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        unlink(path);
+        return 0;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        unlink(path);
+        return 0;
+    }
+
+    TickSegmentHeader *header = map;
+    memcpy(header->magic, TICK_MAGIC, sizeof(header->magic));
+    header->version = TICK_VERSION;
+    header->capacity = capacity;
+    header->resolution = resolution;
+    snprintf(header->symbol, sizeof(header->symbol), "%s", symbol);
+
+    seg->header = header;
+    seg->map_size = size;
+    segment_bind_columns(seg);
+    return 1;
+}
+
+// ============================================================================
+// Series index
+// ============================================================================
+// FNV-1a over the symbol text
+static size_t hash_symbol(const char *symbol) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *symbol; symbol++) hash = (hash ^ (unsigned char)*symbol) * 1099511628211ULL;
+    return (size_t)(hash ^ hash >> 32);
+}
+
+static size_t index_probe(const SeriesIndex *table, const char *symbol) {
+    size_t mask = table->size - 1;
+    size_t pos = hash_symbol(symbol) & mask;
+    const TickSeries *entry;
+    while ((entry = __atomic_load_n(&table->entries[pos], __ATOMIC_ACQUIRE)) &&
+           strcmp(entry->symbol, symbol) != 0)
+        pos = (pos + 1) & mask;
+    return pos;
+}
+
+static int index_grow(void) {
+    size_t size = series_index ? series_index->size * 2 : 64;
+    SeriesIndex *grown = calloc(1, sizeof(SeriesIndex) + size * sizeof(TickSeries *));
+    if (!grown) return 0;
+    grown->size = size;
+
+    for (int i = 0; i < series_count; i++) grown->entries[index_probe(grown, series[i]->symbol)] = series[i];
+    SeriesIndex *old = __atomic_exchange_n(&series_index, grown, __ATOMIC_ACQ_REL);
+    epoch_retire(old, free);
+    return 1;
+}
+
+// Writers, or readers inside an epoch
+static TickSeries *find_series(const char *symbol) {
+    const SeriesIndex *table = __atomic_load_n(&series_index, __ATOMIC_ACQUIRE);
+    return table ? __atomic_load_n(&table->entries[index_probe(table, symbol)], __ATOMIC_ACQUIRE) : NULL;
+}
+
+static TickSeries *add_series(const char *symbol) {
+    if ((!series_index || (size_t)(series_count + 1) * 2 > series_index->size) && !index_grow())
+        return NULL;
+    if (series_count == series_capacity) {
+        int capacity = series_capacity ? series_capacity * 2 : 16;
+        TickSeries **grown = realloc(series, capacity * sizeof(TickSeries *));
+        if (!grown) return NULL;
+        series = grown;
+        series_capacity = capacity;
+    }
+
+    TickSeries *s = calloc(1, sizeof(TickSeries));
+    if (!s) return NULL;
+    snprintf(s->symbol, sizeof(s->symbol), "%s", symbol);
+    series[series_count++] = s;
+    __atomic_store_n(&series_index->entries[index_probe(series_index, s->symbol)], s, __ATOMIC_RELEASE);
+    return s;
+}
+
+// Publish the writer's segment list, then let go of the mappings it no
+// longer holds. Without memory for the copy readers see an empty series
+// rather than one that may point at unmapped segments.
+static void publish_segments(TickSeries *s) {
+    SegmentView *view = NULL;
+    if (s->count > 0) {
+        view = malloc(sizeof(SegmentView) + (size_t)s->count * sizeof(TickSegment));
+        if (view) {
+            view->count = s->count;
+            memcpy(view->segments, s->segments, (size_t)s->count * sizeof(TickSegment));
+        }
+    }
+    SegmentView *old = __atomic_exchange_n(&s->view, view, __ATOMIC_ACQ_REL);
+    epoch_retire(old, free);
+    retire_detached();
+}
+
+static int add_segment(TickSeries *s, const TickSegment *seg) {
+    if (s->count == s->capacity) {
+        int capacity = s->capacity ? s->capacity * 2 : 8;
+        TickSegment *grown = realloc(s->segments, capacity * sizeof(TickSegment));
+        if (!grown) return 0;
+        s->segments = grown;
+        s->capacity = capacity;
+    }
+    s->segments[s->count++] = *seg;
+    if (seg->seq >= s->next_seq) s->next_seq = seg->seq + 1;
+    return 1;
+}
+
+static void remove_segment(TickSeries *s, int index, int delete_file) {
+    TickSegment *seg = &s->segments[index];
+    char path[MAX_PATH_LENGTH];
+    int have_path = segment_path(path, sizeof(path), s->symbol, seg->seq, "");
+
+    segment_detach(seg);
+    if (delete_file && have_path) unlink(path);
+
+    memmove(&s->segments[index], &s->segments[index + 1],
+            (size_t)(s->count - index - 1) * sizeof(TickSegment));
+    s->count--;
+}
+
+static int compare_segments(const void *a, const void *b) {
+    const TickSegment *x = a, *y = b;
+    if (x->header->first_ts != y->header->first_ts)
+        return x->header->first_ts < y->header->first_ts ? -1 : 1;
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+// Order segments by time and drop raw segments that a compacted one already
+// covers (left behind if a compaction was interrupted before its unlinks)
+static void normalize_series(TickSeries *s) {
+    qsort(s->segments, s->count, sizeof(TickSegment), compare_segments);
+    for (int i = s->count - 2; i >= 0; i--) {
+        if (s->segments[i].header->count == 0) remove_segment(s, i, 1);
+    }
+
+    for (int c = 0; c < s->count; c++) {
+        const TickSegmentHeader *compacted = s->segments[c].header;
+        if (compacted->resolution == 0 || compacted->count == 0) continue;
+        for (int i = s->count - 1; i >= 0; i--) {
+            const TickSegmentHeader *raw = s->segments[i].header;
+            if (i != c && raw->resolution == 0 && raw->count > 0 &&
+                raw->first_ts >= compacted->first_ts && raw->last_ts <= compacted->last_ts) {
+                remove_segment(s, i, 1);
+                if (i < c) c--;
+            }
+        }
+    }
+}
+
+static int make_dirs(const char *path) {
+    char buf[MAX_PATH_LENGTH];
+    if (snprintf(buf, sizeof(buf), "%s", path) >= (int)sizeof(buf)) return 0;
+    for (char *p = buf + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(buf, 0755) != 0 && errno != EEXIST) return 0;
+        *p = '/';
+    }
+    return mkdir(buf, 0755) == 0 || errno == EEXIST;
+}
+
+static void load_series(const char *symbol) {
+    char dir_path[MAX_PATH_LENGTH];
+    if (snprintf(dir_path, sizeof(dir_path), "%s/%s", store_config.dir, symbol) >= (int)sizeof(dir_path))
+        return;
+
+    DIR *dir = opendir(dir_path);
+    if (!dir) return;
+
+    TickSeries *s = NULL;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        unsigned int seq;
+        char tail[8];
+        char path[MAX_PATH_LENGTH];
+        if (snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name) >= (int)sizeof(path))
+            continue;
+
+        if (sscanf(entry->d_name, "%u.seg%7s", &seq, tail) == 2) {
+            unlink(path);  // unfinished compaction output
+            continue;
+        }
+        if (sscanf(entry->d_name, "%u.seg", &seq) != 1) continue;
+
+        TickSegment seg = { .seq = seq };
+        if (!segment_map(&seg, path)) {
+            fprintf(stderr, "⚠️  Skipping unreadable tick segment %s\n", path);
+            continue;
+        }
+        if (!s) s = add_series(symbol);
+        if (!s || !add_segment(s, &seg)) {
+            munmap(seg.header, seg.map_size);
+            break;
+        }
+    }
+    closedir(dir);
+
+    if (s) {
+        normalize_series(s);
+        publish_segments(s);
+    }
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+int tickstore_open(const TickStoreConfig *config) {
+    if (!config || !config->enabled) return 0;
+
+    pthread_mutex_lock(&store_lock);
+    store_config = *config;
+    if (store_config.segment_rows == 0) store_config.segment_rows = TICK_SEGMENT_ROWS;
+
+    if (!make_dirs(store_config.dir)) {
+        pthread_mutex_unlock(&store_lock);
+        display_error("Failed to create the tick history directory.");
+        return 0;
+    }
+
+    DIR *dir = opendir(store_config.dir);
+    if (dir) {
+        struct dirent *entry;
+        while ((entry = readdir(dir))) {
+            char clean[MAX_SYMBOL_LENGTH];
+            if (entry->d_name[0] == '.') continue;
+            if (!validate_stock_symbol(entry->d_name, clean, sizeof(clean)) ||
+                strcmp(clean, entry->d_name) != 0)
+                continue;
+            load_series(entry->d_name);
+        }
+        closedir(dir);
+    }
+
+    store_open = 1;
+    pthread_mutex_unlock(&store_lock);
+    return 1;
+}
+
+void tickstore_close(void) {
+    pthread_mutex_lock(&store_lock);
+    // Unpublish first; readers still inside a scan keep everything they
+    // reached until their epoch ends
+    epoch_retire(__atomic_exchange_n(&series_index, NULL, __ATOMIC_ACQ_REL), free);
+    for (int i = 0; i < series_count; i++) {
+        TickSeries *s = series[i];
+        for (int j = 0; j < s->count; j++) {
+            if (FSYNC_POLICY >= FSYNC_DATA) msync(s->segments[j].header, s->segments[j].map_size, MS_SYNC);
+            segment_detach(&s->segments[j]);
+        }
+        free(s->segments);
+        epoch_retire(s->view, free);
+        epoch_retire(s, free);
+    }
+    retire_detached();
+    free(series);
+    series = NULL;
+    series_count = series_capacity = 0;
+    store_open = 0;
+    pthread_mutex_unlock(&store_lock);
+}
+
+// ============================================================================
+// Append
+// ============================================================================
+static TickSegment *open_segment_for_append(TickSeries *s) {
+    if (s->count > 0) {
+        TickSegment *last = &s->segments[s->count - 1];
+        if (last->header->resolution == 0 && last->header->count < last->header->capacity)
+            return last;
+        // Sealed: let the kernel start writing it back
+        msync(last->header, last->map_size, MS_ASYNC);
+    }
+
+    char dir_path[MAX_PATH_LENGTH], path[MAX_PATH_LENGTH];
+    if (snprintf(dir_path, sizeof(dir_path), "%s/%s", store_config.dir, s->symbol) >= (int)sizeof(dir_path) ||
+        !make_dirs(dir_path))
+        return NULL;
+
+    TickSegment seg = { .seq = s->next_seq };
+    if (!segment_path(path, sizeof(path), s->symbol, seg.seq, "")) return NULL;
+    if (!segment_create(&seg, path, s->symbol, store_config.segment_rows, 0)) return NULL;
+    if (!add_segment(s, &seg)) {
+        munmap(seg.header, seg.map_size);
+        unlink(path);
+        return NULL;
+    }
+    publish_segments(s);
+    return &s->segments[s->count - 1];
+}
+
+static int append_locked(const Stock *stock) {
+    char symbol[MAX_SYMBOL_LENGTH];
+    if (!validate_stock_symbol(stock->symbol, symbol, sizeof(symbol))) return 0;
+
+    int64_t ts = (int64_t)(stock->last_update ? stock->last_update : time(NULL));
+
+    TickSeries *s = find_series(symbol);
+    if (!s) s = add_series(symbol);
+    if (!s) return 0;
+
+    // Append-only: a tick older than the newest stored one is dropped
+    if (s->count > 0) {
+        const TickSegmentHeader *last = s->segments[s->count - 1].header;
+        if (last->count > 0 && ts < last->last_ts) return 0;
+    }
+
+    TickSegment *seg = open_segment_for_append(s);
+    if (!seg) return 0;
+
+    TickSegmentHeader *header = seg->header;
+    uint64_t row = header->count;
+    seg->ts[row] = ts;
+    seg->price[row] = stock->current_price;
+    seg->high[row] = stock->day_high;
+    seg->low[row] = stock->day_low;
+    seg->volume[row] = stock->volume;
+
+    // Readers load count first; the release orders the row and the bounds
+    if (row == 0) __atomic_store_n(&header->first_ts, ts, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->last_ts, ts, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->count, row + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+int tickstore_append(const Stock *stock) {
+    if (!stock || stock->current_price <= 0) return 0;
+
+    pthread_mutex_lock(&store_lock);
+    int ok = store_open && append_locked(stock);
+    pthread_mutex_unlock(&store_lock);
+    return ok;
+}
+
+int tickstore_append_since(const Stock stocks[], int count, time_t since) {
+    int appended = 0;
+
+    pthread_mutex_lock(&store_lock);
+    for (int i = 0; store_open && i < count; i++) {
+        if (stocks[i].current_price > 0 && stocks[i].last_update >= since)
+            appended += append_locked(&stocks[i]);
+    }
+    pthread_mutex_unlock(&store_lock);
+    return appended;
+}
+
+// ============================================================================
+// Range scans
+// ============================================================================
+// First row with ts >= key
+static uint64_t lower_bound(const int64_t *ts, uint64_t count, int64_t key) {
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (ts[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+size_t tickstore_scan(const char *symbol, time_t from, time_t to, TickScanFn visit, void *ctx) {
+    if (!symbol || !visit) return 0;
+
+    size_t rows = 0;
+    epoch_enter();
+
+    const TickSeries *s = find_series(symbol);
+    const SegmentView *view = s ? __atomic_load_n(&s->view, __ATOMIC_ACQUIRE) : NULL;
+    for (int i = 0; view && i < view->count; i++) {
+        const TickSegment *seg = &view->segments[i];
+        uint64_t count = __atomic_load_n(&seg->header->count, __ATOMIC_ACQUIRE);
+        if (count == 0 || __atomic_load_n(&seg->header->last_ts, __ATOMIC_RELAXED) < from) continue;
+        if (__atomic_load_n(&seg->header->first_ts, __ATOMIC_RELAXED) > to) break;
+
+        uint64_t begin = lower_bound(seg->ts, count, (int64_t)from);
+        uint64_t end = lower_bound(seg->ts, count, (int64_t)to + 1);
+        if (begin >= end) continue;
+
+        // Hand out slices of the mapped columns, no copying
+        TickColumns run = {
+            .ts = seg->ts + begin,
+            .price = seg->price + begin,
+            .high = seg->high + begin,
+            .low = seg->low + begin,
+            .volume = seg->volume + begin,
+            .count = (size_t)(end - begin),
+            .resolution = seg->header->resolution,
+        };
+        visit(&run, ctx);
+        rows += run.count;
+    }
+
+    epoch_exit();
+    return rows;
+}
+
+int tickstore_recent_prices(const char *symbol, double prices[], int max) {
+    if (!symbol || !prices || max <= 0) return 0;
+
+    int filled = 0;
+    epoch_enter();
+
+    // Walk segments newest-first, then place the rows oldest-first
+    const TickSeries *s = find_series(symbol);
+    const SegmentView *view = s ? __atomic_load_n(&s->view, __ATOMIC_ACQUIRE) : NULL;
+    for (int i = view ? view->count - 1 : -1; i >= 0 && filled < max; i--) {
+        const TickSegment *seg = &view->segments[i];
+        uint64_t count = __atomic_load_n(&seg->header->count, __ATOMIC_ACQUIRE);
+        uint64_t take = count < (uint64_t)(max - filled) ? count : (uint64_t)(max - filled);
+        memcpy(prices + (max - filled - take), seg->price + (count - take), take * sizeof(double));
+        filled += (int)take;
+    }
+
+    epoch_exit();
+
+    if (filled < max) memmove(prices, prices + (max - filled), filled * sizeof(double));
+    return filled;
+}
+
+// ============================================================================
+// Retention and compaction
+// ============================================================================
+// Downsample a run of sealed raw segments into one segment with one row per
+// bucket: last price and volume, highest high, lowest low
+static int compact_run(TickSeries *s, int first, int last) {
+    int64_t bucket = store_config.compact_bucket_seconds;
+
+    uint64_t buckets = 0;
+    int64_t current = INT64_MIN;
+    for (int i = first; i <= last; i++) {
+        const TickSegment *seg = &s->segments[i];
+        for (uint64_t r = 0; r < seg->header->count; r++) {
+            int64_t b = seg->ts[r] - seg->ts[r] % bucket;
+            if (b != current) {
+                buckets++;
+                current = b;
+            }
+        }
+    }
+    if (buckets == 0 || buckets > UINT32_MAX) return 0;
+
+    char temp_path[MAX_PATH_LENGTH], path[MAX_PATH_LENGTH];
+    TickSegment out = { .seq = s->next_seq };
+    if (!segment_path(temp_path, sizeof(temp_path), s->symbol, out.seq, ".tmp") ||
+        !segment_path(path, sizeof(path), s->symbol, out.seq, ""))
+        return 0;
+    unlink(temp_path);
+    if (!segment_create(&out, temp_path, s->symbol, (uint32_t)buckets, (uint32_t)bucket))
+        return 0;
+
+    int64_t row = -1;
+    current = INT64_MIN;
+    for (int i = first; i <= last; i++) {
+        const TickSegment *seg = &s->segments[i];
+        for (uint64_t r = 0; r < seg->header->count; r++) {
+            int64_t b = seg->ts[r] - seg->ts[r] % bucket;
+            if (b != current) {
+                current = b;
+                row++;
+                out.high[row] = seg->high[r];
+                out.low[row] = seg->low[r];
+            }
+            out.ts[row] = seg->ts[r];
+            out.price[row] = seg->price[r];
+            out.volume[row] = seg->volume[r];
+            if (seg->high[r] > out.high[row]) out.high[row] = seg->high[r];
+            if (seg->low[r] < out.low[row]) out.low[row] = seg->low[r];
+        }
+    }
+    out.header->first_ts = out.ts[0];
+    out.header->last_ts = out.ts[buckets - 1];
+    out.header->count = buckets;
+
+    // The compacted file becomes visible only once complete; the raw
+    // segments it replaces go afterwards (a crash in between is cleaned up
+    // by normalize_series on the next open)
+    if (FSYNC_POLICY >= FSYNC_DATA) msync(out.header, out.map_size, MS_SYNC);
+    if (rename(temp_path, path) != 0) {
+        munmap(out.header, out.map_size);
+        unlink(temp_path);
+        return 0;
+    }
+
+    for (int i = last; i >= first; i--)
+        remove_segment(s, i, 1);
+    if (!add_segment(s, &out)) {
+        munmap(out.header, out.map_size);
+        return 0;
+    }
+    qsort(s->segments, s->count, sizeof(TickSegment), compare_segments);
+    return 1;
+}
+
+int tickstore_maintain(time_t now) {
+    int changed = 0;
+
+    pthread_mutex_lock(&store_lock);
+    for (int k = 0; store_open && k < series_count; k++) {
+        TickSeries *s = series[k];
+        int before = changed;
+
+        // Retention: whole sealed segments past the horizon go
+        if (store_config.retention_days > 0) {
+            int64_t horizon = (int64_t)now - (int64_t)store_config.retention_days * 86400;
+            for (int i = s->count - 2; i >= 0; i--) {
+                if (s->segments[i].header->last_ts < horizon) {
+                    remove_segment(s, i, 1);
+                    changed++;
+                }
+            }
+        }
+
+        // Compaction: merge consecutive sealed raw segments that are old enough
+        if (store_config.compact_after_hours > 0 && store_config.compact_bucket_seconds > 0) {
+            int64_t cutoff = (int64_t)now - (int64_t)store_config.compact_after_hours * 3600;
+            int i = 0;
+            while (i < s->count - 1) {
+                if (s->segments[i].header->resolution != 0 || s->segments[i].header->last_ts >= cutoff) {
+                    i++;
+                    continue;
+                }
+                int j = i;
+                while (j + 1 < s->count - 1 && s->segments[j + 1].header->resolution == 0 &&
+                       s->segments[j + 1].header->last_ts < cutoff)
+                    j++;
+                if (compact_run(s, i, j)) changed++;
+                i++;
+            }
+        }
+
+        // Also when a failed compaction already dropped segments
+        if (changed > before || detached) publish_segments(s);
+    }
+    pthread_mutex_unlock(&store_lock);
+    return changed;
+}
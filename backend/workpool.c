@@ -0,0 +1,278 @@
+/*
+ * Smart Stock Tracker - Work-Stealing Pool
+ * Parallel loops over row ranges. Every worker owns a Chase-Lev deque of
+ * chunk ranges: it splits its range in half, pushes the upper half and
+ * keeps going on the lower one until a single chunk is left, and an idle
+ * worker steals the oldest (largest) range from a random victim. Ranges
+ * are packed into one 64-bit word so a push, take or steal moves them
+ * whole.
+ *
+ * The thread that starts the pool is worker 0 and runs its share of every
+ * loop; helpers sleep between loops.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stock_tracker.h"
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define DEQUE_CAPACITY 1024                  // ranges; a loop needs about log2(chunks)
+
+typedef struct {
+    long top;                                // thieves take from here
+    long bottom;                             // the owner pushes and takes here
+    uint64_t ranges[DEQUE_CAPACITY];
+    char pad[64];                            // keep neighbouring deques off this line
+} WorkDeque;
+
+typedef struct {
+    int id;
+    uint32_t seed;                           // victim selection
+    pthread_t thread;
+} Worker;
+
+static WorkDeque *deques = NULL;
+static Worker *workers = NULL;
+static int worker_count = 1;
+static int helpers_started = 0;
+
+// The current loop; written under pool_lock while no helper is inside one
+static WorkRangeFn job_fn = NULL;
+static void *job_ctx = NULL;
+static int job_count = 0;
+static int job_grain = 1;
+static unsigned long job_generation = 0;
+static int chunks_left = 0;                  // loop is done at 0
+static int helpers_inside = 0;               // helpers that joined the current loop
+static int shutting_down = 0;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_ready = PTHREAD_COND_INITIALIZER;
+
+// ============================================================================
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013)
+// ============================================================================
+static uint64_t pack_range(int begin, int end) {
+    return (uint64_t)(uint32_t)begin << 32 | (uint32_t)end;
+}
+
+static void unpack_range(uint64_t range, int *begin, int *end) {
+    *begin = (int)(uint32_t)(range >> 32);
+    *end = (int)(uint32_t)range;
+}
+
+// Owner only; returns 0 when full and the caller keeps the range itself
+static int deque_push(WorkDeque *d, uint64_t range) {
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - t >= DEQUE_CAPACITY) return 0;
+    __atomic_store_n(&d->ranges[b & (DEQUE_CAPACITY - 1)], range, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Owner only: newest range first
+static int deque_take(WorkDeque *d, uint64_t *range) {
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    *range = __atomic_load_n(&d->ranges[b & (DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    if (t < b) return 1;
+
+    // Last range: race the thieves for it
+    int won = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return won;
+}
+
+// Any thread: oldest range first
+static int deque_steal(WorkDeque *d, uint64_t *range) {
+    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return 0;
+
+    *range = __atomic_load_n(&d->ranges[t & (DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    return __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// Loop execution
+// ============================================================================
+static void run_chunk(int chunk) {
+    int begin = chunk * job_grain;
+    int end = begin + job_grain < job_count ? begin + job_grain : job_count;
+    job_fn(job_ctx, begin, end, chunk);
+    __atomic_sub_fetch(&chunks_left, 1, __ATOMIC_ACQ_REL);
+}
+
+// Split off upper halves for thieves until one chunk is left, then run it
+static void run_range(Worker *self, int first, int last) {
+    WorkDeque *own = &deques[self->id];
+    while (last - first > 1) {
+        int mid = first + (last - first) / 2;
+        if (!deque_push(own, pack_range(mid, last))) break;
+        last = mid;
+    }
+    for (int chunk = first; chunk < last; chunk++) run_chunk(chunk);
+}
+
+static int steal_any(Worker *self, uint64_t *range) {
+    self->seed ^= self->seed << 13;
+    self->seed ^= self->seed >> 17;
+    self->seed ^= self->seed << 5;
+    int start = (int)(self->seed % (uint32_t)worker_count);
+    for (int i = 0; i < worker_count; i++) {
+        int victim = (start + i) % worker_count;
+        if (victim != self->id && deque_steal(&deques[victim], range)) return 1;
+    }
+    return 0;
+}
+
+// Work until every chunk of the current loop has run
+static void work_loop(Worker *self) {
+    uint64_t range;
+    int first, last;
+    while (__atomic_load_n(&chunks_left, __ATOMIC_ACQUIRE) > 0) {
+        if (deque_take(&deques[self->id], &range) || steal_any(self, &range)) {
+            unpack_range(range, &first, &last);
+            run_range(self, first, last);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+static void *helper_main(void *arg) {
+    Worker *self = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!shutting_down && (job_generation == seen ||
+                                  __atomic_load_n(&chunks_left, __ATOMIC_ACQUIRE) == 0)) {
+            seen = job_generation;
+            pthread_cond_wait(&job_ready, &pool_lock);
+        }
+        if (shutting_down) break;
+        seen = job_generation;
+        helpers_inside++;
+        pthread_mutex_unlock(&pool_lock);
+
+        work_loop(self);
+
+        pthread_mutex_lock(&pool_lock);
+        helpers_inside--;
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+int workpool_init(unsigned int threads) {
+    workpool_free();
+
+    if (threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (unsigned int)cores : 1;
+    }
+    if (threads > PIPELINE_MAX_THREADS) threads = PIPELINE_MAX_THREADS;
+
+    deques = calloc(threads, sizeof(WorkDeque));
+    workers = calloc(threads, sizeof(Worker));
+    if (!deques || !workers) {
+        free(deques);
+        free(workers);
+        deques = NULL;
+        workers = NULL;
+        return 0;
+    }
+
+    shutting_down = 0;
+    worker_count = 1;
+    workers[0].id = 0;
+    workers[0].seed = 2463534242u;
+    for (unsigned int i = 1; i < threads; i++) {
+        workers[i].id = (int)i;
+        workers[i].seed = 2463534242u + i * 2654435761u;
+        if (pthread_create(&workers[i].thread, NULL, helper_main, &workers[i]) != 0) {
+            display_error("Failed to start a work pool thread; using fewer.");
+            break;
+        }
+        worker_count++;
+    }
+    helpers_started = worker_count - 1;
+    return threads == 1 || helpers_started > 0;
+}
+
+void workpool_free(void) {
+    pthread_mutex_lock(&pool_lock);
+    shutting_down = 1;
+    pthread_cond_broadcast(&job_ready);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int i = 1; i <= helpers_started; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    free(deques);
+    free(workers);
+    deques = NULL;
+    workers = NULL;
+    worker_count = 1;
+    helpers_started = 0;
+}
+
+int workpool_chunks(int count, int grain) {
+    if (count <= 0) return 0;
+    if (grain < 1) grain = 1;
+    return (count + grain - 1) / grain;
+}
+
+int workpool_threads(void) {
+    return worker_count;
+}
+
+void workpool_parallel_for(int count, int grain, WorkRangeFn fn, void *ctx, int inline_only) {
+    int chunks = workpool_chunks(count, grain);
+    if (chunks == 0 || !fn) return;
+    if (grain < 1) grain = 1;
+
+    if (inline_only || worker_count == 1 || chunks == 1 || !deques) {
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            int begin = chunk * grain;
+            fn(ctx, begin, begin + grain < count ? begin + grain : count, chunk);
+        }
+        return;
+    }
+
+    // Helpers still leaving the previous loop must be out before its
+    // fields change
+    pthread_mutex_lock(&pool_lock);
+    while (helpers_inside > 0) {
+        pthread_mutex_unlock(&pool_lock);
+        sched_yield();
+        pthread_mutex_lock(&pool_lock);
+    }
+    job_fn = fn;
+    job_ctx = ctx;
+    job_count = count;
+    job_grain = grain;
+    __atomic_store_n(&chunks_left, chunks, __ATOMIC_RELEASE);
+    job_generation++;
+    pthread_cond_broadcast(&job_ready);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_range(&workers[0], 0, chunks);
+    work_loop(&workers[0]);
+}